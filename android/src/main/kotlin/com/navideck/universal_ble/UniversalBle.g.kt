@@ -1711,11 +1711,15 @@ interface UniversalBlePlatformChannel {
   fun isScanning(): Boolean
   fun connect(deviceId: String, autoConnect: Boolean?, platformConfig: ConnectionPlatformConfig?)
   fun disconnect(deviceId: String)
-  fun setNotifiable(deviceId: String, service: String, characteristic: String, bleInputProperty: BleInputProperty, callback: (Result<Unit>) -> Unit)
-  fun discoverServices(deviceId: String, withDescriptors: Boolean, callback: (Result<List<UniversalBleService>>) -> Unit)
-  fun readValue(deviceId: String, service: String, characteristic: String, callback: (Result<ByteArray>) -> Unit)
+  /**
+   * A positive [timeoutMs] bounds the whole call, including an on-demand
+   * discovery, instead of the native default (Windows only).
+   */
+  fun setNotifiable(deviceId: String, service: String, characteristic: String, bleInputProperty: BleInputProperty, timeoutMs: Long?, callback: (Result<Unit>) -> Unit)
+  fun discoverServices(deviceId: String, withDescriptors: Boolean, timeoutMs: Long?, callback: (Result<List<UniversalBleService>>) -> Unit)
+  fun readValue(deviceId: String, service: String, characteristic: String, timeoutMs: Long?, callback: (Result<ByteArray>) -> Unit)
   fun requestMtu(deviceId: String, expectedMtu: Long, callback: (Result<Long>) -> Unit)
-  fun writeValue(deviceId: String, service: String, characteristic: String, value: ByteArray, bleOutputProperty: BleOutputProperty, callback: (Result<Unit>) -> Unit)
+  fun writeValue(deviceId: String, service: String, characteristic: String, value: ByteArray, bleOutputProperty: BleOutputProperty, timeoutMs: Long?, callback: (Result<Unit>) -> Unit)
   fun isPaired(deviceId: String, callback: (Result<Boolean>) -> Unit)
   fun pair(deviceId: String, callback: (Result<Boolean>) -> Unit)
   fun unPair(deviceId: String)
@@ -1723,7 +1727,12 @@ interface UniversalBlePlatformChannel {
   fun getConnectionState(deviceId: String): BleConnectionState
   fun readRssi(deviceId: String, callback: (Result<Long>) -> Unit)
   fun requestConnectionPriority(deviceId: String, priority: BleConnectionPriority, callback: (Result<Unit>) -> Unit)
-  fun setLogLevel(logLevel: BleLogLevel)
+  /**
+   * With a [category] (`BleLogCategory.index`), only that native area
+   * changes. Categories are Windows only; other platforms ignore such
+   * calls.
+   */
+  fun setLogLevel(logLevel: BleLogLevel, category: Long?)
 
   companion object {
     /** The codec used by UniversalBlePlatformChannel. */
@@ -1921,7 +1930,8 @@ interface UniversalBlePlatformChannel {
             val serviceArg = args[1] as String
             val characteristicArg = args[2] as String
             val bleInputPropertyArg = args[3] as BleInputProperty
-            api.setNotifiable(deviceIdArg, serviceArg, characteristicArg, bleInputPropertyArg) { result: Result<Unit> ->
+            val timeoutMsArg = args[4] as Long?
+            api.setNotifiable(deviceIdArg, serviceArg, characteristicArg, bleInputPropertyArg, timeoutMsArg) { result: Result<Unit> ->
               val error = result.exceptionOrNull()
               if (error != null) {
                 reply.reply(UniversalBlePigeonUtils.wrapError(error))
@@ -1941,7 +1951,8 @@ interface UniversalBlePlatformChannel {
             val args = message as List<Any?>
             val deviceIdArg = args[0] as String
             val withDescriptorsArg = args[1] as Boolean
-            api.discoverServices(deviceIdArg, withDescriptorsArg) { result: Result<List<UniversalBleService>> ->
+            val timeoutMsArg = args[2] as Long?
+            api.discoverServices(deviceIdArg, withDescriptorsArg, timeoutMsArg) { result: Result<List<UniversalBleService>> ->
               val error = result.exceptionOrNull()
               if (error != null) {
                 reply.reply(UniversalBlePigeonUtils.wrapError(error))
@@ -1963,7 +1974,8 @@ interface UniversalBlePlatformChannel {
             val deviceIdArg = args[0] as String
             val serviceArg = args[1] as String
             val characteristicArg = args[2] as String
-            api.readValue(deviceIdArg, serviceArg, characteristicArg) { result: Result<ByteArray> ->
+            val timeoutMsArg = args[3] as Long?
+            api.readValue(deviceIdArg, serviceArg, characteristicArg, timeoutMsArg) { result: Result<ByteArray> ->
               val error = result.exceptionOrNull()
               if (error != null) {
                 reply.reply(UniversalBlePigeonUtils.wrapError(error))
@@ -2008,7 +2020,8 @@ interface UniversalBlePlatformChannel {
             val characteristicArg = args[2] as String
             val valueArg = args[3] as ByteArray
             val bleOutputPropertyArg = args[4] as BleOutputProperty
-            api.writeValue(deviceIdArg, serviceArg, characteristicArg, valueArg, bleOutputPropertyArg) { result: Result<Unit> ->
+            val timeoutMsArg = args[5] as Long?
+            api.writeValue(deviceIdArg, serviceArg, characteristicArg, valueArg, bleOutputPropertyArg, timeoutMsArg) { result: Result<Unit> ->
               val error = result.exceptionOrNull()
               if (error != null) {
                 reply.reply(UniversalBlePigeonUtils.wrapError(error))
@@ -2162,8 +2175,9 @@ interface UniversalBlePlatformChannel {
           channel.setMessageHandler { message, reply ->
             val args = message as List<Any?>
             val logLevelArg = args[0] as BleLogLevel
+            val categoryArg = args[1] as Long?
             val wrapped: List<Any?> = try {
-              api.setLogLevel(logLevelArg)
+              api.setLogLevel(logLevelArg, categoryArg)
               listOf(null)
             } catch (exception: Throwable) {
               UniversalBlePigeonUtils.wrapError(exception)
@@ -331,7 +331,9 @@ class UniversalBlePlugin : UniversalBlePlatformChannel, BluetoothGattCallback(),
         }
     }
 
-    override fun setLogLevel(logLevel: BleLogLevel) {
+    override fun setLogLevel(logLevel: BleLogLevel, category: Long?) {
+        // Log categories are Windows only.
+        if (category != null) return
         UniversalBleLogger.setLogLevel(logLevel)
     }
 
@@ -401,6 +403,7 @@ class UniversalBlePlugin : UniversalBlePlatformChannel, BluetoothGattCallback(),
     override fun discoverServices(
         deviceId: String,
         withDescriptors: Boolean,
+        timeoutMs: Long?,
         callback: (Result<List<UniversalBleService>>) -> Unit,
     ) {
         try {
@@ -477,6 +480,7 @@ class UniversalBlePlugin : UniversalBlePlatformChannel, BluetoothGattCallback(),
         service: String,
         characteristic: String,
         bleInputProperty: BleInputProperty,
+        timeoutMs: Long?,
         callback: (Result<Unit>) -> Unit,
     ) {
         try {
@@ -583,6 +587,7 @@ class UniversalBlePlugin : UniversalBlePlatformChannel, BluetoothGattCallback(),
         deviceId: String,
         service: String,
         characteristic: String,
+        timeoutMs: Long?,
         callback: (Result<ByteArray>) -> Unit,
     ) {
         try {
@@ -675,6 +680,7 @@ class UniversalBlePlugin : UniversalBlePlatformChannel, BluetoothGattCallback(),
         characteristic: String,
         value: ByteArray,
         bleOutputProperty: BleOutputProperty,
+        timeoutMs: Long?,
         callback: (Result<Unit>) -> Unit,
     ) {
         try {
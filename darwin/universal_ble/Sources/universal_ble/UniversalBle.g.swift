@@ -1502,11 +1502,13 @@ protocol UniversalBlePlatformChannel {
   func isScanning() throws -> Bool
   func connect(deviceId: String, autoConnect: Bool?, platformConfig: ConnectionPlatformConfig?) throws
   func disconnect(deviceId: String) throws
-  func setNotifiable(deviceId: String, service: String, characteristic: String, bleInputProperty: BleInputProperty, completion: @escaping (Result<Void, Error>) -> Void)
-  func discoverServices(deviceId: String, withDescriptors: Bool, completion: @escaping (Result<[UniversalBleService], Error>) -> Void)
-  func readValue(deviceId: String, service: String, characteristic: String, completion: @escaping (Result<FlutterStandardTypedData, Error>) -> Void)
+  /// A positive [timeoutMs] bounds the whole call, including an on-demand
+  /// discovery, instead of the native default (Windows only).
+  func setNotifiable(deviceId: String, service: String, characteristic: String, bleInputProperty: BleInputProperty, timeoutMs: Int64?, completion: @escaping (Result<Void, Error>) -> Void)
+  func discoverServices(deviceId: String, withDescriptors: Bool, timeoutMs: Int64?, completion: @escaping (Result<[UniversalBleService], Error>) -> Void)
+  func readValue(deviceId: String, service: String, characteristic: String, timeoutMs: Int64?, completion: @escaping (Result<FlutterStandardTypedData, Error>) -> Void)
   func requestMtu(deviceId: String, expectedMtu: Int64, completion: @escaping (Result<Int64, Error>) -> Void)
-  func writeValue(deviceId: String, service: String, characteristic: String, value: FlutterStandardTypedData, bleOutputProperty: BleOutputProperty, completion: @escaping (Result<Void, Error>) -> Void)
+  func writeValue(deviceId: String, service: String, characteristic: String, value: FlutterStandardTypedData, bleOutputProperty: BleOutputProperty, timeoutMs: Int64?, completion: @escaping (Result<Void, Error>) -> Void)
   func isPaired(deviceId: String, completion: @escaping (Result<Bool, Error>) -> Void)
   func pair(deviceId: String, completion: @escaping (Result<Bool, Error>) -> Void)
   func unPair(deviceId: String) throws
@@ -1514,7 +1516,10 @@ protocol UniversalBlePlatformChannel {
   func getConnectionState(deviceId: String) throws -> BleConnectionState
   func readRssi(deviceId: String, completion: @escaping (Result<Int64, Error>) -> Void)
   func requestConnectionPriority(deviceId: String, priority: BleConnectionPriority, completion: @escaping (Result<Void, Error>) -> Void)
-  func setLogLevel(logLevel: BleLogLevel) throws
+  /// With a [category] (`BleLogCategory.index`), only that native area
+  /// changes. Categories are Windows only; other platforms ignore such
+  /// calls.
+  func setLogLevel(logLevel: BleLogLevel, category: Int64?) throws
 }
 
 /// Generated setup class from Pigeon to handle messages through the `binaryMessenger`.
@@ -1682,7 +1687,8 @@ class UniversalBlePlatformChannelSetup {
         let serviceArg = args[1] as! String
         let characteristicArg = args[2] as! String
         let bleInputPropertyArg = args[3] as! BleInputProperty
-        api.setNotifiable(deviceId: deviceIdArg, service: serviceArg, characteristic: characteristicArg, bleInputProperty: bleInputPropertyArg) { result in
+        let timeoutMsArg: Int64? = nilOrValue(args[4])
+        api.setNotifiable(deviceId: deviceIdArg, service: serviceArg, characteristic: characteristicArg, bleInputProperty: bleInputPropertyArg, timeoutMs: timeoutMsArg) { result in
           switch result {
           case .success:
             reply(wrapResult(nil))
@@ -1700,7 +1706,8 @@ class UniversalBlePlatformChannelSetup {
         let args = message as! [Any?]
         let deviceIdArg = args[0] as! String
         let withDescriptorsArg = args[1] as! Bool
-        api.discoverServices(deviceId: deviceIdArg, withDescriptors: withDescriptorsArg) { result in
+        let timeoutMsArg: Int64? = nilOrValue(args[2])
+        api.discoverServices(deviceId: deviceIdArg, withDescriptors: withDescriptorsArg, timeoutMs: timeoutMsArg) { result in
           switch result {
           case .success(let res):
             reply(wrapResult(res))
@@ -1719,7 +1726,8 @@ class UniversalBlePlatformChannelSetup {
         let deviceIdArg = args[0] as! String
         let serviceArg = args[1] as! String
         let characteristicArg = args[2] as! String
-        api.readValue(deviceId: deviceIdArg, service: serviceArg, characteristic: characteristicArg) { result in
+        let timeoutMsArg: Int64? = nilOrValue(args[3])
+        api.readValue(deviceId: deviceIdArg, service: serviceArg, characteristic: characteristicArg, timeoutMs: timeoutMsArg) { result in
           switch result {
           case .success(let res):
             reply(wrapResult(res))
@@ -1758,7 +1766,8 @@ class UniversalBlePlatformChannelSetup {
         let characteristicArg = args[2] as! String
         let valueArg = args[3] as! FlutterStandardTypedData
         let bleOutputPropertyArg = args[4] as! BleOutputProperty
-        api.writeValue(deviceId: deviceIdArg, service: serviceArg, characteristic: characteristicArg, value: valueArg, bleOutputProperty: bleOutputPropertyArg) { result in
+        let timeoutMsArg: Int64? = nilOrValue(args[5])
+        api.writeValue(deviceId: deviceIdArg, service: serviceArg, characteristic: characteristicArg, value: valueArg, bleOutputProperty: bleOutputPropertyArg, timeoutMs: timeoutMsArg) { result in
           switch result {
           case .success:
             reply(wrapResult(nil))
@@ -1891,8 +1900,9 @@ class UniversalBlePlatformChannelSetup {
       setLogLevelChannel.setMessageHandler { message, reply in
         let args = message as! [Any?]
         let logLevelArg = args[0] as! BleLogLevel
+        let categoryArg: Int64? = nilOrValue(args[1])
         do {
-          try api.setLogLevel(logLevel: logLevelArg)
+          try api.setLogLevel(logLevel: logLevelArg, category: categoryArg)
           reply(wrapResult(nil))
         } catch {
           reply(wrapError(error))
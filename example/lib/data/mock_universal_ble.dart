@@ -57,7 +57,8 @@ class MockUniversalBle extends UniversalBlePlatform {
 
   @override
   Future<List<BleService>> discoverServices(
-      String deviceId, bool withDescriptors) async {
+      String deviceId, bool withDescriptors,
+      {Duration? timeout}) async {
     return [_mockService];
   }
 
@@ -94,7 +95,8 @@ class MockUniversalBle extends UniversalBlePlatform {
       String service,
       String characteristic,
       Uint8List value,
-      BleOutputProperty bleOutputProperty) async {
+      BleOutputProperty bleOutputProperty,
+      {Duration? timeout}) async {
     await Future.delayed(const Duration(milliseconds: 500));
     _serviceValue = value;
   }
@@ -113,7 +115,8 @@ class MockUniversalBle extends UniversalBlePlatform {
 
   @override
   Future<void> setNotifiable(String deviceId, String service,
-      String characteristic, BleInputProperty bleInputProperty) async {}
+      String characteristic, BleInputProperty bleInputProperty,
+      {Duration? timeout}) async {}
 
   @override
   Future<bool> isPaired(String deviceId) async {
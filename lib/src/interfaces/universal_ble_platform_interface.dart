@@ -13,6 +13,7 @@ abstract class UniversalBlePlatform {
   OnAvailabilityChange? onAvailabilityChange;
   OnPairingStateChange? onPairingStateChange;
   OnConnectionParametersChange? onConnectionParametersChange;
+  OnMtuChange? onMtuChange;
   final Map<String, bool> _pairStateMap = {};
   final Map<String, BleConnectionParametersUpdated>
   _lastConnectionParametersMap = {};
@@ -25,9 +26,7 @@ abstract class UniversalBlePlatform {
       >();
 
   final _valueStreamController =
-      UniversalBleStreamController<
-        ({String deviceId, String characteristicId, Uint8List value})
-      >();
+      UniversalBleStreamController<BleCharacteristicValue>();
 
   final _pairStateStreamController =
       UniversalBleStreamController<({String deviceId, bool isPaired})>();
@@ -72,15 +71,17 @@ abstract class UniversalBlePlatform {
 
   Future<List<BleService>> discoverServices(
     String deviceId,
-    bool withDescriptors,
-  );
+    bool withDescriptors, {
+    Duration? timeout,
+  });
 
   Future<void> setNotifiable(
     String deviceId,
     String service,
     String characteristic,
-    BleInputProperty bleInputProperty,
-  );
+    BleInputProperty bleInputProperty, {
+    Duration? timeout,
+  });
 
   Future<Uint8List> readValue(
     String deviceId,
@@ -94,8 +95,9 @@ abstract class UniversalBlePlatform {
     String service,
     String characteristic,
     Uint8List value,
-    BleOutputProperty bleOutputProperty,
-  );
+    BleOutputProperty bleOutputProperty, {
+    Duration? timeout,
+  });
 
   Future<int> requestMtu(String deviceId, int expectedMtu);
 
@@ -116,8 +118,14 @@ abstract class UniversalBlePlatform {
 
   Future<List<BleDevice>> getSystemDevices(List<String>? withServices);
 
-  Future<void> setLogLevel(BleLogLevel logLevel) async =>
-      UniversalLogger.setLogLevel(logLevel);
+  /// Log categories are native and Windows only; the default ignores calls
+  /// with a [category].
+  Future<void> setLogLevel(
+    BleLogLevel logLevel, {
+    BleLogCategory? category,
+  }) async {
+    if (category == null) UniversalLogger.setLogLevel(logLevel);
+  }
 
   bool receivesAdvertisements(String deviceId) => true;
 
@@ -144,15 +152,21 @@ abstract class UniversalBlePlatform {
   Stream<Uint8List> characteristicValueStream(
     String deviceId,
     String characteristicId,
+  ) => characteristicValueEventStream(
+    deviceId,
+    characteristicId,
+  ).map((e) => e.value);
+
+  Stream<BleCharacteristicValue> characteristicValueEventStream(
+    String deviceId,
+    String characteristicId,
   ) {
     final target = deviceId.toLowerCase();
     characteristicId = BleUuidParser.string(characteristicId);
-    return _valueStreamController.stream
-        .where((e) {
-          return (e.deviceId == deviceId || e.deviceId.toLowerCase() == target) &&
-              e.characteristicId == characteristicId;
-        })
-        .map((e) => e.value);
+    return _valueStreamController.stream.where((e) {
+      return (e.deviceId == deviceId || e.deviceId.toLowerCase() == target) &&
+          e.characteristicId == characteristicId;
+    });
   }
 
   Stream<bool> pairingStateStream(String deviceId) {
@@ -190,18 +204,25 @@ abstract class UniversalBlePlatform {
     }
   }
 
+  /// [timestamp] is in milliseconds; platforms with a finer clock also
+  /// pass [timestampMicros].
   void updateCharacteristicValue(
     String deviceId,
     String characteristicId,
     Uint8List value,
-    int? timestamp,
-  ) {
+    int? timestamp, {
+    int? timestampMicros,
+  }) {
     characteristicId = BleUuidParser.string(characteristicId);
-    _valueStreamController.add((
-      deviceId: deviceId,
-      characteristicId: characteristicId,
-      value: value,
-    ));
+    _valueStreamController.add(
+      BleCharacteristicValue(
+        deviceId: deviceId,
+        characteristicId: characteristicId,
+        value: value,
+        timestampMicros:
+            timestampMicros ?? (timestamp != null ? timestamp * 1000 : null),
+      ),
+    );
     try {
       onValueChange?.call(deviceId, characteristicId, value, timestamp);
     } catch (_) {}
@@ -229,6 +250,12 @@ abstract class UniversalBlePlatform {
     } catch (_) {}
   }
 
+  void updateMtu(String deviceId, int mtu) {
+    try {
+      onMtuChange?.call(deviceId, mtu);
+    } catch (_) {}
+  }
+
   void updateConnectionParameters(BleConnectionParametersUpdated update) {
     // Key by the canonical id (dropping the now-redundant last.deviceId == update.deviceId check, which would
     // itself have failed across cases and broken dedup for a device reported in two cases).
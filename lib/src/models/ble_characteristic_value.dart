@@ -0,0 +1,29 @@
+import 'dart:typed_data';
+
+/// A characteristic value update, from
+/// `UniversalBle.characteristicValueEventStream`.
+class BleCharacteristicValue {
+  final String deviceId;
+  final String characteristicId;
+  final Uint8List value;
+
+  /// Arrival time in microseconds since the Unix epoch. Windows stamps it
+  /// natively from the monotonic clock; other platforms report
+  /// milliseconds, scaled up. Null if the platform reports no time.
+  final int? timestampMicros;
+
+  const BleCharacteristicValue({
+    required this.deviceId,
+    required this.characteristicId,
+    required this.value,
+    this.timestampMicros,
+  });
+
+  DateTime? get timestampDateTime => timestampMicros != null
+      ? DateTime.fromMicrosecondsSinceEpoch(timestampMicros!)
+      : null;
+
+  @override
+  String toString() =>
+      'BleCharacteristicValue($deviceId, $characteristicId, $value, $timestampMicros)';
+}
@@ -0,0 +1,6 @@
+/// Native log areas whose level can be set separately with
+/// `UniversalBle.setLogLevel(level, category: ...)`.
+///
+/// [general] covers connection, radio and state handling. Only the Windows
+/// plugin has categories; the order matches its `LogCategory`.
+enum BleLogCategory { general, scan, gatt, notify, peripheral, pairing }
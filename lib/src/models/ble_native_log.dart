@@ -0,0 +1,23 @@
+import 'package:universal_ble/src/models/ble_log_category.dart';
+import 'package:universal_ble/src/universal_ble.g.dart';
+
+/// A native log record forwarded by `UniversalBle.forwardNativeLogs`.
+class BleNativeLog {
+  final BleLogLevel level;
+  final BleLogCategory category;
+
+  /// Microseconds since the Unix epoch, from the native monotonic clock.
+  final int timestampMicros;
+  final String message;
+
+  const BleNativeLog({
+    required this.level,
+    required this.category,
+    required this.timestampMicros,
+    required this.message,
+  });
+
+  @override
+  String toString() =>
+      'BleNativeLog(${level.name}, ${category.name}, $timestampMicros, $message)';
+}
@@ -10,3 +10,8 @@ export 'package:universal_ble/src/models/ble_capabilities.dart';
 export 'package:universal_ble/src/models/ble_connection_parameters_updated.dart';
 export 'package:universal_ble/src/models/ble_peripheral_event.dart';
 export 'package:universal_ble/src/models/ble_peripheral_capabilities.dart';
+export 'package:universal_ble/src/models/ble_log_category.dart';
+export 'package:universal_ble/src/models/ble_native_log.dart';
+export 'package:universal_ble/src/models/ble_characteristic_value.dart';
+export 'package:universal_ble/src/models/windows_gatt_options.dart';
+export 'package:universal_ble/src/models/windows_notification_options.dart';
@@ -0,0 +1,52 @@
+/// When the Windows plugin discovers services and characteristics.
+enum WindowsGattDiscoveryMode {
+  /// Discover everything before reporting the device connected.
+  onConnect,
+
+  /// Report connected right away and discover on the first GATT call.
+  onDemand,
+}
+
+/// Where the Windows plugin answers characteristic reads from.
+enum WindowsReadCachePolicy {
+  /// Always read over the air.
+  uncached,
+
+  /// Let Windows answer from its own GATT cache when it has a value.
+  osCached,
+
+  /// Answer from the plugin's value cache, which notifications keep current
+  /// and writes invalidate; read over the air only on a miss.
+  nativeCache,
+}
+
+/// Windows GATT settings of one device, set with
+/// `UniversalBle.setWindowsGattOptions`. Each call replaces all of them.
+class WindowsGattOptions {
+  /// Takes effect on the next connect.
+  final WindowsGattDiscoveryMode discoveryMode;
+
+  /// Characteristic or descriptor requests in flight at once while
+  /// discovering; 1 discovers strictly serially.
+  final int maxParallelDiscoveryRequests;
+
+  /// Keeps the services and characteristics of the device on disk, so a
+  /// reconnect can use the Windows GATT cache instead of discovering over
+  /// the air. Only used for devices that expose a Database Hash, which
+  /// validates the stored layout on every connect.
+  final bool persistGattLayout;
+
+  final WindowsReadCachePolicy readCachePolicy;
+
+  /// Oldest value [WindowsReadCachePolicy.nativeCache] may return; no limit
+  /// when null.
+  final Duration? readCacheMaxAge;
+
+  const WindowsGattOptions({
+    this.discoveryMode = WindowsGattDiscoveryMode.onConnect,
+    this.maxParallelDiscoveryRequests = 4,
+    this.persistGattLayout = false,
+    this.readCachePolicy = WindowsReadCachePolicy.uncached,
+    this.readCacheMaxAge,
+  });
+}
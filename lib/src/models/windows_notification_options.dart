@@ -0,0 +1,132 @@
+/// What the Windows plugin does when notifications arrive faster than Dart
+/// takes them.
+enum WindowsBackpressurePolicy {
+  /// Discard the oldest buffered notification.
+  dropOldest,
+
+  /// Buffer only the newest notification.
+  keepLatest,
+
+  /// Hold up the Bluetooth stack for up to
+  /// [WindowsNotificationOptions.maxBlock], then discard the oldest.
+  blockProducer,
+}
+
+/// How the Windows plugin sends notifications to Dart.
+enum WindowsNotificationTransport {
+  /// Platform messages with the standard codec.
+  pigeon,
+
+  /// Compact binary frames, cheaper to encode and decode at high rates.
+  binary,
+}
+
+/// How the Windows plugin reassembles frames that a device splits across
+/// notifications. Each frame reaches Dart as one value.
+enum WindowsFraming {
+  /// Every notification is one value.
+  none,
+
+  /// Each frame starts with its length; see
+  /// [WindowsNotificationOptions.lengthPrefixSize].
+  lengthPrefix,
+
+  /// RFC 1055 SLIP: frames end with 0xC0.
+  slip,
+
+  /// Consistent Overhead Byte Stuffing: frames end with 0x00.
+  cobs,
+}
+
+/// Integrity check at the end of each frame.
+enum WindowsFrameCheck {
+  none,
+
+  /// Little-endian CRC-16/CCITT-FALSE over the frame, removed before
+  /// delivery. Frames that fail it are dropped.
+  crc16Ccitt,
+}
+
+/// Which notifications the Windows plugin passes on to Dart.
+enum WindowsNotificationFilter {
+  all,
+
+  /// Only values that differ from the last one delivered.
+  onChange,
+
+  /// At most [WindowsNotificationOptions.filterMaxRateHz] per second. The
+  /// latest value of each period is delivered when it ends.
+  rateLimit,
+
+  /// Every [WindowsNotificationOptions.filterEveryNth] notification.
+  everyNth,
+}
+
+/// Windows delivery settings of one characteristic's notifications, set
+/// with `UniversalBle.setWindowsNotificationOptions`. Each call replaces all
+/// of them; they apply from the next subscription.
+class WindowsNotificationOptions {
+  /// With [WindowsNotificationTransport.binary], buffered notifications are
+  /// always sent together and the batch settings are unused.
+  final WindowsNotificationTransport transport;
+
+  /// Delivers notifications that arrive close together in one message to
+  /// Dart instead of one message each.
+  final bool batch;
+
+  /// Most notifications in one batch.
+  final int batchMaxEntries;
+
+  /// Longest a notification waits for others to join its batch.
+  final Duration batchMaxDelay;
+
+  /// Notifications buffered for Dart before [backpressurePolicy] applies.
+  final int bufferCapacity;
+
+  final WindowsBackpressurePolicy backpressurePolicy;
+
+  /// Longest [WindowsBackpressurePolicy.blockProducer] waits for room.
+  final Duration maxBlock;
+
+  final WindowsFraming framing;
+
+  final WindowsFrameCheck frameCheck;
+
+  /// Longest decoded frame in bytes; longer frames are dropped.
+  final int maxFrameSize;
+
+  /// Bytes of the length before each [WindowsFraming.lengthPrefix] frame,
+  /// 1 to 8.
+  final int lengthPrefixSize;
+
+  final bool lengthPrefixBigEndian;
+
+  /// Whether the length counts its own bytes.
+  final bool lengthIncludesPrefix;
+
+  /// Applied before framing, batching and buffering.
+  final WindowsNotificationFilter filter;
+
+  final double filterMaxRateHz;
+
+  final int filterEveryNth;
+
+  const WindowsNotificationOptions({
+    this.transport = WindowsNotificationTransport.pigeon,
+    this.batch = false,
+    this.batchMaxEntries = 32,
+    this.batchMaxDelay = const Duration(milliseconds: 8),
+    this.bufferCapacity = 256,
+    this.backpressurePolicy = WindowsBackpressurePolicy.dropOldest,
+    this.maxBlock = const Duration(milliseconds: 50),
+    this.framing = WindowsFraming.none,
+    this.frameCheck = WindowsFrameCheck.none,
+    this.maxFrameSize = 4096,
+    this.lengthPrefixSize = 2,
+    this.lengthPrefixBigEndian = false,
+    this.lengthIncludesPrefix = false,
+    this.filter = WindowsNotificationFilter.all,
+    this.filterMaxRateHz = 0,
+    this.filterEveryNth = 1,
+  });
+}
@@ -26,12 +26,73 @@ class UniversalBle {
 
   /// Set log level for both Dart and native implementations.
   /// Only effective in debug builds.
-  static Future<void> setLogLevel(BleLogLevel logLevel) async {
+  ///
+  /// With a [category], only that native area changes, e.g. verbose pairing
+  /// logs without per-notification lines, also in release builds for
+  /// [forwardNativeLogs]. Categories are Windows only and ignored elsewhere.
+  static Future<void> setLogLevel(
+    BleLogLevel logLevel, {
+    BleLogCategory? category,
+  }) async {
+    if (category != null) {
+      await _platform.setLogLevel(logLevel, category: category);
+      return;
+    }
     if (!kDebugMode) return;
     UniversalLogger.setLogLevel(logLevel);
     await _platform.setLogLevel(logLevel);
   }
 
+  /// Windows only: forwards native logs at [logLevel] and above to
+  /// [nativeLogStream] in batches, also in release builds. Categories set
+  /// quieter than [logLevel] are raised to it while forwarding;
+  /// [BleLogLevel.none] stops forwarding and restores their levels. Release
+  /// builds of the plugin compile out debug and verbose records.
+  static Future<void> forwardNativeLogs(BleLogLevel logLevel) =>
+      UniversalBlePigeonChannel.forwardNativeLogs(logLevel);
+
+  /// Native log records enabled by [forwardNativeLogs].
+  static Stream<BleNativeLog> get nativeLogStream =>
+      UniversalBlePigeonChannel.nativeLogStream;
+
+  /// Windows only: metrics of the native thread that delivers scan results,
+  /// notifications and connection events to Dart. Returns null elsewhere.
+  static Future<Map<Object?, Object?>?> getDispatcherStats() =>
+      UniversalBlePigeonChannel.getDispatcherStats();
+
+  /// Windows only: per device and characteristic, the notifications dropped
+  /// because Dart fell behind and the most ever buffered. Returns null
+  /// elsewhere.
+  static Future<Map<String, Map<String, ({int dropped, int highWater})>>?>
+  getNotificationBufferStats() =>
+      UniversalBlePigeonChannel.getNotificationBufferStats();
+
+  /// Windows only: GATT settings of [deviceId], such as when its services
+  /// are discovered. No-op elsewhere.
+  static Future<void> setWindowsGattOptions(
+    String deviceId,
+    WindowsGattOptions options,
+  ) => UniversalBlePigeonChannel.setWindowsGattOptions(deviceId, options);
+
+  /// Windows only: how notifications of [characteristic] reach Dart, such as
+  /// batched. Applies from the next subscription. No-op elsewhere.
+  static Future<void> setWindowsNotificationOptions(
+    String deviceId,
+    String service,
+    String characteristic,
+    WindowsNotificationOptions options,
+  ) => UniversalBlePigeonChannel.setWindowsNotificationOptions(
+    deviceId,
+    BleUuidParser.string(service),
+    BleUuidParser.string(characteristic),
+    options,
+  );
+
+  /// Windows only: recent native callbacks as Chrome trace event JSON.
+  /// Returns null elsewhere.
+  static Future<String?> dumpDispatcherTrace() =>
+      UniversalBlePigeonChannel.dumpDispatcherTrace();
+
   /// Set how commands will be executed. By default, all commands are executed in a global queue (`QueueType.global`),
   /// with each command waiting for the previous one to finish.
   ///
@@ -60,6 +121,12 @@ class UniversalBle {
     String characteristicId,
   ) => _platform.characteristicValueStream(deviceId, characteristicId);
 
+  /// Characteristic value stream with the arrival time of each value
+  static Stream<BleCharacteristicValue> characteristicValueEventStream(
+    String deviceId,
+    String characteristicId,
+  ) => _platform.characteristicValueEventStream(deviceId, characteristicId);
+
   /// Pairing state stream
   static Stream<bool> pairingStateStream(String deviceId) =>
       _platform.pairingStateStream(deviceId);
@@ -246,7 +313,11 @@ class UniversalBle {
     String? queueId,
   }) async {
     return await _bleCommandQueue.queueCommand(
-      () => _platform.discoverServices(deviceId, withDescriptors),
+      () => _platform.discoverServices(
+        deviceId,
+        withDescriptors,
+        timeout: timeout,
+      ),
       timeout: timeout,
       deviceId: deviceId,
       queueId: queueId,
@@ -353,6 +424,7 @@ class UniversalBle {
         withoutResponse
             ? BleOutputProperty.withoutResponse
             : BleOutputProperty.withResponse,
+        timeout: timeout,
       ),
       timeout: timeout,
       deviceId: deviceId,
@@ -735,6 +807,7 @@ class UniversalBle {
         BleUuidParser.string(service),
         BleUuidParser.string(characteristic),
         bleInputProperty,
+        timeout: timeout,
       ),
       deviceId: deviceId,
       timeout: timeout,
@@ -915,6 +988,11 @@ class UniversalBle {
     OnConnectionParametersChange? onConnectionParametersChange,
   ) => _platform.onConnectionParametersChange = onConnectionParametersChange;
 
+  /// MTU changes negotiated by the device or the OS after connecting
+  /// (Windows).
+  static set onMtuChange(OnMtuChange? onMtuChange) =>
+      _platform.onMtuChange = onMtuChange;
+
   static UniversalBlePlatform _defaultPlatform() {
     if (kIsWeb) return UniversalBleWeb.instance;
     if (defaultTargetPlatform == TargetPlatform.linux) {
@@ -1718,12 +1718,15 @@ class UniversalBlePlatformChannel {
     );
   }
 
+  /// A positive [timeoutMs] bounds the whole call, including an on-demand
+  /// discovery, instead of the native default (Windows only).
   Future<void> setNotifiable(
     String deviceId,
     String service,
     String characteristic,
-    BleInputProperty bleInputProperty,
-  ) async {
+    BleInputProperty bleInputProperty, {
+    int? timeoutMs,
+  }) async {
     final pigeonVar_channelName =
         'dev.flutter.pigeon.universal_ble.UniversalBlePlatformChannel.setNotifiable$pigeonVar_messageChannelSuffix';
     final pigeonVar_channel = BasicMessageChannel<Object?>(
@@ -1732,7 +1735,13 @@ class UniversalBlePlatformChannel {
       binaryMessenger: pigeonVar_binaryMessenger,
     );
     final Future<Object?> pigeonVar_sendFuture = pigeonVar_channel.send(
-      <Object?>[deviceId, service, characteristic, bleInputProperty],
+      <Object?>[
+        deviceId,
+        service,
+        characteristic,
+        bleInputProperty,
+        timeoutMs,
+      ],
     );
     final pigeonVar_replyList = await pigeonVar_sendFuture as List<Object?>?;
 
@@ -1745,8 +1754,9 @@ class UniversalBlePlatformChannel {
 
   Future<List<UniversalBleService>> discoverServices(
     String deviceId,
-    bool withDescriptors,
-  ) async {
+    bool withDescriptors, {
+    int? timeoutMs,
+  }) async {
     final pigeonVar_channelName =
         'dev.flutter.pigeon.universal_ble.UniversalBlePlatformChannel.discoverServices$pigeonVar_messageChannelSuffix';
     final pigeonVar_channel = BasicMessageChannel<Object?>(
@@ -1755,7 +1765,7 @@ class UniversalBlePlatformChannel {
       binaryMessenger: pigeonVar_binaryMessenger,
     );
     final Future<Object?> pigeonVar_sendFuture = pigeonVar_channel.send(
-      <Object?>[deviceId, withDescriptors],
+      <Object?>[deviceId, withDescriptors, timeoutMs],
     );
     final pigeonVar_replyList = await pigeonVar_sendFuture as List<Object?>?;
 
@@ -1770,8 +1780,9 @@ class UniversalBlePlatformChannel {
   Future<Uint8List> readValue(
     String deviceId,
     String service,
-    String characteristic,
-  ) async {
+    String characteristic, {
+    int? timeoutMs,
+  }) async {
     final pigeonVar_channelName =
         'dev.flutter.pigeon.universal_ble.UniversalBlePlatformChannel.readValue$pigeonVar_messageChannelSuffix';
     final pigeonVar_channel = BasicMessageChannel<Object?>(
@@ -1780,7 +1791,7 @@ class UniversalBlePlatformChannel {
       binaryMessenger: pigeonVar_binaryMessenger,
     );
     final Future<Object?> pigeonVar_sendFuture = pigeonVar_channel.send(
-      <Object?>[deviceId, service, characteristic],
+      <Object?>[deviceId, service, characteristic, timeoutMs],
     );
     final pigeonVar_replyList = await pigeonVar_sendFuture as List<Object?>?;
 
@@ -1818,8 +1829,9 @@ class UniversalBlePlatformChannel {
     String service,
     String characteristic,
     Uint8List value,
-    BleOutputProperty bleOutputProperty,
-  ) async {
+    BleOutputProperty bleOutputProperty, {
+    int? timeoutMs,
+  }) async {
     final pigeonVar_channelName =
         'dev.flutter.pigeon.universal_ble.UniversalBlePlatformChannel.writeValue$pigeonVar_messageChannelSuffix';
     final pigeonVar_channel = BasicMessageChannel<Object?>(
@@ -1828,7 +1840,14 @@ class UniversalBlePlatformChannel {
       binaryMessenger: pigeonVar_binaryMessenger,
     );
     final Future<Object?> pigeonVar_sendFuture = pigeonVar_channel.send(
-      <Object?>[deviceId, service, characteristic, value, bleOutputProperty],
+      <Object?>[
+        deviceId,
+        service,
+        characteristic,
+        value,
+        bleOutputProperty,
+        timeoutMs,
+      ],
     );
     final pigeonVar_replyList = await pigeonVar_sendFuture as List<Object?>?;
 
@@ -1990,7 +2009,10 @@ class UniversalBlePlatformChannel {
     );
   }
 
-  Future<void> setLogLevel(BleLogLevel logLevel) async {
+  /// With a [category] (`BleLogCategory.index`), only that native area
+  /// changes. Categories are Windows only; other platforms ignore such
+  /// calls.
+  Future<void> setLogLevel(BleLogLevel logLevel, {int? category}) async {
     final pigeonVar_channelName =
         'dev.flutter.pigeon.universal_ble.UniversalBlePlatformChannel.setLogLevel$pigeonVar_messageChannelSuffix';
     final pigeonVar_channel = BasicMessageChannel<Object?>(
@@ -1999,7 +2021,7 @@ class UniversalBlePlatformChannel {
       binaryMessenger: pigeonVar_binaryMessenger,
     );
     final Future<Object?> pigeonVar_sendFuture = pigeonVar_channel.send(
-      <Object?>[logLevel],
+      <Object?>[logLevel, category],
     );
     final pigeonVar_replyList = await pigeonVar_sendFuture as List<Object?>?;
 
@@ -169,8 +169,9 @@ class UniversalBleLinux extends UniversalBlePlatform {
   @override
   Future<List<BleService>> discoverServices(
     String deviceId,
-    bool withDescriptors,
-  ) async {
+    bool withDescriptors, {
+    Duration? timeout,
+  }) async {
     final device = _findDeviceById(deviceId);
     if (device.gattServices.isEmpty && !device.servicesResolved) {
       await device.propertiesChanged
@@ -261,8 +262,9 @@ class UniversalBleLinux extends UniversalBlePlatform {
     String deviceId,
     String service,
     String characteristic,
-    BleInputProperty bleInputProperty,
-  ) async {
+    BleInputProperty bleInputProperty, {
+    Duration? timeout,
+  }) async {
     UniversalLogger.logDebug(
       "SET_NOTIFY -> $deviceId $service $characteristic input=${bleInputProperty.name}",
       withTimestamp: true,
@@ -347,8 +349,9 @@ class UniversalBleLinux extends UniversalBlePlatform {
     String service,
     String characteristic,
     Uint8List value,
-    BleOutputProperty bleOutputProperty,
-  ) async {
+    BleOutputProperty bleOutputProperty, {
+    Duration? timeout,
+  }) async {
     UniversalLogger.logDebug(
       "WRITE -> $deviceId $service $characteristic len=${value.length} property=${bleOutputProperty.name}",
       withTimestamp: true,
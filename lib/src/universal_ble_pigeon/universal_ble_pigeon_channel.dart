@@ -1,6 +1,10 @@
+import 'dart:convert';
+
 import 'package:flutter/foundation.dart';
+import 'package:flutter/services.dart';
 import 'package:universal_ble/src/universal_ble.g.dart';
 import 'package:universal_ble/src/utils/universal_ble_filter_util.dart';
+import 'package:universal_ble/src/utils/universal_ble_stream_controller.dart';
 import 'package:universal_ble/universal_ble.dart';
 
 class UniversalBlePigeonChannel extends UniversalBlePlatform
@@ -12,6 +16,182 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
 
   UniversalBlePigeonChannel._() {
     UniversalBleCallbackChannel.setUp(this);
+    _valueChangedBatchChannel.setMessageHandler(_onValueChangedBatch);
+    _mtuChannel.setMessageHandler(_onMtuChanged);
+    ServicesBinding.instance.defaultBinaryMessenger.setMessageHandler(
+      _valueChangedBinaryChannel,
+      _onValueChangedBinary,
+    );
+  }
+
+  /// Compact notification frames (Windows). See
+  /// windows/src/universal_ble_notification_codec.h for the layout.
+  static const _valueChangedBinaryChannel =
+      'universal_ble/value_changed_binary';
+
+  /// Subscription id -> (deviceId, characteristicId) for binary frames.
+  final Map<int, (String, String)> _binarySubscriptions = {};
+
+  /// Notifications batched natively (Windows), delivered as
+  /// `[deviceId, characteristicId, [timestamp0, value0, timestamp1, ...]]`
+  /// with timestamps in microseconds.
+  static const _valueChangedBatchChannel = BasicMessageChannel<Object?>(
+    'universal_ble/value_changed_batch',
+    StandardMessageCodec(),
+  );
+
+  /// Negotiated MTU changes (Windows), delivered as `[deviceId, mtu]`.
+  static const _mtuChannel = BasicMessageChannel<Object?>(
+    'universal_ble/mtu',
+    StandardMessageCodec(),
+  );
+
+  /// Native UI-thread dispatcher metrics (Windows). See
+  /// windows/src/ui_thread_handler.hpp.
+  static const _dispatcherStatsChannel = BasicMessageChannel<Object?>(
+    'universal_ble/dispatcher_stats',
+    StandardMessageCodec(),
+  );
+
+  /// Forwarded native log batches (Windows), delivered as
+  /// `[level0, category0, micros0, message0, level1, ...]`. Dart sends the
+  /// [BleLogLevel] index to opt in.
+  static const _nativeLogChannel = BasicMessageChannel<Object?>(
+    'universal_ble/native_logs',
+    StandardMessageCodec(),
+  );
+
+  /// Per-device and per-characteristic GATT options (Windows).
+  static const _gattChannel = MethodChannel('universal_ble/gatt');
+
+  static final _nativeLogStreamController =
+      UniversalBleStreamController<BleNativeLog>();
+
+  static bool get _hasWindowsNativeChannels =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// Queue depth and peak, callbacks per second, and latency percentiles in
+  /// microseconds: `queue_wait` per lane and `execution` per callback kind.
+  /// `gatt_timeouts` maps each device id to its number of GATT operations
+  /// cancelled by their timeout, and `notification_buffers` maps it to the
+  /// buffer statistics of each subscribed characteristic. Null on platforms
+  /// without a native dispatcher.
+  static Future<Map<Object?, Object?>?> getDispatcherStats() async {
+    if (!_hasWindowsNativeChannels) return null;
+    final stats = await _dispatcherStatsChannel.send('stats');
+    return stats as Map<Object?, Object?>?;
+  }
+
+  /// Device id -> characteristic id -> notifications dropped by a full
+  /// buffer and the most ever buffered, summed over the subscriptions of
+  /// the characteristic since the plugin started. Null on platforms
+  /// without native notification buffers.
+  static Future<Map<String, Map<String, ({int dropped, int highWater})>>?>
+  getNotificationBufferStats() async {
+    final stats = await getDispatcherStats();
+    if (stats == null) return null;
+    final devices =
+        stats['notification_buffers'] as Map<Object?, Object?>? ?? {};
+    return {
+      for (final MapEntry(key: deviceId, value: characteristics)
+          in devices.entries)
+        deviceId as String: {
+          for (final MapEntry(key: characteristicId, value: buffer)
+              in (characteristics as Map<Object?, Object?>).entries)
+            characteristicId as String: (
+              dropped: (buffer as Map<Object?, Object?>)['dropped'] as int,
+              highWater: buffer['high_water'] as int,
+            ),
+        },
+    };
+  }
+
+  /// Applies [options] to [deviceId]. No-op on platforms other than
+  /// Windows.
+  static Future<void> setWindowsGattOptions(
+    String deviceId,
+    WindowsGattOptions options,
+  ) async {
+    if (!_hasWindowsNativeChannels) return;
+    await _gattChannel.invokeMethod<void>('setDeviceOptions', {
+      'deviceId': deviceId,
+      'discoveryMode': options.discoveryMode.index,
+      'maxParallelDiscoveryRequests': options.maxParallelDiscoveryRequests,
+      'persistGattLayout': options.persistGattLayout,
+      'readCachePolicy': options.readCachePolicy.index,
+      'readCacheMaxAgeMs': options.readCacheMaxAge?.inMilliseconds,
+    });
+  }
+
+  /// Applies [options] to notifications of [characteristic] of [deviceId].
+  /// No-op on platforms other than Windows.
+  static Future<void> setWindowsNotificationOptions(
+    String deviceId,
+    String service,
+    String characteristic,
+    WindowsNotificationOptions options,
+  ) async {
+    if (!_hasWindowsNativeChannels) return;
+    await _gattChannel.invokeMethod<void>('setNotificationOptions', {
+      'deviceId': deviceId,
+      'service': service,
+      'characteristic': characteristic,
+      'transport': options.transport.index,
+      'batch': options.batch,
+      'batchMaxEntries': options.batchMaxEntries,
+      'batchMaxDelayMs': options.batchMaxDelay.inMilliseconds,
+      'bufferCapacity': options.bufferCapacity,
+      'backpressurePolicy': options.backpressurePolicy.index,
+      'maxBlockMs': options.maxBlock.inMilliseconds,
+      'framing': options.framing.index,
+      'frameCheck': options.frameCheck.index,
+      'maxFrameSize': options.maxFrameSize,
+      'lengthPrefixSize': options.lengthPrefixSize,
+      'lengthPrefixBigEndian': options.lengthPrefixBigEndian,
+      'lengthIncludesPrefix': options.lengthIncludesPrefix,
+      'filter': options.filter.index,
+      'filterMaxRateHz': options.filterMaxRateHz,
+      'filterEveryNth': options.filterEveryNth,
+    });
+  }
+
+  /// Native log records enabled by [forwardNativeLogs].
+  static Stream<BleNativeLog> get nativeLogStream =>
+      _nativeLogStreamController.stream;
+
+  /// Sets every native log category to [logLevel] and forwards the records
+  /// to [nativeLogStream] in batches; [BleLogLevel.none] stops forwarding.
+  /// No-op on platforms without native log forwarding.
+  static Future<void> forwardNativeLogs(BleLogLevel logLevel) async {
+    if (!_hasWindowsNativeChannels) return;
+    _nativeLogChannel.setMessageHandler(
+      logLevel == BleLogLevel.none ? null : _onNativeLogs,
+    );
+    await _nativeLogChannel.send(logLevel.index);
+  }
+
+  static Future<Object?> _onNativeLogs(Object? message) async {
+    final records = message as List<Object?>;
+    for (var i = 0; i + 3 < records.length; i += 4) {
+      _nativeLogStreamController.add(
+        BleNativeLog(
+          level: BleLogLevel.values[records[i] as int],
+          category: BleLogCategory.values[records[i + 1] as int],
+          timestampMicros: records[i + 2] as int,
+          message: records[i + 3] as String,
+        ),
+      );
+    }
+    return null;
+  }
+
+  /// The most recent dispatcher callbacks as Chrome trace event JSON, for
+  /// chrome://tracing or Perfetto. Null on platforms without a native
+  /// dispatcher.
+  static Future<String?> dumpDispatcherTrace() async {
+    if (!_hasWindowsNativeChannels) return null;
+    final trace = await _dispatcherStatsChannel.send('trace');
+    return trace as String?;
   }
 
   final _channel = UniversalBlePlatformChannel();
@@ -81,19 +261,28 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
   Future<void> disconnect(String deviceId) =>
       _executeWithErrorHandling(() => _channel.disconnect(deviceId));
 
+  /// The `timeoutMs` of a GATT call: [timeout] is also enforced natively on
+  /// Windows, which cancels the operation instead of abandoning it.
+  static int? _nativeTimeoutMs(Duration? timeout) =>
+      _hasWindowsNativeChannels ? timeout?.inMilliseconds : null;
+
   @override
   Future<List<BleService>> discoverServices(
     String deviceId,
-    bool withDescriptors,
-  ) async {
-    List<UniversalBleService?> universalBleServices =
-        await _executeWithErrorHandling(
-          () => _channel.discoverServices(deviceId, withDescriptors),
-        );
+    bool withDescriptors, {
+    Duration? timeout,
+  }) async {
+    List<Object?> universalBleServices = await _executeWithErrorHandling(
+      () => _channel.discoverServices(
+        deviceId,
+        withDescriptors,
+        timeoutMs: _nativeTimeoutMs(timeout),
+      ),
+    );
     return List<BleService>.from(
       universalBleServices
-          .where((e) => e != null)
-          .map((e) => e!.toBleService(deviceId))
+          .whereType<UniversalBleService>()
+          .map((e) => e.toBleService(deviceId))
           .toList(),
     );
   }
@@ -103,14 +292,16 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
     String deviceId,
     String service,
     String characteristic,
-    BleInputProperty bleInputProperty,
-  ) {
+    BleInputProperty bleInputProperty, {
+    Duration? timeout,
+  }) {
     return _executeWithErrorHandling(
       () => _channel.setNotifiable(
         deviceId,
         service,
         characteristic,
         bleInputProperty,
+        timeoutMs: _nativeTimeoutMs(timeout),
       ),
     );
   }
@@ -123,7 +314,12 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
     Duration? timeout,
   }) {
     return _executeWithErrorHandling(
-      () => _channel.readValue(deviceId, service, characteristic),
+      () => _channel.readValue(
+        deviceId,
+        service,
+        characteristic,
+        timeoutMs: _nativeTimeoutMs(timeout),
+      ),
     );
   }
 
@@ -133,8 +329,9 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
     String service,
     String characteristic,
     Uint8List value,
-    BleOutputProperty bleOutputProperty,
-  ) {
+    BleOutputProperty bleOutputProperty, {
+    Duration? timeout,
+  }) {
     return _executeWithErrorHandling(
       () => _channel.writeValue(
         deviceId,
@@ -142,6 +339,7 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
         characteristic,
         value,
         bleOutputProperty,
+        timeoutMs: _nativeTimeoutMs(timeout),
       ),
     );
   }
@@ -199,8 +397,10 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
   }
 
   @override
-  Future<void> setLogLevel(BleLogLevel logLevel) =>
-      _executeWithErrorHandling(() => _channel.setLogLevel(logLevel));
+  Future<void> setLogLevel(BleLogLevel logLevel, {BleLogCategory? category}) =>
+      _executeWithErrorHandling(
+        () => _channel.setLogLevel(logLevel, category: category?.index),
+      );
 
   /// Executes a platform call with error handling
   /// Converts any errors to UniversalBleException
@@ -244,13 +444,108 @@ class UniversalBlePigeonChannel extends UniversalBlePlatform
     updateScanResult(bleDevice);
   }
 
+  /// [timestamp] is in microseconds on Windows, milliseconds elsewhere.
   @override
   void onValueChanged(
     String deviceId,
     String characteristicId,
     Uint8List value,
     int? timestamp,
-  ) => updateCharacteristicValue(deviceId, characteristicId, value, timestamp);
+  ) {
+    if (!_hasWindowsNativeChannels) {
+      updateCharacteristicValue(deviceId, characteristicId, value, timestamp);
+      return;
+    }
+    _updateCharacteristicValueMicros(
+      deviceId,
+      characteristicId,
+      value,
+      timestamp,
+    );
+  }
+
+  void _updateCharacteristicValueMicros(
+    String deviceId,
+    String characteristicId,
+    Uint8List value,
+    int? timestampMicros,
+  ) => updateCharacteristicValue(
+    deviceId,
+    characteristicId,
+    value,
+    timestampMicros != null ? timestampMicros ~/ 1000 : null,
+    timestampMicros: timestampMicros,
+  );
+
+  Future<Object?> _onValueChangedBatch(Object? message) async {
+    final args = message as List<Object?>;
+    final deviceId = args[0] as String;
+    final characteristicId = args[1] as String;
+    final entries = args[2] as List<Object?>;
+    for (var i = 0; i + 1 < entries.length; i += 2) {
+      _updateCharacteristicValueMicros(
+        deviceId,
+        characteristicId,
+        entries[i + 1] as Uint8List,
+        entries[i] as int?,
+      );
+    }
+    return null;
+  }
+
+  Future<Object?> _onMtuChanged(Object? message) async {
+    final args = message as List<Object?>;
+    updateMtu(args[0] as String, args[1] as int);
+    return null;
+  }
+
+  Future<ByteData?> _onValueChangedBinary(ByteData? message) async {
+    if (message == null) return null;
+    var offset = 0;
+    String readString() {
+      final length = message.getUint16(offset, Endian.little);
+      offset += 2;
+      final value = utf8.decode(
+        message.buffer.asUint8List(message.offsetInBytes + offset, length),
+      );
+      offset += length;
+      return value;
+    }
+
+    while (offset < message.lengthInBytes) {
+      final kind = message.getUint8(offset);
+      final id = message.getUint32(offset + 1, Endian.little);
+      offset += 5;
+      switch (kind) {
+        case 0:
+          final deviceId = readString();
+          final characteristicId = readString();
+          _binarySubscriptions[id] = (deviceId, characteristicId);
+        case 1:
+          final timestampMicros = message.getInt64(offset, Endian.little);
+          final length = message.getUint32(offset + 8, Endian.little);
+          offset += 12;
+          final value = Uint8List.fromList(
+            message.buffer.asUint8List(message.offsetInBytes + offset, length),
+          );
+          offset += length;
+          final subscription = _binarySubscriptions[id];
+          if (subscription != null) {
+            _updateCharacteristicValueMicros(
+              subscription.$1,
+              subscription.$2,
+              value,
+              timestampMicros,
+            );
+          }
+        case 2:
+          _binarySubscriptions.remove(id);
+        default:
+          return null;
+      }
+    }
+    return null;
+  }
 
   @override
   void onPairStateChange(String deviceId, bool isPaired, String? error) =>
@@ -67,8 +67,9 @@ class UniversalBleWeb extends UniversalBlePlatform {
   @override
   Future<List<BleService>> discoverServices(
     String deviceId,
-    bool withDescriptors,
-  ) async {
+    bool withDescriptors, {
+    Duration? timeout,
+  }) async {
     List<BleService> services = [];
     for (var service in await _getServices(deviceId)) {
       services.add(await service._toBleService(deviceId, withDescriptors));
@@ -170,8 +171,9 @@ class UniversalBleWeb extends UniversalBlePlatform {
     String deviceId,
     String service,
     String characteristic,
-    BleInputProperty bleInputProperty,
-  ) async {
+    BleInputProperty bleInputProperty, {
+    Duration? timeout,
+  }) async {
     UniversalLogger.logDebug(
       "SET_NOTIFY -> $deviceId $service $characteristic input=${bleInputProperty.name}",
       withTimestamp: true,
@@ -227,8 +229,9 @@ class UniversalBleWeb extends UniversalBlePlatform {
     String service,
     String characteristic,
     Uint8List value,
-    BleOutputProperty bleOutputProperty,
-  ) async {
+    BleOutputProperty bleOutputProperty, {
+    Duration? timeout,
+  }) async {
     UniversalLogger.logDebug(
       "WRITE -> $deviceId $service $characteristic len=${value.length} property=${bleOutputProperty.name}",
       withTimestamp: true,
@@ -24,6 +24,8 @@ typedef OnPairingStateChange = void Function(String deviceId, bool isPaired);
 typedef OnConnectionParametersChange =
     void Function(BleConnectionParametersUpdated update);
 
+typedef OnMtuChange = void Function(String deviceId, int mtu);
+
 typedef OnQueueUpdate = void Function(String id, int remainingQueueItems);
 
 /// Peripheral mode callbacks
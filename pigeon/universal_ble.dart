@@ -397,22 +397,31 @@ abstract class UniversalBlePlatformChannel {
 
   void disconnect(String deviceId);
 
+  /// A positive [timeoutMs] bounds the whole call, including an on-demand
+  /// discovery, instead of the native default (Windows only).
   @async
   void setNotifiable(
     String deviceId,
     String service,
     String characteristic,
-    BleInputProperty bleInputProperty,
-  );
+    BleInputProperty bleInputProperty, {
+    int? timeoutMs,
+  });
 
   @async
   List<UniversalBleService> discoverServices(
     String deviceId,
-    bool withDescriptors,
-  );
+    bool withDescriptors, {
+    int? timeoutMs,
+  });
 
   @async
-  Uint8List readValue(String deviceId, String service, String characteristic);
+  Uint8List readValue(
+    String deviceId,
+    String service,
+    String characteristic, {
+    int? timeoutMs,
+  });
 
   @async
   int requestMtu(String deviceId, int expectedMtu);
@@ -423,8 +432,9 @@ abstract class UniversalBlePlatformChannel {
     String service,
     String characteristic,
     Uint8List value,
-    BleOutputProperty bleOutputProperty,
-  );
+    BleOutputProperty bleOutputProperty, {
+    int? timeoutMs,
+  });
 
   @async
   bool isPaired(String deviceId);
@@ -448,7 +458,10 @@ abstract class UniversalBlePlatformChannel {
     BleConnectionPriority priority,
   );
 
-  void setLogLevel(BleLogLevel logLevel);
+  /// With a [category] (`BleLogCategory.index`), only that native area
+  /// changes. Categories are Windows only; other platforms ignore such
+  /// calls.
+  void setLogLevel(BleLogLevel logLevel, {int? category});
 }
 
 /// Native -> Flutter (central)
@@ -88,13 +88,15 @@ class _UniversalBleMock extends UniversalBlePlatformMock {
 
   @override
   Future<List<BleService>> discoverServices(
-      String deviceId, bool withDescriptors) async {
+      String deviceId, bool withDescriptors,
+      {Duration? timeout}) async {
     return <BleService>[mockBleService];
   }
 
   @override
   Future<void> setNotifiable(String deviceId, String service,
-      String characteristic, BleInputProperty bleInputProperty) async {
+      String characteristic, BleInputProperty bleInputProperty,
+      {Duration? timeout}) async {
     if (bleInputProperty == BleInputProperty.disabled) {
       notifierTimer?.cancel();
       notifierTimer = null;
@@ -117,7 +119,8 @@ class _UniversalBleMock extends UniversalBlePlatformMock {
       String service,
       String characteristic,
       Uint8List value,
-      BleOutputProperty bleOutputProperty) async {
+      BleOutputProperty bleOutputProperty,
+      {Duration? timeout}) async {
     charValue = value;
   }
 
@@ -25,8 +25,9 @@ abstract class UniversalBlePlatformMock extends UniversalBlePlatform {
   @override
   Future<List<BleService>> discoverServices(
     String deviceId,
-    bool withDescriptors,
-  ) {
+    bool withDescriptors, {
+    Duration? timeout,
+  }) {
     throw UnimplementedError();
   }
 
@@ -88,8 +89,9 @@ abstract class UniversalBlePlatformMock extends UniversalBlePlatform {
     String deviceId,
     String service,
     String characteristic,
-    BleInputProperty bleInputProperty,
-  ) {
+    BleInputProperty bleInputProperty, {
+    Duration? timeout,
+  }) {
     throw UnimplementedError();
   }
 
@@ -117,8 +119,9 @@ abstract class UniversalBlePlatformMock extends UniversalBlePlatform {
     String service,
     String characteristic,
     Uint8List value,
-    BleOutputProperty bleOutputProperty,
-  ) {
+    BleOutputProperty bleOutputProperty, {
+    Duration? timeout,
+  }) {
     throw UnimplementedError();
   }
 
@@ -0,0 +1,159 @@
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:universal_ble/src/universal_ble.g.dart';
+
+// Golden messages as sent by the Windows plugin. They were produced by the
+// generated C++ codec (universal_ble.g.cpp) and the direct writer
+// (windows/src/universal_ble_message_writer.cpp), which emit identical bytes.
+// windows/test/message_writer_test.cpp checks both encoders against the
+// same bytes; update the two files together.
+
+const _deviceId = 'AA:BB:CC:DD:EE:FF';
+const _characteristicId = '00002a37-0000-1000-8000-00805f9b34fb';
+
+// onScanResult with every field set.
+const _fullScanResult = <int>[
+  0x0c, 0x01, 0x90, 0x0c, 0x08, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, //
+  0x3a, 0x43, 0x43, 0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46,
+  0x07, 0x06, 0x53, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x02, 0x04, 0xc4, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0c, 0x02, 0x99, 0x0c, 0x02, 0x04,
+  0x4c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x03, 0x01, 0x02,
+  0x03, 0x99, 0x0c, 0x02, 0x04, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x08, 0x01, 0xaa, 0x0d, 0x01, 0x07, 0x24, 0x30, 0x30, 0x30, 0x30,
+  0x31, 0x38, 0x30, 0x66, 0x2d, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x31, 0x30,
+  0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30, 0x30, 0x38, 0x30,
+  0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x08, 0x01, 0x64, 0x0c,
+  0x01, 0x07, 0x24, 0x30, 0x30, 0x30, 0x30, 0x31, 0x38, 0x30, 0x64, 0x2d,
+  0x30, 0x30, 0x30, 0x30, 0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30,
+  0x30, 0x30, 0x2d, 0x30, 0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33,
+  0x34, 0x66, 0x62, 0x04, 0x00, 0x68, 0xe5, 0xcf, 0x8b, 0x01, 0x00, 0x00,
+];
+
+// onScanResult with only the device id.
+const _minimalScanResult = <int>[
+  0x0c, 0x01, 0x90, 0x0c, 0x08, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, //
+  0x3a, 0x43, 0x43, 0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+];
+
+// onValueChanged with a 20 byte payload 0..19.
+const _valueChanged20 = <int>[
+  0x0c, 0x04, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, 0x3a, 0x43, 0x43, //
+  0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46, 0x07, 0x24, 0x30,
+  0x30, 0x30, 0x30, 0x32, 0x61, 0x33, 0x37, 0x2d, 0x30, 0x30, 0x30, 0x30,
+  0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30,
+  0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x08,
+  0x14, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+  0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x04, 0x7b, 0x68,
+  0xe5, 0xcf, 0x8b, 0x01, 0x00, 0x00,
+];
+
+// onValueChanged up to the 512 byte payload, whose size needs the 0xfe
+// two-byte form. Followed by the payload (i % 256) and a null timestamp.
+const _valueChanged512Head = <int>[
+  0x0c, 0x04, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, 0x3a, 0x43, 0x43, //
+  0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46, 0x07, 0x24, 0x30,
+  0x30, 0x30, 0x30, 0x32, 0x61, 0x33, 0x37, 0x2d, 0x30, 0x30, 0x30, 0x30,
+  0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30,
+  0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x08,
+  0xfe, 0x00, 0x02,
+];
+
+// universal_ble/value_changed_batch with two notifications.
+const _valueChangedBatch = <int>[
+  0x0c, 0x03, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, 0x3a, 0x43, 0x43, //
+  0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46, 0x07, 0x24, 0x30,
+  0x30, 0x30, 0x30, 0x32, 0x61, 0x33, 0x37, 0x2d, 0x30, 0x30, 0x30, 0x30,
+  0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30,
+  0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x0c,
+  0x04, 0x04, 0x78, 0x20, 0x20, 0x18, 0x24, 0x0a, 0x06, 0x00, 0x08, 0x02,
+  0x01, 0x02, 0x04, 0x60, 0x24, 0x20, 0x18, 0x24, 0x0a, 0x06, 0x00, 0x08,
+  0x01, 0x03,
+];
+
+ByteData _message(List<int> bytes) =>
+    Uint8List.fromList(bytes).buffer.asByteData();
+
+List<Object?> _decodeCallback(List<int> bytes) =>
+    UniversalBleCallbackChannel.pigeonChannelCodec.decodeMessage(
+          _message(bytes),
+        )
+        as List<Object?>;
+
+void main() {
+  group('Windows callback message conformance', () {
+    test('decodes a scan result with every field', () {
+      final args = _decodeCallback(_fullScanResult);
+      expect(args, hasLength(1));
+      final result = args.single as UniversalBleScanResult;
+      expect(result.deviceId, _deviceId);
+      expect(result.name, 'Sensor');
+      expect(result.isPaired, isFalse);
+      expect(result.rssi, -60);
+      expect(result.manufacturerDataList, hasLength(2));
+      expect(result.manufacturerDataList![0].companyIdentifier, 0x004C);
+      expect(result.manufacturerDataList![0].data, [1, 2, 3]);
+      expect(result.manufacturerDataList![1].companyIdentifier, 0x0059);
+      expect(result.manufacturerDataList![1].data, [0xAA]);
+      expect(result.serviceData, {
+        '0000180f-0000-1000-8000-00805f9b34fb': Uint8List.fromList([0x64]),
+      });
+      expect(result.services, ['0000180d-0000-1000-8000-00805f9b34fb']);
+      expect(result.timestamp, 1700000000000);
+    });
+
+    test('decodes a scan result with only a device id', () {
+      final result =
+          _decodeCallback(_minimalScanResult).single as UniversalBleScanResult;
+      expect(result.deviceId, _deviceId);
+      expect(result.name, isNull);
+      expect(result.isPaired, isNull);
+      expect(result.rssi, isNull);
+      expect(result.manufacturerDataList, isNull);
+      expect(result.serviceData, isNull);
+      expect(result.services, isNull);
+      expect(result.timestamp, isNull);
+    });
+
+    test('decodes a 20 byte notification', () {
+      final args = _decodeCallback(_valueChanged20);
+      expect(args, [
+        _deviceId,
+        _characteristicId,
+        Uint8List.fromList(List<int>.generate(20, (i) => i)),
+        1700000000123,
+      ]);
+    });
+
+    test('decodes a 512 byte notification with a two-byte size', () {
+      final payload = List<int>.generate(512, (i) => i % 256);
+      final args = _decodeCallback([..._valueChanged512Head, ...payload, 0x00]);
+      expect(args, [
+        _deviceId,
+        _characteristicId,
+        Uint8List.fromList(payload),
+        null,
+      ]);
+    });
+
+    test('decodes a notification batch', () {
+      final args =
+          const StandardMessageCodec().decodeMessage(
+                _message(_valueChangedBatch),
+              )
+              as List<Object?>;
+      expect(args, [
+        _deviceId,
+        _characteristicId,
+        [
+          1700000000123000,
+          Uint8List.fromList([1, 2]),
+          1700000000124000,
+          Uint8List.fromList([3]),
+        ],
+      ]);
+    });
+  });
+}
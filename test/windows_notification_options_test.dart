@@ -0,0 +1,278 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:flutter/foundation.dart';
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:universal_ble/src/universal_ble.g.dart';
+import 'package:universal_ble/src/universal_ble_pigeon/universal_ble_pigeon_channel.dart';
+import 'package:universal_ble/universal_ble.dart';
+
+// Drives the Windows-only channels through the test binary messenger, so
+// the messages are encoded and decoded the way the plugin sees them.
+
+const _deviceId = 'AA:BB:CC:DD:EE:FF';
+const _serviceId = '0000180d-0000-1000-8000-00805f9b34fb';
+const _characteristicId = '00002a37-0000-1000-8000-00805f9b34fb';
+
+const _gattChannel = MethodChannel('universal_ble/gatt');
+
+const _dispatcherStatsChannel = BasicMessageChannel<Object?>(
+  'universal_ble/dispatcher_stats',
+  StandardMessageCodec(),
+);
+
+TestDefaultBinaryMessenger get _messenger =>
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger;
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  setUp(() {
+    debugDefaultTargetPlatformOverride = TargetPlatform.windows;
+  });
+
+  tearDown(() {
+    debugDefaultTargetPlatformOverride = null;
+    _messenger.setMockMethodCallHandler(_gattChannel, null);
+  });
+
+  group('Windows notification options', () {
+    test('sends every option to the plugin', () async {
+      final calls = <MethodCall>[];
+      _messenger.setMockMethodCallHandler(_gattChannel, (call) async {
+        calls.add(call);
+        return null;
+      });
+
+      await UniversalBle.setWindowsNotificationOptions(
+        _deviceId,
+        '180d',
+        '2a37',
+        const WindowsNotificationOptions(
+          transport: WindowsNotificationTransport.binary,
+          batch: true,
+          batchMaxEntries: 16,
+          batchMaxDelay: Duration(milliseconds: 4),
+          bufferCapacity: 64,
+          backpressurePolicy: WindowsBackpressurePolicy.blockProducer,
+          maxBlock: Duration(milliseconds: 20),
+          framing: WindowsFraming.lengthPrefix,
+          frameCheck: WindowsFrameCheck.crc16Ccitt,
+          maxFrameSize: 1024,
+          lengthPrefixSize: 4,
+          lengthPrefixBigEndian: true,
+          lengthIncludesPrefix: true,
+          filter: WindowsNotificationFilter.rateLimit,
+          filterMaxRateHz: 30,
+          filterEveryNth: 3,
+        ),
+      );
+
+      expect(calls, hasLength(1));
+      expect(calls.single.method, 'setNotificationOptions');
+      expect(calls.single.arguments, {
+        'deviceId': _deviceId,
+        'service': _serviceId,
+        'characteristic': _characteristicId,
+        'transport': 1,
+        'batch': true,
+        'batchMaxEntries': 16,
+        'batchMaxDelayMs': 4,
+        'bufferCapacity': 64,
+        'backpressurePolicy': 2,
+        'maxBlockMs': 20,
+        'framing': 1,
+        'frameCheck': 1,
+        'maxFrameSize': 1024,
+        'lengthPrefixSize': 4,
+        'lengthPrefixBigEndian': true,
+        'lengthIncludesPrefix': true,
+        'filter': 2,
+        'filterMaxRateHz': 30.0,
+        'filterEveryNth': 3,
+      });
+    });
+
+    test('delivers a notification batch value by value', () async {
+      final channel = UniversalBlePigeonChannel.instance;
+      final events = <BleCharacteristicValue>[];
+      final subscription = channel
+          .characteristicValueEventStream(_deviceId, _characteristicId)
+          .listen(events.add);
+
+      await _messenger.handlePlatformMessage(
+        'universal_ble/value_changed_batch',
+        const StandardMessageCodec().encodeMessage([
+          _deviceId,
+          _characteristicId,
+          [
+            1700000000123456,
+            Uint8List.fromList([1, 2]),
+            1700000000124789,
+            Uint8List.fromList([3]),
+          ],
+        ]),
+        (_) {},
+      );
+      await Future<void>.delayed(Duration.zero);
+
+      expect(events.map((e) => e.value), [
+        Uint8List.fromList([1, 2]),
+        Uint8List.fromList([3]),
+      ]);
+      expect(events.map((e) => e.timestampMicros), [
+        1700000000123456,
+        1700000000124789,
+      ]);
+      await subscription.cancel();
+    });
+
+    test('sends a log category with the pigeon setLogLevel', () async {
+      final setLogLevelChannel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.universal_ble.UniversalBlePlatformChannel.setLogLevel',
+        UniversalBlePlatformChannel.pigeonChannelCodec,
+      );
+      final calls = <Object?>[];
+      _messenger.setMockDecodedMessageHandler<Object?>(setLogLevelChannel, (
+        message,
+      ) async {
+        calls.add(message);
+        return <Object?>[null];
+      });
+
+      final channel = UniversalBlePigeonChannel.instance;
+      await channel.setLogLevel(
+        BleLogLevel.verbose,
+        category: BleLogCategory.pairing,
+      );
+      await channel.setLogLevel(BleLogLevel.info);
+
+      expect(calls, [
+        [BleLogLevel.verbose, BleLogCategory.pairing.index],
+        [BleLogLevel.info, null],
+      ]);
+      _messenger.setMockDecodedMessageHandler<Object?>(
+        setLogLevelChannel,
+        null,
+      );
+    });
+
+    test('sends a GATT timeout with the pigeon readValue', () async {
+      final readValueChannel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.universal_ble.UniversalBlePlatformChannel.readValue',
+        UniversalBlePlatformChannel.pigeonChannelCodec,
+      );
+      final calls = <Object?>[];
+      _messenger.setMockDecodedMessageHandler<Object?>(readValueChannel, (
+        message,
+      ) async {
+        calls.add(message);
+        return <Object?>[
+          Uint8List.fromList([7]),
+        ];
+      });
+
+      final channel = UniversalBlePigeonChannel.instance;
+      final value = await channel.readValue(
+        _deviceId,
+        _serviceId,
+        _characteristicId,
+        timeout: const Duration(milliseconds: 250),
+      );
+      await channel.readValue(_deviceId, _serviceId, _characteristicId);
+
+      expect(value, Uint8List.fromList([7]));
+      expect(calls, [
+        [_deviceId, _serviceId, _characteristicId, 250],
+        [_deviceId, _serviceId, _characteristicId, null],
+      ]);
+      _messenger.setMockDecodedMessageHandler<Object?>(readValueChannel, null);
+    });
+
+    test('reads notification buffer stats per characteristic', () async {
+      _messenger.setMockDecodedMessageHandler<Object?>(
+        _dispatcherStatsChannel,
+        (message) async => {
+          'depth': 0,
+          'notification_buffers': {
+            _deviceId: {
+              _characteristicId: {'dropped': 12, 'high_water': 256},
+            },
+          },
+        },
+      );
+
+      final stats = await UniversalBle.getNotificationBufferStats();
+
+      expect(stats, {
+        _deviceId: {_characteristicId: (dropped: 12, highWater: 256)},
+      });
+      _messenger.setMockDecodedMessageHandler<Object?>(
+        _dispatcherStatsChannel,
+        null,
+      );
+    });
+
+    test('delivers binary frames of a subscription', () async {
+      final channel = UniversalBlePigeonChannel.instance;
+      final events = <BleCharacteristicValue>[];
+      final subscription = channel
+          .characteristicValueEventStream(_deviceId, _characteristicId)
+          .listen(events.add);
+
+      // subscribe 7, value [1, 2], value [3], unsubscribe 7, value [4]
+      // which is dropped; layout in universal_ble_notification_codec.h.
+      final frames = BytesBuilder()
+        ..add(_subscribeFrame(7, _deviceId, _characteristicId))
+        ..add(_valueFrame(7, 1700000000123456, [1, 2]))
+        ..add(_valueFrame(7, 1700000000124789, [3]))
+        ..add([2, 7, 0, 0, 0])
+        ..add(_valueFrame(7, 1700000000125000, [4]));
+      await _messenger.handlePlatformMessage(
+        'universal_ble/value_changed_binary',
+        frames.toBytes().buffer.asByteData(),
+        (_) {},
+      );
+      await Future<void>.delayed(Duration.zero);
+
+      expect(events.map((e) => e.value), [
+        Uint8List.fromList([1, 2]),
+        Uint8List.fromList([3]),
+      ]);
+      expect(events.map((e) => e.timestampMicros), [
+        1700000000123456,
+        1700000000124789,
+      ]);
+      await subscription.cancel();
+    });
+  });
+}
+
+Uint8List _subscribeFrame(int id, String deviceId, String characteristicId) {
+  final header = ByteData(5)
+    ..setUint8(0, 0)
+    ..setUint32(1, id, Endian.little);
+  final builder = BytesBuilder()..add(header.buffer.asUint8List());
+  for (final value in [deviceId, characteristicId]) {
+    final bytes = utf8.encode(value);
+    builder
+      ..add((ByteData(2)..setUint16(0, bytes.length, Endian.little))
+          .buffer
+          .asUint8List())
+      ..add(bytes);
+  }
+  return builder.toBytes();
+}
+
+Uint8List _valueFrame(int id, int timestampMicros, List<int> value) {
+  final header = ByteData(17)
+    ..setUint8(0, 1)
+    ..setUint32(1, id, Endian.little)
+    ..setInt64(5, timestampMicros, Endian.little)
+    ..setUint32(13, value.length, Endian.little);
+  return (BytesBuilder()
+        ..add(header.buffer.asUint8List())
+        ..add(value))
+      .toBytes();
+}
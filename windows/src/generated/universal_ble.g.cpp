@@ -2574,7 +2574,10 @@ void UniversalBlePlatformChannel::SetUp(
             return;
           }
           const auto& ble_input_property_arg = std::any_cast<const BleInputProperty&>(std::get<CustomEncodableValue>(encodable_ble_input_property_arg));
-          api->SetNotifiable(device_id_arg, service_arg, characteristic_arg, ble_input_property_arg, [reply](std::optional<FlutterError>&& output) {
+          const auto& encodable_timeout_ms_arg = args.at(4);
+          const int64_t timeout_ms_arg_value = encodable_timeout_ms_arg.IsNull() ? 0 : encodable_timeout_ms_arg.LongValue();
+          const auto* timeout_ms_arg = encodable_timeout_ms_arg.IsNull() ? nullptr : &timeout_ms_arg_value;
+          api->SetNotifiable(device_id_arg, service_arg, characteristic_arg, ble_input_property_arg, timeout_ms_arg, [reply](std::optional<FlutterError>&& output) {
             if (output.has_value()) {
               reply(WrapError(output.value()));
               return;
@@ -2609,7 +2612,10 @@ void UniversalBlePlatformChannel::SetUp(
             return;
           }
           const auto& with_descriptors_arg = std::get<bool>(encodable_with_descriptors_arg);
-          api->DiscoverServices(device_id_arg, with_descriptors_arg, [reply](ErrorOr<EncodableList>&& output) {
+          const auto& encodable_timeout_ms_arg = args.at(2);
+          const int64_t timeout_ms_arg_value = encodable_timeout_ms_arg.IsNull() ? 0 : encodable_timeout_ms_arg.LongValue();
+          const auto* timeout_ms_arg = encodable_timeout_ms_arg.IsNull() ? nullptr : &timeout_ms_arg_value;
+          api->DiscoverServices(device_id_arg, with_descriptors_arg, timeout_ms_arg, [reply](ErrorOr<EncodableList>&& output) {
             if (output.has_error()) {
               reply(WrapError(output.error()));
               return;
@@ -2650,7 +2656,10 @@ void UniversalBlePlatformChannel::SetUp(
             return;
           }
           const auto& characteristic_arg = std::get<std::string>(encodable_characteristic_arg);
-          api->ReadValue(device_id_arg, service_arg, characteristic_arg, [reply](ErrorOr<std::vector<uint8_t>>&& output) {
+          const auto& encodable_timeout_ms_arg = args.at(3);
+          const int64_t timeout_ms_arg_value = encodable_timeout_ms_arg.IsNull() ? 0 : encodable_timeout_ms_arg.LongValue();
+          const auto* timeout_ms_arg = encodable_timeout_ms_arg.IsNull() ? nullptr : &timeout_ms_arg_value;
+          api->ReadValue(device_id_arg, service_arg, characteristic_arg, timeout_ms_arg, [reply](ErrorOr<std::vector<uint8_t>>&& output) {
             if (output.has_error()) {
               reply(WrapError(output.error()));
               return;
@@ -2738,7 +2747,10 @@ void UniversalBlePlatformChannel::SetUp(
             return;
           }
           const auto& ble_output_property_arg = std::any_cast<const BleOutputProperty&>(std::get<CustomEncodableValue>(encodable_ble_output_property_arg));
-          api->WriteValue(device_id_arg, service_arg, characteristic_arg, value_arg, ble_output_property_arg, [reply](std::optional<FlutterError>&& output) {
+          const auto& encodable_timeout_ms_arg = args.at(5);
+          const int64_t timeout_ms_arg_value = encodable_timeout_ms_arg.IsNull() ? 0 : encodable_timeout_ms_arg.LongValue();
+          const auto* timeout_ms_arg = encodable_timeout_ms_arg.IsNull() ? nullptr : &timeout_ms_arg_value;
+          api->WriteValue(device_id_arg, service_arg, characteristic_arg, value_arg, ble_output_property_arg, timeout_ms_arg, [reply](std::optional<FlutterError>&& output) {
             if (output.has_value()) {
               reply(WrapError(output.value()));
               return;
@@ -2974,7 +2986,10 @@ void UniversalBlePlatformChannel::SetUp(
             return;
           }
           const auto& log_level_arg = std::any_cast<const BleLogLevel&>(std::get<CustomEncodableValue>(encodable_log_level_arg));
-          std::optional<FlutterError> output = api->SetLogLevel(log_level_arg);
+          const auto& encodable_category_arg = args.at(1);
+          const int64_t category_arg_value = encodable_category_arg.IsNull() ? 0 : encodable_category_arg.LongValue();
+          const auto* category_arg = encodable_category_arg.IsNull() ? nullptr : &category_arg_value;
+          std::optional<FlutterError> output = api->SetLogLevel(log_level_arg, category_arg);
           if (output.has_value()) {
             reply(WrapError(output.value()));
             return;
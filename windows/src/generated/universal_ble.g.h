@@ -1165,20 +1165,25 @@ class UniversalBlePlatformChannel {
     const bool* auto_connect,
     const ConnectionPlatformConfig* platform_config) = 0;
   virtual std::optional<FlutterError> Disconnect(const std::string& device_id) = 0;
+  // A positive [timeoutMs] bounds the whole call, including an on-demand
+  // discovery, instead of the native default (Windows only).
   virtual void SetNotifiable(
     const std::string& device_id,
     const std::string& service,
     const std::string& characteristic,
     const BleInputProperty& ble_input_property,
+    const int64_t* timeout_ms,
     std::function<void(std::optional<FlutterError> reply)> result) = 0;
   virtual void DiscoverServices(
     const std::string& device_id,
     bool with_descriptors,
+    const int64_t* timeout_ms,
     std::function<void(ErrorOr<::flutter::EncodableList> reply)> result) = 0;
   virtual void ReadValue(
     const std::string& device_id,
     const std::string& service,
     const std::string& characteristic,
+    const int64_t* timeout_ms,
     std::function<void(ErrorOr<std::vector<uint8_t>> reply)> result) = 0;
   virtual void RequestMtu(
     const std::string& device_id,
@@ -1190,6 +1195,7 @@ class UniversalBlePlatformChannel {
     const std::string& characteristic,
     const std::vector<uint8_t>& value,
     const BleOutputProperty& ble_output_property,
+    const int64_t* timeout_ms,
     std::function<void(std::optional<FlutterError> reply)> result) = 0;
   virtual void IsPaired(
     const std::string& device_id,
@@ -1209,7 +1215,12 @@ class UniversalBlePlatformChannel {
     const std::string& device_id,
     const BleConnectionPriority& priority,
     std::function<void(std::optional<FlutterError> reply)> result) = 0;
-  virtual std::optional<FlutterError> SetLogLevel(const BleLogLevel& log_level) = 0;
+  // With a [category] (`BleLogCategory.index`), only that native area
+  // changes. Categories are Windows only; other platforms ignore such
+  // calls.
+  virtual std::optional<FlutterError> SetLogLevel(
+    const BleLogLevel& log_level,
+    const int64_t* category) = 0;
 
   // The codec used by UniversalBlePlatformChannel.
   static const ::flutter::StandardMessageCodec& GetCodec();
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace universal_ble {
+
+/// Owned bytes with IBuffer's capacity/length model, used as the storage
+/// of buffers made by make_buffer (universal_ble_winrt_buffer.h).
+///
+/// Capacity is the allocated size and length the valid prefix; a consumer
+/// may write into data() and then set_length. Platform independent.
+class ByteBuffer {
+public:
+  ByteBuffer() = default;
+  // Adopts `bytes` without copying; the whole vector is valid.
+  explicit ByteBuffer(std::vector<uint8_t> &&bytes)
+      : bytes_(std::move(bytes)),
+        length_(static_cast<uint32_t>(bytes_.size())) {}
+  explicit ByteBuffer(std::span<const uint8_t> bytes)
+      : bytes_(bytes.begin(), bytes.end()),
+        length_(static_cast<uint32_t>(bytes_.size())) {}
+
+  static ByteBuffer WithCapacity(uint32_t capacity) {
+    ByteBuffer buffer;
+    buffer.bytes_.resize(capacity);
+    return buffer;
+  }
+
+  uint32_t capacity() const { return static_cast<uint32_t>(bytes_.size()); }
+  uint32_t length() const { return length_; }
+  // Fails, leaving the length unchanged, if `length` exceeds capacity().
+  bool set_length(uint32_t length) {
+    if (length > capacity()) {
+      return false;
+    }
+    length_ = length;
+    return true;
+  }
+
+  uint8_t *data() { return bytes_.data(); }
+  std::span<const uint8_t> span() const { return {bytes_.data(), length_}; }
+
+  // Moves the valid bytes out, leaving the buffer empty.
+  std::vector<uint8_t> Release() {
+    bytes_.resize(length_);
+    length_ = 0;
+    return std::exchange(bytes_, {});
+  }
+
+private:
+  std::vector<uint8_t> bytes_;
+  uint32_t length_ = 0;
+};
+
+} // namespace universal_ble
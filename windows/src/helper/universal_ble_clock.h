@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace universal_ble {
+
+/// Event timestamps in microseconds since the Unix epoch, read from the
+/// monotonic clock (QueryPerformanceCounter on Windows).
+///
+/// The offset to wall time is taken once, so timestamps line up with
+/// Dart's DateTime but never jump when NTP adjusts the system clock.
+class UniversalBleClock {
+public:
+  static int64_t NowMicros() { return ToMicros(std::chrono::steady_clock::now()); }
+
+  static int64_t ToMicros(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               time.time_since_epoch())
+               .count() +
+           WallOffsetMicros();
+  }
+
+  static int64_t ToMillis(int64_t micros) { return micros / 1000; }
+
+private:
+  static int64_t WallOffsetMicros() {
+    static const int64_t offset = [] {
+      using std::chrono::duration_cast;
+      using std::chrono::microseconds;
+      return duration_cast<microseconds>(
+                 std::chrono::system_clock::now().time_since_epoch())
+                 .count() -
+             duration_cast<microseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+                 .count();
+    }();
+    return offset;
+  }
+};
+
+} // namespace universal_ble
@@ -0,0 +1,83 @@
+#include "universal_ble_latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace universal_ble {
+
+void LatencyHistogram::Record(const int64_t micros) {
+  const uint64_t value = micros < 0 ? 0 : static_cast<uint64_t>(micros);
+  buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  int64_t current = max_.load(std::memory_order_relaxed);
+  while (static_cast<int64_t>(value) > current &&
+         !max_.compare_exchange_weak(current, static_cast<int64_t>(value),
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::count() const {
+  uint64_t total = 0;
+  for (const auto &bucket : buckets_) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+int64_t LatencyHistogram::Percentile(const double percentile) const {
+  const uint64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  const auto rank = static_cast<uint64_t>(
+      std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * total));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= std::max<uint64_t>(rank, 1)) {
+      // The last bucket also holds everything beyond the range.
+      if (i == kBucketCount - 1) {
+        return max();
+      }
+      return std::min(BucketUpperBound(i), max());
+    }
+  }
+  return max();
+}
+
+std::string LatencyHistogram::Summary() const {
+  return "n=" + std::to_string(count()) +
+         " p50=" + std::to_string(Percentile(50)) +
+         "us p90=" + std::to_string(Percentile(90)) +
+         "us p99=" + std::to_string(Percentile(99)) +
+         "us p999=" + std::to_string(Percentile(99.9)) +
+         "us max=" + std::to_string(max()) + "us";
+}
+
+size_t LatencyHistogram::BucketIndex(const uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  // Exponent 1 covers [16, 32) in steps of 1, exponent 2 [32, 64) in steps
+  // of 2, and so on.
+  const int exponent = static_cast<int>(std::bit_width(value)) - kSubBucketBits;
+  if (exponent > kExponents) {
+    return kBucketCount - 1;
+  }
+  const auto sub_bucket =
+      static_cast<size_t>((value >> (exponent - 1)) & (kSubBuckets - 1));
+  return static_cast<size_t>(exponent) * kSubBuckets + sub_bucket;
+}
+
+int64_t LatencyHistogram::BucketUpperBound(const size_t index) {
+  const size_t exponent = index / kSubBuckets;
+  const size_t sub_bucket = index % kSubBuckets;
+  if (exponent == 0) {
+    return static_cast<int64_t>(sub_bucket);
+  }
+  return static_cast<int64_t>(((kSubBuckets + sub_bucket + 1)
+                               << (exponent - 1)) -
+                              1);
+}
+
+} // namespace universal_ble
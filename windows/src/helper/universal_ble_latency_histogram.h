@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace universal_ble {
+
+/// Lock-free latency histogram in microseconds with HDR-style log-linear
+/// buckets: 16 linear sub-buckets per power of two, so any reported
+/// percentile is within ~6% of the recorded value. Covers 0us to ~1 hour;
+/// percentiles that fall beyond it report max().
+class LatencyHistogram {
+public:
+  void Record(int64_t micros);
+
+  uint64_t count() const;
+  int64_t max() const { return max_.load(std::memory_order_relaxed); }
+  // Upper bound of the bucket holding the `percentile` (0-100) sample.
+  int64_t Percentile(double percentile) const;
+  // "n=... p50=...us p90=...us p99=...us p999=...us max=...us"
+  std::string Summary() const;
+
+private:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kExponents = 32 - kSubBucketBits;
+  static constexpr size_t kBucketCount = (kExponents + 1) * kSubBuckets;
+
+  static size_t BucketIndex(uint64_t value);
+  static int64_t BucketUpperBound(size_t index);
+
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<int64_t> max_{0};
+};
+
+} // namespace universal_ble
@@ -0,0 +1,247 @@
+#include "universal_ble_log_writer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <system_error>
+
+#include "universal_ble_clock.h"
+
+namespace universal_ble {
+
+UniversalBleLogWriter::UniversalBleLogWriter(std::filesystem::path path,
+                                             const uintmax_t max_file_bytes,
+                                             const int max_files)
+    : path_(std::move(path)), max_file_bytes_(max_file_bytes),
+      max_files_(max_files < 1 ? 1 : max_files), thread_([this] { Run(); }) {
+  UniversalBleLogger::SetWriterAttached(true);
+}
+
+UniversalBleLogWriter::~UniversalBleLogWriter() {
+  // Lines logged from here on go to the console synchronously; the final
+  // Drain picks up everything queued before the switch.
+  UniversalBleLogger::SetWriterAttached(false);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  UniversalBleLogger::WakeWriter();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void UniversalBleLogWriter::SetForwardSink(ForwardSink sink) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_forward_sink_ =
+        sink ? std::make_shared<const ForwardSink>(std::move(sink)) : nullptr;
+  }
+  UniversalBleLogger::WakeWriter();
+}
+
+void UniversalBleLogWriter::Run() {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        break;
+      }
+    }
+    Drain();
+    // Only a pending forward batch needs a timed wake-up.
+    UniversalBleLogger::WaitForRecords(
+        forward_batch_.empty()
+            ? std::chrono::steady_clock::time_point::max()
+            : last_forward_ + kForwardInterval);
+  }
+  Drain();
+}
+
+void UniversalBleLogWriter::Drain() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (forward_sink_ != pending_forward_sink_) {
+      forward_sink_ = pending_forward_sink_;
+      forward_batch_.clear();
+      last_forward_ = std::chrono::steady_clock::now();
+    }
+  }
+  while (UniversalBleLogger::TryPopRecord(
+      [this](const LogRecord &record) { Append(record); })) {
+  }
+  const uint64_t dropped = UniversalBleLogger::dropped_records();
+  if (dropped != reported_dropped_) {
+    LogRecord notice{};
+    notice.micros = UniversalBleClock::NowMicros();
+    notice.category = LogCategory::kGeneral;
+    notice.level = BleLogLevel::kWarning;
+    const int length =
+        std::snprintf(notice.text, LogRecord::kTextCapacity,
+                      "log ring full, dropped %llu records",
+                      static_cast<unsigned long long>(dropped -
+                                                      reported_dropped_));
+    notice.length = static_cast<uint16_t>(length > 0 ? length : 0);
+    reported_dropped_ = dropped;
+    Append(notice);
+  }
+  if (!file_buffer_.empty()) {
+    WriteFile();
+    file_buffer_.clear();
+  }
+  if (rotation_notice_) {
+    Append(*rotation_notice_);
+    rotation_notice_.reset();
+    WriteFile();
+    file_buffer_.clear();
+  }
+  if (!console_buffer_.empty()) {
+    std::cout << console_buffer_ << std::flush;
+    console_buffer_.clear();
+  }
+  Forward(false);
+}
+
+void UniversalBleLogWriter::Forward(const bool flush) {
+  if (forward_sink_ == nullptr || forward_batch_.empty()) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (!flush && now - last_forward_ < kForwardInterval) {
+    return;
+  }
+  last_forward_ = now;
+  (*forward_sink_)(std::move(forward_batch_));
+  forward_batch_.clear();
+}
+
+void UniversalBleLogWriter::Append(const LogRecord &record) {
+  const char *tag = UniversalBleLogger::LevelTag(record.level);
+  const char *truncated = record.truncated ? "..." : "";
+
+  console_buffer_ += "UniversalBle:";
+  console_buffer_ += tag;
+  console_buffer_ += ' ';
+  if (record.timestamped) {
+    console_buffer_ += '[';
+    AppendTimestamp(console_buffer_, record.micros, false);
+    console_buffer_ += "] ";
+  }
+  console_buffer_.append(record.text, record.length);
+  console_buffer_ += truncated;
+  console_buffer_ += '\n';
+
+  AppendTimestamp(file_buffer_, record.micros, true);
+  file_buffer_ += ' ';
+  file_buffer_ += tag;
+  file_buffer_ += ' ';
+  file_buffer_ += UniversalBleLogger::CategoryName(record.category);
+  file_buffer_ += ": ";
+  file_buffer_.append(record.text, record.length);
+  file_buffer_ += truncated;
+  file_buffer_ += '\n';
+
+  if (forward_sink_ != nullptr) {
+    std::string message(record.text, record.length);
+    message += truncated;
+    forward_batch_.push_back(ForwardedLog{record.micros, record.level,
+                                          record.category, std::move(message)});
+    if (forward_batch_.size() >= kMaxForwardBatch) {
+      Forward(true);
+    }
+  }
+}
+
+void UniversalBleLogWriter::AppendTimestamp(std::string &line,
+                                            const int64_t micros,
+                                            const bool with_date) {
+  const auto second = static_cast<std::time_t>(micros / 1000000);
+  if (second != cached_second_) {
+    std::tm timeinfo;
+    localtime_s(&timeinfo, &second);
+    std::strftime(cached_time_, sizeof(cached_time_), "%Y-%m-%d %H:%M:%S",
+                  &timeinfo);
+    cached_second_ = second;
+  }
+  const auto millis = static_cast<int>((micros / 1000) % 1000);
+  // cached_time_ is "YYYY-MM-DD HH:MM:SS"; the time starts at 11.
+  line += with_date ? cached_time_ : cached_time_ + 11;
+  line += '.';
+  line += static_cast<char>('0' + millis / 100);
+  line += static_cast<char>('0' + millis / 10 % 10);
+  line += static_cast<char>('0' + millis % 10);
+}
+
+void UniversalBleLogWriter::WriteFile() {
+  if (file_failed_) {
+    return;
+  }
+  if (!file_.is_open()) {
+    std::error_code error;
+    std::filesystem::create_directories(path_.parent_path(), error);
+    file_bytes_ = std::filesystem::file_size(path_, error);
+    if (error) {
+      file_bytes_ = 0;
+    }
+    file_.open(path_, std::ios::binary | std::ios::app);
+    if (!file_) {
+      // Console output still works; do not retry every drain.
+      file_failed_ = true;
+      return;
+    }
+  }
+  file_.write(file_buffer_.data(),
+              static_cast<std::streamsize>(file_buffer_.size()));
+  file_.flush();
+  file_bytes_ += file_buffer_.size();
+  if (file_bytes_ >= max_file_bytes_) {
+    Rotate();
+  }
+}
+
+void UniversalBleLogWriter::Rotate() {
+  file_.close();
+  file_bytes_ = 0;
+  const auto rotated = [this](int index) {
+    auto name = path_.stem();
+    name += "." + std::to_string(index);
+    name += path_.extension();
+    return path_.parent_path() / name;
+  };
+  // Older files may legitimately be missing; only moving the active file
+  // out of the way has to succeed.
+  std::error_code error;
+  if (max_files_ == 1) {
+    std::filesystem::remove(path_, error);
+  } else {
+    std::error_code ignored;
+    std::filesystem::remove(rotated(max_files_ - 1), ignored);
+    for (int index = max_files_ - 2; index >= 1; --index) {
+      std::filesystem::rename(rotated(index), rotated(index + 1), ignored);
+    }
+    std::filesystem::rename(path_, rotated(1), error);
+  }
+  if (!error) {
+    // Reopened by the next WriteFile.
+    return;
+  }
+  file_.open(path_, std::ios::binary | std::ios::trunc);
+  if (!file_) {
+    file_failed_ = true;
+  }
+  LogRecord notice{};
+  notice.micros = UniversalBleClock::NowMicros();
+  notice.category = LogCategory::kGeneral;
+  notice.level = BleLogLevel::kWarning;
+  const int length = std::snprintf(
+      notice.text, LogRecord::kTextCapacity,
+      file_failed_ ? "log rotation failed (%s), file logging stopped"
+                   : "log rotation failed (%s), log file truncated",
+      error.message().c_str());
+  notice.length = static_cast<uint16_t>(
+      std::clamp(length, 0, static_cast<int>(LogRecord::kTextCapacity) - 1));
+  // file_buffer_ is still being written; Drain appends this afterwards.
+  rotation_notice_ = notice;
+}
+
+} // namespace universal_ble
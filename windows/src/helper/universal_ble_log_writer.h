@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "universal_ble_logger.h"
+
+namespace universal_ble {
+
+/// A log record handed to a forwarding sink.
+struct ForwardedLog {
+  int64_t micros;
+  BleLogLevel level;
+  LogCategory category;
+  std::string message;
+};
+
+/// Background thread that drains UniversalBleLogger's record ring to the
+/// console and to a size-rotated log file.
+///
+/// Attaches itself to the logger for its lifetime, so producers only pay
+/// for a copy into the ring. The thread sleeps until a record arrives (see
+/// UniversalBleLogger::WaitForRecords) and drains whatever piled up since.
+/// The file is opened on the first record; once it reaches
+/// `max_file_bytes` it becomes `<stem>.1<ext>`, older files shift up and
+/// anything past `max_files` is deleted. `path` should be private to the
+/// app: if the rename fails anyway, e.g. because another process has the
+/// file open, the file is truncated in place and a warning is logged.
+class UniversalBleLogWriter {
+public:
+  static constexpr uintmax_t kDefaultMaxFileBytes = 2 * 1024 * 1024;
+  static constexpr int kDefaultMaxFiles = 3;
+
+  explicit UniversalBleLogWriter(
+      std::filesystem::path path,
+      uintmax_t max_file_bytes = kDefaultMaxFileBytes,
+      int max_files = kDefaultMaxFiles);
+  ~UniversalBleLogWriter();
+
+  UniversalBleLogWriter(const UniversalBleLogWriter &) = delete;
+  UniversalBleLogWriter &operator=(const UniversalBleLogWriter &) = delete;
+
+  using ForwardSink = std::function<void(std::vector<ForwardedLog> batch)>;
+
+  /// Also hands records to `sink`, on the writer thread, in batches sent
+  /// every kForwardInterval or once kMaxForwardBatch records are pending.
+  /// A null sink stops forwarding and discards the pending batch.
+  void SetForwardSink(ForwardSink sink);
+
+private:
+  static constexpr std::chrono::milliseconds kForwardInterval{250};
+  static constexpr size_t kMaxForwardBatch = 512;
+
+  void Run();
+  void Drain();
+  void Append(const LogRecord &record);
+  void Forward(bool flush);
+  void AppendTimestamp(std::string &line, int64_t micros, bool with_date);
+  void WriteFile();
+  void Rotate();
+
+  std::filesystem::path path_;
+  uintmax_t max_file_bytes_;
+  int max_files_;
+
+  // Writer thread only.
+  std::ofstream file_;
+  uintmax_t file_bytes_ = 0;
+  bool file_failed_ = false;
+  std::optional<LogRecord> rotation_notice_;
+  std::string console_buffer_;
+  std::string file_buffer_;
+  uint64_t reported_dropped_ = 0;
+  std::shared_ptr<const ForwardSink> forward_sink_;
+  std::vector<ForwardedLog> forward_batch_;
+  std::chrono::steady_clock::time_point last_forward_;
+  // Formatted "YYYY-MM-DD HH:MM:SS" for cached_second_, so localtime runs
+  // at most once per second.
+  std::time_t cached_second_ = -1;
+  char cached_time_[20] = {};
+
+  std::mutex mutex_;
+  bool stopping_ = false;
+  // Guarded by mutex_; the writer thread takes a copy on each drain.
+  std::shared_ptr<const ForwardSink> pending_forward_sink_;
+  std::thread thread_;
+};
+
+} // namespace universal_ble
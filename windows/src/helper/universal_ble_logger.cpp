@@ -1,11 +1,22 @@
 #include "universal_ble_logger.h"
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 
+#include "universal_ble_clock.h"
+
 namespace universal_ble {
 
-BleLogLevel UniversalBleLogger::current_level_ = BleLogLevel::kNone;
+std::atomic<uint32_t> UniversalBleLogger::levels_{0};
+std::atomic<bool> UniversalBleLogger::writer_attached_{false};
+std::atomic<uint64_t> UniversalBleLogger::dropped_records_{0};
+MpscRing<LogRecord, 512> UniversalBleLogger::records_;
+std::atomic<bool> UniversalBleLogger::writer_sleeping_{false};
+std::mutex UniversalBleLogger::wake_mutex_;
+std::condition_variable UniversalBleLogger::wake_condition_;
+bool UniversalBleLogger::wake_requested_ = false;
 
 static std::string GetCurrentTimestampString() {
   auto now = std::chrono::system_clock::now();
@@ -24,60 +35,171 @@ static std::string GetCurrentTimestampString() {
 }
 
 void UniversalBleLogger::SetLogLevel(BleLogLevel level) {
-  current_level_ = level;
+  uint32_t levels = 0;
+  for (size_t i = 0; i < kLogCategoryCount; ++i) {
+    levels |= static_cast<uint32_t>(level)
+              << LevelShift(static_cast<LogCategory>(i));
+  }
+  levels_.store(levels, std::memory_order_relaxed);
+}
+
+void UniversalBleLogger::SetLogLevel(LogCategory category, BleLogLevel level) {
+  const uint32_t shift = LevelShift(category);
+  const uint32_t value = static_cast<uint32_t>(level) << shift;
+  uint32_t levels = levels_.load(std::memory_order_relaxed);
+  while (!levels_.compare_exchange_weak(
+      levels, (levels & ~(kLevelMask << shift)) | value,
+      std::memory_order_relaxed)) {
+  }
 }
 
 BleLogLevel UniversalBleLogger::current_log_level() {
-  return current_level_;
+  return log_level(LogCategory::kGeneral);
+}
+
+BleLogLevel UniversalBleLogger::log_level(LogCategory category) {
+  return static_cast<BleLogLevel>(
+      (levels_.load(std::memory_order_relaxed) >> LevelShift(category)) &
+      kLevelMask);
+}
+
+void UniversalBleLogger::SetWriterAttached(bool attached) {
+  writer_attached_.store(attached, std::memory_order_release);
+}
+
+void UniversalBleLogger::WaitForRecords(
+    const std::chrono::steady_clock::time_point deadline) {
+  // Announce the sleep before looking at the ring; Log publishes its record
+  // before looking at the flag, so one of the two sees the other.
+  writer_sleeping_.store(true, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+  if (!wake_requested_ && !records_.HasReady()) {
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+      wake_condition_.wait(lock, [] { return wake_requested_; });
+    } else {
+      wake_condition_.wait_until(lock, deadline,
+                                 [] { return wake_requested_; });
+    }
+  }
+  wake_requested_ = false;
+  writer_sleeping_.store(false, std::memory_order_relaxed);
+}
+
+void UniversalBleLogger::WakeWriter() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_requested_ = true;
+  }
+  wake_condition_.notify_all();
+}
+
+const char *UniversalBleLogger::LevelTag(BleLogLevel level) {
+  switch (level) {
+  case BleLogLevel::kError:
+    return "ERROR";
+  case BleLogLevel::kWarning:
+    return "WARN";
+  case BleLogLevel::kInfo:
+    return "INFO";
+  case BleLogLevel::kDebug:
+    return "DEBUG";
+  case BleLogLevel::kVerbose:
+    return "VERBOSE";
+  default:
+    return "NONE";
+  }
+}
+
+const char *UniversalBleLogger::CategoryName(LogCategory category) {
+  switch (category) {
+  case LogCategory::kScan:
+    return "scan";
+  case LogCategory::kGatt:
+    return "gatt";
+  case LogCategory::kNotify:
+    return "notify";
+  case LogCategory::kPeripheral:
+    return "peripheral";
+  case LogCategory::kPairing:
+    return "pairing";
+  default:
+    return "general";
+  }
+}
+
+void UniversalBleLogger::Log(LogCategory category, BleLogLevel level,
+                             bool timestamped, const std::string &message) {
+  if (writer_attached_.load(std::memory_order_acquire)) {
+    const auto micros = UniversalBleClock::NowMicros();
+    const bool pushed = records_.TryPush([&](LogRecord &record) {
+      const size_t length =
+          std::min(message.size(), LogRecord::kTextCapacity);
+      record.micros = micros;
+      record.category = category;
+      record.level = level;
+      record.timestamped = timestamped;
+      record.truncated = length < message.size();
+      record.length = static_cast<uint16_t>(length);
+      std::memcpy(record.text, message.data(), length);
+    });
+    if (!pushed) {
+      dropped_records_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writer_sleeping_.load(std::memory_order_relaxed) &&
+        writer_sleeping_.exchange(false, std::memory_order_relaxed)) {
+      WakeWriter();
+    }
+    return;
+  }
+  std::cout << "UniversalBle:" << LevelTag(level) << " ";
+  if (timestamped) {
+    std::cout << GetCurrentTimestampString() << " ";
+  }
+  std::cout << message << std::endl;
 }
 
 void UniversalBleLogger::LogError(const std::string &message) {
-  if (!Allows(BleLogLevel::kError))
+  if (!Allows(LogCategory::kGeneral, BleLogLevel::kError))
     return;
-  std::cout << "UniversalBle:ERROR " << message << std::endl;
+  Log(LogCategory::kGeneral, BleLogLevel::kError, false, message);
 }
 
 void UniversalBleLogger::LogWarning(const std::string &message) {
-  if (!Allows(BleLogLevel::kWarning))
+  if (!Allows(LogCategory::kGeneral, BleLogLevel::kWarning))
     return;
-  std::cout << "UniversalBle:WARN " << message << std::endl;
+  Log(LogCategory::kGeneral, BleLogLevel::kWarning, false, message);
 }
 
 void UniversalBleLogger::LogInfo(const std::string &message) {
-  if (!Allows(BleLogLevel::kInfo))
+  if (!Allows(LogCategory::kGeneral, BleLogLevel::kInfo))
     return;
-  std::cout << "UniversalBle:INFO " << message << std::endl;
+  Log(LogCategory::kGeneral, BleLogLevel::kInfo, false, message);
 }
 
 void UniversalBleLogger::LogDebug(const std::string &message) {
-  if (!Allows(BleLogLevel::kDebug))
+  if (!Allows(LogCategory::kGeneral, BleLogLevel::kDebug))
     return;
-  std::cout << "UniversalBle:DEBUG " << message << std::endl;
+  Log(LogCategory::kGeneral, BleLogLevel::kDebug, false, message);
 }
 
 void UniversalBleLogger::LogVerbose(const std::string &message) {
-  if (!Allows(BleLogLevel::kVerbose))
+  if (!Allows(LogCategory::kGeneral, BleLogLevel::kVerbose))
     return;
-  std::cout << "UniversalBle:VERBOSE " << message << std::endl;
+  Log(LogCategory::kGeneral, BleLogLevel::kVerbose, false, message);
 }
 
 void UniversalBleLogger::LogDebugWithTimestamp(const std::string &message) {
-  if (!Allows(BleLogLevel::kDebug))
+  if (!Allows(LogCategory::kGeneral, BleLogLevel::kDebug))
     return;
-  std::cout << "UniversalBle:DEBUG " << GetCurrentTimestampString() << " " << message
-            << std::endl;
+  Log(LogCategory::kGeneral, BleLogLevel::kDebug, true, message);
 }
 
 void UniversalBleLogger::LogVerboseWithTimestamp(const std::string &message) {
-  if (!Allows(BleLogLevel::kVerbose))
+  if (!Allows(LogCategory::kGeneral, BleLogLevel::kVerbose))
     return;
-  std::cout << "UniversalBle:VERBOSE " << GetCurrentTimestampString() << " "
-            << message << std::endl;
-}
-
-bool UniversalBleLogger::Allows(BleLogLevel level) {
-  return current_level_ != BleLogLevel::kNone &&
-         static_cast<int>(level) <= static_cast<int>(current_level_);
+  Log(LogCategory::kGeneral, BleLogLevel::kVerbose, true, message);
 }
 
 } // namespace universal_ble
@@ -1,17 +1,106 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <utility>
 
 #include "../generated/universal_ble.g.h"
+#include "universal_ble_mpsc_ring.h"
+
+// Highest BleLogLevel (as int) that is compiled in at all; sites above it
+// are removed by the UNIVERSAL_BLE_LOG_* macros. Release builds keep error,
+// warning and info. Override with a compile definition.
+#ifndef UNIVERSAL_BLE_LOG_COMPILED_LEVEL
+#ifdef NDEBUG
+#define UNIVERSAL_BLE_LOG_COMPILED_LEVEL 3 // BleLogLevel::kInfo
+#else
+#define UNIVERSAL_BLE_LOG_COMPILED_LEVEL 5 // BleLogLevel::kVerbose
+#endif
+#endif
+
+// Logs `message` in LogCategory::`category`, e.g.
+// UNIVERSAL_BLE_LOG_DEBUG(kGatt, "READ -> " + device_id). The message is
+// evaluated only if `level` is compiled in and currently enabled for the
+// category, so call sites can build strings freely. Expands to a single
+// if/else statement; safe inside an unbraced if.
+#define UNIVERSAL_BLE_LOG_AT(category, level, timestamped, message)            \
+  if constexpr (static_cast<int>(level) > UNIVERSAL_BLE_LOG_COMPILED_LEVEL) {  \
+  } else if (!::universal_ble::UniversalBleLogger::Allows(                     \
+                 ::universal_ble::LogCategory::category, level)) {             \
+  } else                                                                       \
+    ::universal_ble::UniversalBleLogger::Log(                                  \
+        ::universal_ble::LogCategory::category, level, timestamped, message)
+
+#define UNIVERSAL_BLE_LOG_ERROR(category, message)                             \
+  UNIVERSAL_BLE_LOG_AT(category, ::universal_ble::BleLogLevel::kError, false,  \
+                       message)
+#define UNIVERSAL_BLE_LOG_WARNING(category, message)                           \
+  UNIVERSAL_BLE_LOG_AT(category, ::universal_ble::BleLogLevel::kWarning,       \
+                       false, message)
+#define UNIVERSAL_BLE_LOG_INFO(category, message)                              \
+  UNIVERSAL_BLE_LOG_AT(category, ::universal_ble::BleLogLevel::kInfo, false,   \
+                       message)
+#define UNIVERSAL_BLE_LOG_DEBUG(category, message)                             \
+  UNIVERSAL_BLE_LOG_AT(category, ::universal_ble::BleLogLevel::kDebug, false,  \
+                       message)
+#define UNIVERSAL_BLE_LOG_VERBOSE(category, message)                           \
+  UNIVERSAL_BLE_LOG_AT(category, ::universal_ble::BleLogLevel::kVerbose,       \
+                       false, message)
+#define UNIVERSAL_BLE_LOG_DEBUG_TS(category, message)                          \
+  UNIVERSAL_BLE_LOG_AT(category, ::universal_ble::BleLogLevel::kDebug, true,   \
+                       message)
+#define UNIVERSAL_BLE_LOG_VERBOSE_TS(category, message)                        \
+  UNIVERSAL_BLE_LOG_AT(category, ::universal_ble::BleLogLevel::kVerbose, true, \
+                       message)
 
 namespace universal_ble {
 
+/// Log areas with independent levels. kGeneral covers connection, radio
+/// and state handling. Keep in sync with BleLogCategory in
+/// lib/src/models/ble_log_category.dart.
+enum class LogCategory : uint8_t {
+  kGeneral = 0,
+  kScan = 1,
+  kGatt = 2,
+  kNotify = 3,
+  kPeripheral = 4,
+  kPairing = 5,
+};
+constexpr size_t kLogCategoryCount = 6;
+
+/// One log line queued for UniversalBleLogWriter. Longer messages are cut
+/// at kTextCapacity and flagged.
+struct LogRecord {
+  static constexpr size_t kTextCapacity = 480;
+
+  int64_t micros;
+  LogCategory category;
+  BleLogLevel level;
+  // Whether the console line carries a timestamp, as the *WithTimestamp
+  // variants do synchronously. File lines always do.
+  bool timestamped;
+  bool truncated;
+  uint16_t length;
+  char text[kTextCapacity];
+};
+
 class UniversalBleLogger {
 public:
+  // Sets every category.
   static void SetLogLevel(BleLogLevel level);
+  static void SetLogLevel(LogCategory category, BleLogLevel level);
+  // Level of kGeneral.
   static BleLogLevel current_log_level();
+  static BleLogLevel log_level(LogCategory category);
 
+  // Prefer the UNIVERSAL_BLE_LOG_* macros, which skip building the message.
+  // These log in kGeneral.
   static void LogError(const std::string &message);
   static void LogWarning(const std::string &message);
   static void LogInfo(const std::string &message);
@@ -19,10 +108,54 @@ public:
   static void LogVerbose(const std::string &message);
   static void LogDebugWithTimestamp(const std::string &message);
   static void LogVerboseWithTimestamp(const std::string &message);
+  // Unchecked; the caller has tested Allows(category, level).
+  static void Log(LogCategory category, BleLogLevel level, bool timestamped,
+                  const std::string &message);
+
+  // While a writer is attached, Log* only copy the message into a lock-free
+  // ring and the writer thread formats and outputs it. Otherwise they write
+  // to std::cout synchronously. Records that do not fit are dropped and
+  // counted.
+  static void SetWriterAttached(bool attached);
+  static uint64_t dropped_records() {
+    return dropped_records_.load(std::memory_order_relaxed);
+  }
+  // Writer thread only.
+  template <typename Consume> static bool TryPopRecord(Consume &&consume) {
+    return records_.TryPop(std::forward<Consume>(consume));
+  }
+  // Writer thread only: returns once a record is queued, WakeWriter is
+  // called or `deadline` passes. Log signals only the first record after
+  // the writer went to sleep, so a busy writer costs producers no syscall.
+  static void WaitForRecords(std::chrono::steady_clock::time_point deadline);
+  static void WakeWriter();
+  static const char *LevelTag(BleLogLevel level);
+  static const char *CategoryName(LogCategory category);
+
+  static bool Allows(LogCategory category, BleLogLevel level) {
+    // kNone is 0, so nothing passes while a category is off.
+    return static_cast<uint32_t>(level) <=
+           ((levels_.load(std::memory_order_relaxed) >>
+             LevelShift(category)) &
+            kLevelMask);
+  }
 
 private:
-  static BleLogLevel current_level_;
-  static bool Allows(BleLogLevel level);
+  static constexpr uint32_t kLevelMask = 0xF;
+  static constexpr uint32_t LevelShift(LogCategory category) {
+    return 4 * static_cast<uint32_t>(category);
+  }
+
+  // One 4-bit BleLogLevel per LogCategory, so Allows is a single load.
+  static std::atomic<uint32_t> levels_;
+  static std::atomic<bool> writer_attached_;
+  static std::atomic<uint64_t> dropped_records_;
+  static MpscRing<LogRecord, 512> records_;
+  static std::atomic<bool> writer_sleeping_;
+  static std::mutex wake_mutex_;
+  static std::condition_variable wake_condition_;
+  // Guarded by wake_mutex_.
+  static bool wake_requested_;
 };
 
 } // namespace universal_ble
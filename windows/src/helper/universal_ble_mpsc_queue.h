@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+
+namespace universal_ble {
+
+/// Intrusive lock-free multi-producer single-consumer queue (Vyukov).
+///
+/// `Node` must be default-constructible and expose `std::atomic<Node *>
+/// next`. Push never blocks or allocates; Pop must only be called from the
+/// consumer thread and may return nullptr while a concurrent Push is half
+/// done, in which case the caller retries later.
+template <typename Node> class MpscQueue {
+public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {
+    stub_.next.store(nullptr, std::memory_order_relaxed);
+  }
+
+  MpscQueue(const MpscQueue &) = delete;
+  MpscQueue &operator=(const MpscQueue &) = delete;
+
+  void Push(Node *node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  Node *Pop() {
+    Node *tail = tail_;
+    Node *next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      // A producer has swapped head_ but not linked its node yet.
+      return nullptr;
+    }
+    Push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+private:
+  Node stub_;
+  std::atomic<Node *> head_;
+  Node *tail_;
+};
+
+} // namespace universal_ble
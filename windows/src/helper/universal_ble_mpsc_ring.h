@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace universal_ble {
+
+/// Bounded lock-free multi-producer single-consumer ring (Vyukov).
+///
+/// Slots are preallocated, so producers never allocate or block: TryPush
+/// fills a slot in place and fails when the ring is full. TryPop must only
+/// be called from the consumer thread. `Capacity` must be a power of two.
+template <typename T, size_t Capacity> class MpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  MpscRing() {
+    for (size_t i = 0; i < Capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRing(const MpscRing &) = delete;
+  MpscRing &operator=(const MpscRing &) = delete;
+
+  // Calls `fill(T &)` on a reserved slot. Returns false if the ring is full.
+  template <typename Fill> bool TryPush(Fill &&fill) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[position & (Capacity - 1)];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    fill(cell->value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Calls `consume(const T &)` on the oldest published slot, then frees it.
+  // Returns false if nothing is ready.
+  template <typename Consume> bool TryPop(Consume &&consume) {
+    Cell &cell = cells_[dequeue_position_ & (Capacity - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) !=
+        dequeue_position_ + 1) {
+      return false;
+    }
+    consume(static_cast<const T &>(cell.value));
+    cell.sequence.store(dequeue_position_ + Capacity,
+                        std::memory_order_release);
+    ++dequeue_position_;
+    return true;
+  }
+
+  // Whether TryPop would find a slot. Consumer thread only.
+  bool HasReady() const {
+    return cells_[dequeue_position_ & (Capacity - 1)].sequence.load(
+               std::memory_order_acquire) == dequeue_position_ + 1;
+  }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::array<Cell, Capacity> cells_;
+  alignas(64) std::atomic<size_t> enqueue_position_{0};
+  alignas(64) size_t dequeue_position_ = 0;
+};
+
+} // namespace universal_ble
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace universal_ble {
+
+/// kBlockCount blocks of kBlockSize bytes carved from one slab, handed out
+/// from any thread. When all are in use, Allocate falls back to the heap and
+/// Release returns such blocks to it.
+///
+/// Blocks are typically allocated on the WinRT callback threads and
+/// released on the UI thread, so the free list is a lock-free stack rather
+/// than a per-thread cache. Its head packs a block index with a tag that
+/// every change bumps, which stops a stale compare-exchange from succeeding
+/// after the head was popped and pushed again (ABA).
+template <size_t BlockSize, size_t BlockCount> class BlockPool {
+public:
+  static constexpr size_t kBlockSize = BlockSize;
+  static constexpr size_t kBlockCount = BlockCount;
+  static_assert(kBlockSize % alignof(std::max_align_t) == 0,
+                "blocks must stay max_align_t aligned");
+  static_assert(kBlockCount > 0 &&
+                kBlockCount < std::numeric_limits<uint32_t>::max());
+
+  BlockPool() {
+    slab_ = static_cast<unsigned char *>(
+        ::operator new(kBlockSize * kBlockCount,
+                       std::align_val_t{alignof(std::max_align_t)}));
+    for (uint32_t i = 0; i < kBlockCount; ++i) {
+      next_[i].store(i + 1 < kBlockCount ? i + 1 : kEmpty,
+                     std::memory_order_relaxed);
+    }
+    head_.store(0, std::memory_order_release);
+  }
+  ~BlockPool() {
+    ::operator delete(slab_, std::align_val_t{alignof(std::max_align_t)});
+  }
+
+  BlockPool(const BlockPool &) = delete;
+  BlockPool &operator=(const BlockPool &) = delete;
+
+  void *Allocate() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (;;) {
+      const uint32_t top = static_cast<uint32_t>(head);
+      if (top == kEmpty) {
+        return ::operator new(kBlockSize,
+                              std::align_val_t{alignof(std::max_align_t)});
+      }
+      const uint32_t next = next_[top].load(std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(head, Retag(head, next),
+                                      std::memory_order_acquire,
+                                      std::memory_order_acquire)) {
+        return slab_ + top * kBlockSize;
+      }
+    }
+  }
+
+  void Release(void *block) {
+    const auto address = reinterpret_cast<uintptr_t>(block);
+    const auto slab = reinterpret_cast<uintptr_t>(slab_);
+    if (address < slab || address >= slab + kBlockSize * kBlockCount) {
+      ::operator delete(block, std::align_val_t{alignof(std::max_align_t)});
+      return;
+    }
+    const auto index = static_cast<uint32_t>((address - slab) / kBlockSize);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    do {
+      next_[index].store(static_cast<uint32_t>(head),
+                         std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, Retag(head, index),
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+  // Head with `top` as its index and the next tag.
+  static uint64_t Retag(const uint64_t head, const uint32_t top) {
+    return (((head >> 32) + 1) << 32) | top;
+  }
+
+  unsigned char *slab_ = nullptr;
+  // Tag in the high half, index of the first free block in the low half.
+  std::atomic<uint64_t> head_{kEmpty};
+  std::array<std::atomic<uint32_t>, kBlockCount> next_{};
+};
+
+/// BlockPool sized for `T`: New constructs in a pooled block, Delete
+/// destroys and recycles it.
+template <typename T, size_t Count> class ObjectPool {
+public:
+  static_assert(alignof(T) <= alignof(std::max_align_t));
+
+  template <typename... Args> T *New(Args &&...args) {
+    void *block = blocks_.Allocate();
+    return new (block) T(std::forward<Args>(args)...);
+  }
+
+  void Delete(T *object) {
+    object->~T();
+    blocks_.Release(object);
+  }
+
+private:
+  static constexpr size_t kBlockSize =
+      (sizeof(T) + alignof(std::max_align_t) - 1) /
+      alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  BlockPool<kBlockSize, Count> blocks_;
+};
+
+/// Blocks for callables too large for UniversalBleTask's inline buffer
+/// (e.g. a captured UniversalBleScanResult), shared by every task.
+class TaskBlockPool {
+public:
+  static constexpr size_t kBlockSize = 512;
+  static constexpr size_t kBlockCount = 64;
+
+  static void *Allocate() { return Instance().Allocate(); }
+  static void Release(void *block) { Instance().Release(block); }
+
+private:
+  static BlockPool<kBlockSize, kBlockCount> &Instance() {
+    static BlockPool<kBlockSize, kBlockCount> pool;
+    return pool;
+  }
+};
+
+/// Move-only `void()` callable for UI-thread posts.
+///
+/// Unlike std::function it never copies its target, so lambdas can capture
+/// payloads by move (`[bytes = std::move(bytes)]`) and hand them on without
+/// a copy. Captures up to kInlineSize bytes live inside the task; larger
+/// ones use TaskBlockPool, and only oversized ones reach the heap.
+class UniversalBleTask {
+public:
+  static constexpr size_t kInlineSize = 64;
+
+  UniversalBleTask() = default;
+
+  template <typename F,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<F>, UniversalBleTask> &&
+                std::is_invocable_r_v<void, std::decay_t<F> &>>>
+  UniversalBleTask(F &&func) {
+    using Callable = std::decay_t<F>;
+    if constexpr (FitsInline<Callable>()) {
+      new (storage_) Callable(std::forward<F>(func));
+      ops_ = &kInlineOps<Callable>;
+    } else {
+      void *block = sizeof(Callable) <= TaskBlockPool::kBlockSize &&
+                            alignof(Callable) <= alignof(std::max_align_t)
+                        ? TaskBlockPool::Allocate()
+                        : nullptr;
+      if (block != nullptr) {
+        new (block) Callable(std::forward<F>(func));
+        ops_ = &kPooledOps<Callable>;
+      } else {
+        block = new Callable(std::forward<F>(func));
+        ops_ = &kHeapOps<Callable>;
+      }
+      *reinterpret_cast<void **>(storage_) = block;
+    }
+  }
+
+  UniversalBleTask(UniversalBleTask &&other) noexcept { MoveFrom(other); }
+
+  UniversalBleTask &operator=(UniversalBleTask &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  UniversalBleTask(const UniversalBleTask &) = delete;
+  UniversalBleTask &operator=(const UniversalBleTask &) = delete;
+
+  ~UniversalBleTask() { Reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void operator()() { ops_->invoke(storage_); }
+
+private:
+  struct Ops {
+    void (*invoke)(void *storage);
+    // Move-constructs into `to` and destroys `from`.
+    void (*relocate)(void *to, void *from);
+    void (*destroy)(void *storage);
+  };
+
+  template <typename Callable> static constexpr bool FitsInline() {
+    return sizeof(Callable) <= kInlineSize &&
+           alignof(Callable) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<Callable>;
+  }
+
+  template <typename Callable> static Callable *Outline(void *storage) {
+    return static_cast<Callable *>(*reinterpret_cast<void **>(storage));
+  }
+
+  template <typename Callable>
+  static constexpr Ops kInlineOps = {
+      [](void *storage) { (*static_cast<Callable *>(storage))(); },
+      [](void *to, void *from) {
+        new (to) Callable(std::move(*static_cast<Callable *>(from)));
+        static_cast<Callable *>(from)->~Callable();
+      },
+      [](void *storage) { static_cast<Callable *>(storage)->~Callable(); },
+  };
+
+  template <typename Callable>
+  static constexpr Ops kPooledOps = {
+      [](void *storage) { (*Outline<Callable>(storage))(); },
+      [](void *to, void *from) {
+        *reinterpret_cast<void **>(to) = *reinterpret_cast<void **>(from);
+      },
+      [](void *storage) {
+        Callable *callable = Outline<Callable>(storage);
+        callable->~Callable();
+        TaskBlockPool::Release(callable);
+      },
+  };
+
+  template <typename Callable>
+  static constexpr Ops kHeapOps = {
+      [](void *storage) { (*Outline<Callable>(storage))(); },
+      [](void *to, void *from) {
+        *reinterpret_cast<void **>(to) = *reinterpret_cast<void **>(from);
+      },
+      [](void *storage) { delete Outline<Callable>(storage); },
+  };
+
+  void MoveFrom(UniversalBleTask &other) noexcept {
+    if (other.ops_ != nullptr) {
+      other.ops_->relocate(storage_, other.storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  void Reset() {
+    if (ops_ != nullptr) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+  const Ops *ops_ = nullptr;
+};
+
+} // namespace universal_ble
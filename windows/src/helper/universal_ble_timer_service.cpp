@@ -0,0 +1,73 @@
+#include "universal_ble_timer_service.h"
+
+namespace universal_ble {
+
+UniversalBleTimerService::UniversalBleTimerService()
+    : thread_([this] { Run(); }) {}
+
+UniversalBleTimerService::~UniversalBleTimerService() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    timers_.clear();
+  }
+  condition_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+UniversalBleTimerService::TimerId
+UniversalBleTimerService::Schedule(std::chrono::milliseconds delay,
+                                   std::function<void()> callback) {
+  TimerId id;
+  bool is_earliest;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = next_id_++;
+    const auto it =
+        timers_.emplace(Clock::now() + delay, Entry{id, std::move(callback)});
+    is_earliest = it == timers_.begin();
+  }
+  // Only a new earliest deadline changes how long the timer thread sleeps.
+  if (is_earliest) {
+    condition_.notify_one();
+  }
+  return id;
+}
+
+bool UniversalBleTimerService::Cancel(const TimerId id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = timers_.begin(); it != timers_.end(); ++it) {
+    if (it->second.id == id) {
+      timers_.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void UniversalBleTimerService::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (timers_.empty()) {
+      condition_.wait(lock);
+      continue;
+    }
+    const auto deadline = timers_.begin()->first;
+    if (Clock::now() < deadline) {
+      condition_.wait_until(lock, deadline);
+      continue;
+    }
+    auto node = timers_.extract(timers_.begin());
+    // Run the callback unlocked so it can schedule or cancel other timers.
+    lock.unlock();
+    try {
+      node.mapped().callback();
+    } catch (...) {
+    }
+    lock.lock();
+  }
+}
+
+} // namespace universal_ble
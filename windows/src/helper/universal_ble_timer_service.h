@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace universal_ble {
+
+/// Single background thread that fires callbacks at their deadline.
+///
+/// Used to put an upper bound on WinRT async operations: the callback
+/// cancels the operation, so the awaiting coroutine resumes with a
+/// cancellation instead of waiting for the OS to give up on the link.
+class UniversalBleTimerService {
+public:
+  using Clock = std::chrono::steady_clock;
+  using TimerId = uint64_t;
+
+  UniversalBleTimerService();
+  ~UniversalBleTimerService();
+
+  UniversalBleTimerService(const UniversalBleTimerService &) = delete;
+  UniversalBleTimerService &operator=(const UniversalBleTimerService &) = delete;
+
+  /// Schedules `callback` to run on the timer thread after `delay`.
+  TimerId Schedule(std::chrono::milliseconds delay,
+                   std::function<void()> callback);
+
+  /// Removes a pending timer. Returns false if it already fired or was
+  /// never scheduled.
+  bool Cancel(TimerId id);
+
+private:
+  struct Entry {
+    TimerId id;
+    std::function<void()> callback;
+  };
+
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::multimap<Clock::time_point, Entry> timers_;
+  TimerId next_id_ = 1;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+/// Scoped deadline for one async operation.
+///
+/// `on_expired` runs on the timer thread if the scope is still alive when
+/// `timeout` elapses; it must only capture values it owns (e.g. the WinRT
+/// operation to cancel). Leaving the scope disarms the timer.
+class OperationDeadline {
+public:
+  OperationDeadline(UniversalBleTimerService &service,
+                    std::chrono::milliseconds timeout,
+                    std::function<void()> on_expired)
+      : service_(service), timeout_(timeout),
+        expired_(std::make_shared<std::atomic<bool>>(false)) {
+    id_ = service_.Schedule(
+        timeout, [expired = expired_, on_expired = std::move(on_expired)] {
+          expired->store(true);
+          on_expired();
+        });
+  }
+
+  ~OperationDeadline() { service_.Cancel(id_); }
+
+  OperationDeadline(const OperationDeadline &) = delete;
+  OperationDeadline &operator=(const OperationDeadline &) = delete;
+
+  bool expired() const { return expired_->load(); }
+  std::chrono::milliseconds timeout() const { return timeout_; }
+
+private:
+  UniversalBleTimerService &service_;
+  std::chrono::milliseconds timeout_;
+  std::shared_ptr<std::atomic<bool>> expired_;
+  UniversalBleTimerService::TimerId id_ = 0;
+};
+
+/// Time budget of a whole call that awaits several steps in turn, such as
+/// an on-demand discovery followed by a read: each step gets what is left.
+class CallDeadline {
+public:
+  explicit CallDeadline(std::chrono::milliseconds timeout)
+      : timeout_(timeout),
+        end_(UniversalBleTimerService::Clock::now() + timeout) {}
+
+  /// Zero once the budget is spent.
+  std::chrono::milliseconds remaining() const {
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        end_ - UniversalBleTimerService::Clock::now());
+    return std::max(left, std::chrono::milliseconds::zero());
+  }
+  std::chrono::milliseconds timeout() const { return timeout_; }
+
+private:
+  std::chrono::milliseconds timeout_;
+  UniversalBleTimerService::Clock::time_point end_;
+};
+
+} // namespace universal_ble
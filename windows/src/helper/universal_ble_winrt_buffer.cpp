@@ -0,0 +1,62 @@
+// Classic COM support in winrt::implements needs <unknwn.h> before any
+// C++/WinRT header.
+#include <unknwn.h>
+
+#include <robuffer.h>
+
+#include "universal_ble_winrt_buffer.h"
+
+#include <winrt/base.h>
+
+#include "universal_ble_byte_buffer.h"
+
+namespace universal_ble {
+
+using winrt::Windows::Storage::Streams::IBuffer;
+
+namespace {
+// IBuffer over a ByteBuffer. IBufferByteAccess lets WinRT APIs (and
+// buffer_span) reach the bytes directly instead of through a DataReader.
+struct OwnedBuffer
+    : winrt::implements<OwnedBuffer, IBuffer,
+                        ::Windows::Storage::Streams::IBufferByteAccess> {
+  explicit OwnedBuffer(ByteBuffer storage) : storage_(std::move(storage)) {}
+
+  uint32_t Capacity() const { return storage_.capacity(); }
+  uint32_t Length() const { return storage_.length(); }
+  void Length(const uint32_t value) {
+    if (!storage_.set_length(value)) {
+      throw winrt::hresult_invalid_argument();
+    }
+  }
+
+  HRESULT __stdcall Buffer(uint8_t **value) noexcept final {
+    *value = storage_.data();
+    return S_OK;
+  }
+
+private:
+  ByteBuffer storage_;
+};
+} // namespace
+
+std::span<const uint8_t> buffer_span(const IBuffer &buffer) {
+  if (!buffer) {
+    return {};
+  }
+  uint8_t *data = nullptr;
+  winrt::check_hresult(
+      buffer.as<::Windows::Storage::Streams::IBufferByteAccess>()->Buffer(
+          &data));
+  return {data, buffer.Length()};
+}
+
+IBuffer make_buffer(std::vector<uint8_t> &&bytes) {
+  return winrt::make<OwnedBuffer>(ByteBuffer(std::move(bytes)));
+}
+
+IBuffer make_buffer(std::span<const uint8_t> bytes) {
+  return winrt::make<OwnedBuffer>(ByteBuffer(bytes));
+}
+
+} // namespace universal_ble
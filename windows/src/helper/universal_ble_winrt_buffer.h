@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <winrt/Windows.Storage.Streams.h>
+
+namespace universal_ble {
+
+/// Views the bytes of `buffer` in place through IBufferByteAccess. The span
+/// is valid while `buffer` is alive and unmodified. Empty for a null buffer.
+std::span<const uint8_t>
+buffer_span(const winrt::Windows::Storage::Streams::IBuffer &buffer);
+
+/// Exposes `bytes` as an IBuffer without copying; the buffer owns them.
+winrt::Windows::Storage::Streams::IBuffer
+make_buffer(std::vector<uint8_t> &&bytes);
+
+/// Copies `bytes` once into a new IBuffer.
+winrt::Windows::Storage::Streams::IBuffer
+make_buffer(std::span<const uint8_t> bytes);
+
+} // namespace universal_ble
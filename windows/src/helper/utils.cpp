@@ -96,17 +96,13 @@ namespace universal_ble
 
     std::vector<uint8_t> to_bytevc(const IBuffer& buffer)
     {
-        auto reader = DataReader::FromBuffer(buffer);
-        auto result = std::vector<uint8_t>(reader.UnconsumedBufferLength());
-        reader.ReadBytes(result);
-        return result;
+        const auto bytes = buffer_span(buffer);
+        return std::vector<uint8_t>(bytes.begin(), bytes.end());
     }
 
     IBuffer from_bytevc(std::vector<uint8_t> bytes)
     {
-        auto writer = DataWriter();
-        writer.WriteBytes(bytes);
-        return writer.DetachBuffer();
+        return make_buffer(std::move(bytes));
     }
 
     std::string to_hexstring(const std::vector<uint8_t>& bytes)
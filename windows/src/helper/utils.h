@@ -11,8 +11,10 @@
 #include "universal_ble_base.h"
 #include "../generated/universal_ble.g.h"
 #include "universal_ble_logger.h"
+#include "universal_ble_winrt_buffer.h"
 
 constexpr uint32_t TEN_SECONDS_IN_MSECS = 10000;
+constexpr uint32_t THIRTY_SECONDS_IN_MSECS = 30000;
 
 namespace universal_ble
 {
@@ -23,7 +25,9 @@ namespace universal_ble
     guid uuid_to_guid(const std::string &uuid);
     std::string guid_to_uuid(const guid &guid);
 
+    // One copy out of the buffer; use buffer_span to read in place.
     std::vector<uint8_t> to_bytevc(const IBuffer& buffer);
+    // Wraps `bytes` without a further copy; pass an rvalue to avoid any.
     IBuffer from_bytevc(std::vector<uint8_t> bytes);
     std::string to_hexstring(const std::vector<uint8_t>& bytes);
 
@@ -66,11 +70,13 @@ namespace universal_ble
     }
 
     inline void log_and_swallow(const char* where, const std::exception& ex) {
-        UniversalBleLogger::LogError(std::string(where) + ": " + ex.what());
+        UNIVERSAL_BLE_LOG_ERROR(
+            kGeneral, std::string(where) + ": " + ex.what());
     }
 
     inline void log_and_swallow_unknown(const char* where) {
-        UniversalBleLogger::LogError(std::string(where) + ": unknown native exception");
+        UNIVERSAL_BLE_LOG_ERROR(
+            kGeneral, std::string(where) + ": unknown native exception");
     }
 
     /// To call async functions synchronously
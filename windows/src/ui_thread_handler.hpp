@@ -5,9 +5,68 @@
 #include <flutter/plugin_registrar_windows.h>
 
 #include <algorithm>
-#include <functional>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
-#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "helper/universal_ble_clock.h"
+#include "helper/universal_ble_latency_histogram.h"
+#include "helper/universal_ble_mpsc_queue.h"
+#include "helper/universal_ble_task.h"
+
+// Control callbacks (connection, pairing, availability, method results)
+// always run before bulk ones (scan results, notifications, forwarded
+// logs), so a state change never waits behind a data backlog. Order is kept
+// within a lane.
+enum class UiThreadLane
+{
+    kControl = 0,
+    kBulk = 1,
+};
+
+// What a posted callback does; picks its lane and tags its execution time.
+enum class UiCallbackKind
+{
+    kOther = 0,
+    kScan,
+    kNotify,
+    kConnection,
+    kPeripheral,
+    kLog,
+};
+
+inline constexpr size_t kUiCallbackKindCount = 6;
+
+inline const char *UiCallbackKindName(UiCallbackKind kind)
+{
+    switch (kind)
+    {
+    case UiCallbackKind::kScan:
+        return "scan";
+    case UiCallbackKind::kNotify:
+        return "notify";
+    case UiCallbackKind::kConnection:
+        return "connection";
+    case UiCallbackKind::kPeripheral:
+        return "peripheral";
+    case UiCallbackKind::kLog:
+        return "log";
+    default:
+        return "other";
+    }
+}
+
+inline UiThreadLane UiCallbackLane(UiCallbackKind kind)
+{
+    return kind == UiCallbackKind::kScan || kind == UiCallbackKind::kNotify ||
+                   kind == UiCallbackKind::kLog
+               ? UiThreadLane::kBulk
+               : UiThreadLane::kControl;
+}
 
 class UniversalBleUiThreadHandler
 {
@@ -25,55 +84,264 @@ public:
     ~UniversalBleUiThreadHandler()
     {
         registrar_->UnregisterTopLevelWindowProcDelegate(windowProcId_);
+        if (yielding_.load(std::memory_order_acquire))
+        {
+            KillTimer(hwnd_.load(std::memory_order_acquire), YieldTimerId());
+        }
+        // Whatever was never run is dropped.
+        for (Lane &lane : lanes_)
+        {
+            while (Task *task = lane.queue.Pop())
+            {
+                task_pool_.Delete(task);
+            }
+        }
     }
 
     UniversalBleUiThreadHandler(const UniversalBleUiThreadHandler &) = delete;
     UniversalBleUiThreadHandler &operator=(const UniversalBleUiThreadHandler &) = delete;
 
-    void Post(std::function<void()> &&func)
+    // Lock-free; only the post that makes the queue non-empty wakes the
+    // window, so a burst costs one PostMessage. A control callback also
+    // wakes it while bulk work is yielding. Lambdas convert implicitly;
+    // capture payloads by move, the task never copies them. Queue nodes
+    // come from task_pool_, so a post whose capture fits inline does not
+    // allocate while fewer than kTaskNodeCount tasks are pending.
+    void Post(universal_ble::UniversalBleTask &&func,
+              UiCallbackKind kind = UiCallbackKind::kOther)
+    {
+        Task *task = task_pool_.New(std::move(func));
+        task->kind = kind;
+        task->enqueued_micros = universal_ble::UniversalBleClock::NowMicros();
+        const UiThreadLane lane = UiCallbackLane(kind);
+        // Counted before it is visible, so Drain never pops an uncounted
+        // task and pending_ never goes below zero.
+        const int64_t previous = pending_.fetch_add(1, std::memory_order_acq_rel);
+        lanes_[static_cast<size_t>(lane)].queue.Push(task);
+        int64_t peak = peak_depth_.load(std::memory_order_relaxed);
+        while (previous + 1 > peak &&
+               !peak_depth_.compare_exchange_weak(peak, previous + 1, std::memory_order_relaxed))
+        {
+        }
+        if (previous == 0 ||
+            (lane == UiThreadLane::kControl && yielding_.load(std::memory_order_acquire)))
+        {
+            Notify();
+        }
+    }
+
+    // Posted but not yet run, across both lanes.
+    size_t depth() const
+    {
+        return static_cast<size_t>(std::max<int64_t>(0, pending_.load(std::memory_order_relaxed)));
+    }
+    size_t peak_depth() const { return static_cast<size_t>(peak_depth_.load(std::memory_order_relaxed)); }
+
+    // Time from Post to run.
+    const universal_ble::LatencyHistogram &QueueWait(UiThreadLane lane) const
+    {
+        return lanes_[static_cast<size_t>(lane)].wait;
+    }
+
+    // Time spent inside the callbacks of `kind`.
+    const universal_ble::LatencyHistogram &Execution(UiCallbackKind kind) const
+    {
+        return execution_[static_cast<size_t>(kind)];
+    }
+
+    // Callbacks run per second over the span of the trace ring.
+    double CallbacksPerSecond() const
+    {
+        if (trace_size_ < 2)
+        {
+            return 0;
+        }
+        const TraceEvent &oldest = trace_[(trace_next_ + kTraceCapacity - trace_size_) % kTraceCapacity];
+        const TraceEvent &newest = trace_[(trace_next_ + kTraceCapacity - 1) % kTraceCapacity];
+        const int64_t span = newest.start_micros - oldest.start_micros;
+        return span > 0 ? static_cast<double>(trace_size_ - 1) * 1e6 / static_cast<double>(span) : 0;
+    }
+
+    // The last kTraceCapacity callbacks in Chrome trace event format
+    // (chrome://tracing, Perfetto). One complete event per callback on a
+    // thread per lane, with its queue wait and the depth it left behind.
+    // Call on the UI thread only; the ring is not synchronized.
+    std::string TraceJson() const
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        queuedFuncs_.emplace_back(std::move(func));
-        Notify();
+        std::ostringstream out;
+        out << "{\"traceEvents\":[";
+        for (size_t i = 0; i < trace_size_; ++i)
+        {
+            const TraceEvent &event = trace_[(trace_next_ + kTraceCapacity - trace_size_ + i) % kTraceCapacity];
+            if (i > 0)
+            {
+                out << ',';
+            }
+            out << "{\"name\":\"" << UiCallbackKindName(event.kind)
+                << "\",\"cat\":\"" << (event.lane == UiThreadLane::kBulk ? "bulk" : "control")
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << static_cast<int>(event.lane)
+                << ",\"ts\":" << event.start_micros << ",\"dur\":" << event.duration_micros
+                << ",\"args\":{\"wait_us\":" << event.wait_micros
+                << ",\"depth\":" << event.depth << "}}";
+        }
+        out << "]}";
+        return out.str();
     }
 
 private:
     static const UINT kWmCallQueuedFunctions = WM_APP + 0x1d7;
+    // Bulk callbacks run per wake. The rest waits for a WM_TIMER, which
+    // Windows delivers only once no input, paint or posted message is
+    // pending, so a flood cannot starve the window. The control lane is
+    // not budgeted; it is re-checked before every bulk callback.
+    static constexpr size_t kBulkBudget = 256;
+    static constexpr size_t kTraceCapacity = 4096;
+    // Pooled queue nodes; beyond this many pending tasks they come from the
+    // heap.
+    static constexpr size_t kTaskNodeCount = 1024;
+
+    struct Task
+    {
+        Task() = default;
+        explicit Task(universal_ble::UniversalBleTask &&func) : func(std::move(func)) {}
+
+        std::atomic<Task *> next{nullptr};
+        universal_ble::UniversalBleTask func;
+        UiCallbackKind kind = UiCallbackKind::kOther;
+        int64_t enqueued_micros = 0;
+    };
+
+    struct TraceEvent
+    {
+        UiCallbackKind kind;
+        UiThreadLane lane;
+        int64_t start_micros;
+        int64_t duration_micros;
+        int64_t wait_micros;
+        size_t depth;
+    };
+
+    struct Lane
+    {
+        universal_ble::MpscQueue<Task> queue;
+        universal_ble::LatencyHistogram wait;
+    };
 
     void Notify()
     {
-        if (hwnd_ != 0)
+        const HWND hwnd = hwnd_.load(std::memory_order_acquire);
+        if (hwnd != 0)
         {
-            PostMessage(hwnd_, kWmCallQueuedFunctions, 0, reinterpret_cast<LPARAM>(this));
+            PostMessage(hwnd, kWmCallQueuedFunctions, 0, reinterpret_cast<LPARAM>(this));
+        }
+    }
+
+    UINT_PTR YieldTimerId() const { return reinterpret_cast<UINT_PTR>(this); }
+
+    // Resumes bulk work from a WM_TIMER once the window is idle. At most one
+    // timer is armed; Post wakes control callbacks in the meantime.
+    void YieldBulk()
+    {
+        if (!yielding_.exchange(true, std::memory_order_acq_rel))
+        {
+            SetTimer(hwnd_.load(std::memory_order_acquire), YieldTimerId(), USER_TIMER_MINIMUM, nullptr);
         }
     }
 
     std::optional<LRESULT> HandleWindowMessage(
         HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam)
     {
-        if (hwnd_ == 0)
+        if (hwnd_.load(std::memory_order_acquire) == 0)
         {
-            hwnd_ = hwnd;
+            hwnd_.store(hwnd, std::memory_order_release);
             Notify(); // Make sure queued functions are processed
         }
         if (message == kWmCallQueuedFunctions && lparam == reinterpret_cast<LPARAM>(this))
         {
-            std::list<std::function<void()>> queuedFuncs;
+            Drain();
+        }
+        else if (message == WM_TIMER && wparam == YieldTimerId())
+        {
+            KillTimer(hwnd, YieldTimerId());
+            yielding_.store(false, std::memory_order_release);
+            Drain();
+            return 0;
+        }
+        return std::nullopt;
+    }
+
+    // Runs the oldest task of `lane`. False when the lane is empty, or a
+    // producer is mid-push; its count is still in pending_, so Drain
+    // re-arms the wake.
+    bool RunOne(UiThreadLane lane)
+    {
+        Lane &target = lanes_[static_cast<size_t>(lane)];
+        Task *task = target.queue.Pop();
+        if (task == nullptr)
+        {
+            return false;
+        }
+        const int64_t remaining = pending_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        const int64_t start = universal_ble::UniversalBleClock::NowMicros();
+        const int64_t wait = start - task->enqueued_micros;
+        target.wait.Record(wait);
+        task->func();
+        const int64_t duration = universal_ble::UniversalBleClock::NowMicros() - start;
+        execution_[static_cast<size_t>(task->kind)].Record(duration);
+        trace_[trace_next_] = TraceEvent{task->kind, lane, start, duration, wait, static_cast<size_t>(remaining)};
+        trace_next_ = (trace_next_ + 1) % kTraceCapacity;
+        trace_size_ = std::min(trace_size_ + 1, kTraceCapacity);
+        task_pool_.Delete(task);
+        return true;
+    }
+
+    void Drain()
+    {
+        // While yielding, only control callbacks run until the timer fires.
+        const bool run_bulk = !yielding_.load(std::memory_order_acquire);
+        size_t bulk_ran = 0;
+        for (;;)
+        {
+            if (RunOne(UiThreadLane::kControl))
             {
-                std::lock_guard<std::mutex> lock(mutex_);
-                std::swap(queuedFuncs_, queuedFuncs);
+                continue;
             }
-            for (auto &func : queuedFuncs)
+            if (run_bulk && bulk_ran < kBulkBudget && RunOne(UiThreadLane::kBulk))
             {
-                func();
+                ++bulk_ran;
+                continue;
             }
+            break;
+        }
+        if (!run_bulk || pending_.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+        if (bulk_ran == kBulkBudget)
+        {
+            YieldBulk();
+        }
+        else
+        {
+            // A producer is between counting and pushing its task.
+            Notify();
         }
-        return std::nullopt;
     }
 
     flutter::PluginRegistrarWindows *registrar_;
     int windowProcId_ = 0;
-    HWND hwnd_ = 0;
-    std::list<std::function<void()>> queuedFuncs_;
-    std::mutex mutex_;
-};
\ No newline at end of file
+    std::atomic<HWND> hwnd_{0};
+    universal_ble::ObjectPool<Task, kTaskNodeCount> task_pool_;
+    std::array<Lane, 2> lanes_;
+    // Counted by Post before the push and by RunOne after each pop, so it
+    // never goes below zero; the 0 -> 1 transition owns the wake message.
+    std::atomic<int64_t> pending_{0};
+    std::atomic<int64_t> peak_depth_{0};
+    // The yield timer is armed.
+    std::atomic<bool> yielding_{false};
+    std::array<universal_ble::LatencyHistogram, kUiCallbackKindCount> execution_;
+    // Written and read on the UI thread only.
+    std::array<TraceEvent, kTraceCapacity> trace_{};
+    size_t trace_next_ = 0;
+    size_t trace_size_ = 0;
+};
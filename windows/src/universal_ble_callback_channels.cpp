@@ -0,0 +1,85 @@
+#include "universal_ble_callback_channels.h"
+
+#include "universal_ble_message_writer.h"
+
+namespace universal_ble {
+
+namespace {
+std::string callback_channel_name(const char *method,
+                                  const std::string &suffix) {
+  std::string name =
+      "dev.flutter.pigeon.universal_ble.UniversalBleCallbackChannel.";
+  name += method;
+  if (!suffix.empty()) {
+    name += '.';
+    name += suffix;
+  }
+  return name;
+}
+} // namespace
+
+UniversalBleCallbackChannels::UniversalBleCallbackChannels(
+    flutter::BinaryMessenger *messenger,
+    const std::string &message_channel_suffix)
+    : messenger_(messenger),
+      scan_result_channel_(
+          callback_channel_name("onScanResult", message_channel_suffix)),
+      value_changed_channel_(
+          callback_channel_name("onValueChanged", message_channel_suffix)) {}
+
+void UniversalBleCallbackChannels::OnScanResult(
+    const UniversalBleScanResult &result) {
+  buffer_.clear();
+  StandardMessageWriter writer(buffer_);
+  writer.WriteListHeader(1);
+  if (!writer.WriteScanResult(result)) {
+    // A value the writer does not know; the codec handles everything.
+    const auto message = UniversalBleCallbackChannel::GetCodec().EncodeMessage(
+        flutter::EncodableValue(flutter::EncodableList{
+            flutter::CustomEncodableValue(result),
+        }));
+    messenger_->Send(scan_result_channel_, message->data(), message->size());
+    return;
+  }
+  Send(scan_result_channel_);
+}
+
+void UniversalBleCallbackChannels::OnValueChanged(
+    const std::string &device_id, const std::string &characteristic_id,
+    const std::vector<uint8_t> &value, const int64_t *timestamp) {
+  buffer_.clear();
+  StandardMessageWriter writer(buffer_);
+  writer.WriteListHeader(4);
+  writer.WriteString(device_id);
+  writer.WriteString(characteristic_id);
+  writer.WriteBytes(value.data(), value.size());
+  if (timestamp) {
+    writer.WriteInt64(*timestamp);
+  } else {
+    writer.WriteNull();
+  }
+  Send(value_changed_channel_);
+}
+
+void UniversalBleCallbackChannels::OnValueChangedBatch(
+    const std::string &device_id, const std::string &characteristic_id,
+    const std::vector<NotificationEntry> &entries) {
+  buffer_.clear();
+  StandardMessageWriter writer(buffer_);
+  writer.WriteListHeader(3);
+  writer.WriteString(device_id);
+  writer.WriteString(characteristic_id);
+  writer.WriteListHeader(entries.size() * 2);
+  for (const auto &entry : entries) {
+    writer.WriteInt64(entry.timestamp);
+    writer.WriteBytes(entry.value.data(), entry.value.size());
+  }
+  Send(value_changed_batch_channel_);
+}
+
+void UniversalBleCallbackChannels::Send(const std::string &channel) {
+  // The messenger copies the message, so the buffer is reused right away.
+  messenger_->Send(channel, buffer_.data(), buffer_.size());
+}
+
+} // namespace universal_ble
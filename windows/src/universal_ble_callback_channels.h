@@ -0,0 +1,53 @@
+#pragma once
+
+#include <flutter/binary_messenger.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "generated/universal_ble.g.h"
+#include "universal_ble_notification_buffer.h"
+
+namespace universal_ble {
+
+constexpr char kValueChangedBatchChannel[] = "universal_ble/value_changed_batch";
+
+/// Long-lived senders for the messages that go out per scan result and per
+/// notification.
+///
+/// The generated On* methods concatenate the channel name, construct a
+/// BasicMessageChannel and allocate a reply closure on every call. Here the
+/// names are built once, messages are written by StandardMessageWriter into
+/// a reused buffer, and nothing waits for a reply: Dart only ever answers
+/// these events with success. Call from the platform thread only.
+class UniversalBleCallbackChannels {
+public:
+  explicit UniversalBleCallbackChannels(
+      flutter::BinaryMessenger *messenger,
+      const std::string &message_channel_suffix = "");
+
+  // Same bytes as UniversalBleCallbackChannel::OnScanResult.
+  void OnScanResult(const UniversalBleScanResult &result);
+  // Same bytes as UniversalBleCallbackChannel::OnValueChanged.
+  void OnValueChanged(const std::string &device_id,
+                      const std::string &characteristic_id,
+                      const std::vector<uint8_t> &value,
+                      const int64_t *timestamp);
+  // On kValueChangedBatchChannel:
+  // [device_id, characteristic_id, [timestamp0 (us), value0, ...]].
+  void OnValueChangedBatch(const std::string &device_id,
+                           const std::string &characteristic_id,
+                           const std::vector<NotificationEntry> &entries);
+
+private:
+  void Send(const std::string &channel);
+
+  flutter::BinaryMessenger *messenger_;
+  std::string scan_result_channel_;
+  std::string value_changed_channel_;
+  std::string value_changed_batch_channel_ = kValueChangedBatchChannel;
+  std::vector<uint8_t> buffer_;
+};
+
+} // namespace universal_ble
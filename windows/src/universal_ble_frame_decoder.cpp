@@ -0,0 +1,251 @@
+#include "universal_ble_frame_decoder.h"
+
+namespace universal_ble {
+
+namespace {
+class LengthPrefixDecoder final : public FrameDecoder {
+public:
+  using FrameDecoder::FrameDecoder;
+
+protected:
+  void FeedLocked(std::span<const uint8_t> fragment, const int64_t timestamp,
+                  std::vector<NotificationEntry> &frames) override {
+    if (pending_.empty()) {
+      first_timestamp_ = timestamp;
+    }
+    pending_.insert(pending_.end(), fragment.begin(), fragment.end());
+    const size_t prefix_size = options_.prefix_size;
+    size_t offset = 0;
+    while (pending_.size() - offset >= prefix_size) {
+      size_t length = 0;
+      for (size_t i = 0; i < prefix_size; ++i) {
+        const size_t shift =
+            8 * (options_.prefix_big_endian ? prefix_size - 1 - i : i);
+        length |= static_cast<size_t>(pending_[offset + i]) << shift;
+      }
+      if (options_.length_includes_prefix) {
+        if (length < prefix_size) {
+          // Cannot resynchronise inside a corrupt stream: start over.
+          ++stats_.decode_errors;
+          pending_.clear();
+          return;
+        }
+        length -= prefix_size;
+      }
+      if (length > options_.max_frame_size) {
+        ++stats_.overflows;
+        pending_.clear();
+        return;
+      }
+      if (pending_.size() - offset - prefix_size < length) {
+        break;
+      }
+      const auto begin = pending_.begin() + offset + prefix_size;
+      EmitLocked(std::vector<uint8_t>(begin, begin + length),
+                 first_timestamp_, frames);
+      offset += prefix_size + length;
+      // Whatever follows started in this fragment.
+      first_timestamp_ = timestamp;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + offset);
+  }
+
+private:
+  std::vector<uint8_t> pending_;
+  int64_t first_timestamp_ = 0;
+};
+
+class SlipDecoder final : public FrameDecoder {
+public:
+  using FrameDecoder::FrameDecoder;
+
+protected:
+  void FeedLocked(std::span<const uint8_t> fragment, const int64_t timestamp,
+                  std::vector<NotificationEntry> &frames) override {
+    constexpr uint8_t kEnd = 0xC0;
+    constexpr uint8_t kEsc = 0xDB;
+    constexpr uint8_t kEscEnd = 0xDC;
+    constexpr uint8_t kEscEsc = 0xDD;
+    for (const uint8_t byte : fragment) {
+      if (!in_frame_) {
+        in_frame_ = true;
+        first_timestamp_ = timestamp;
+      }
+      if (byte == kEnd) {
+        if (!discarding_ && !frame_.empty()) {
+          EmitLocked(std::move(frame_), first_timestamp_, frames);
+        }
+        frame_.clear();
+        escaped_ = false;
+        discarding_ = false;
+        in_frame_ = false;
+        continue;
+      }
+      if (discarding_) {
+        continue;
+      }
+      uint8_t decoded = byte;
+      if (escaped_) {
+        escaped_ = false;
+        if (byte == kEscEnd) {
+          decoded = kEnd;
+        } else if (byte == kEscEsc) {
+          decoded = kEsc;
+        } else {
+          ++stats_.decode_errors;
+          discarding_ = true;
+          continue;
+        }
+      } else if (byte == kEsc) {
+        escaped_ = true;
+        continue;
+      }
+      if (frame_.size() >= options_.max_frame_size) {
+        ++stats_.overflows;
+        discarding_ = true;
+        frame_.clear();
+        continue;
+      }
+      frame_.push_back(decoded);
+    }
+  }
+
+private:
+  std::vector<uint8_t> frame_;
+  int64_t first_timestamp_ = 0;
+  bool in_frame_ = false;
+  bool escaped_ = false;
+  bool discarding_ = false;
+};
+
+class CobsDecoder final : public FrameDecoder {
+public:
+  using FrameDecoder::FrameDecoder;
+
+protected:
+  void FeedLocked(std::span<const uint8_t> fragment, const int64_t timestamp,
+                  std::vector<NotificationEntry> &frames) override {
+    for (const uint8_t byte : fragment) {
+      if (!in_frame_) {
+        in_frame_ = true;
+        first_timestamp_ = timestamp;
+      }
+      if (byte == 0) {
+        if (!discarding_ && !encoded_.empty()) {
+          DecodeLocked(frames);
+        }
+        encoded_.clear();
+        discarding_ = false;
+        in_frame_ = false;
+        continue;
+      }
+      if (discarding_) {
+        continue;
+      }
+      // Encoding adds at most one byte per 254, plus the leading code.
+      if (encoded_.size() > options_.max_frame_size +
+                                options_.max_frame_size / 254 + 1) {
+        ++stats_.overflows;
+        discarding_ = true;
+        encoded_.clear();
+        continue;
+      }
+      encoded_.push_back(byte);
+    }
+  }
+
+private:
+  void DecodeLocked(std::vector<NotificationEntry> &frames) {
+    std::vector<uint8_t> decoded;
+    decoded.reserve(encoded_.size());
+    size_t i = 0;
+    while (i < encoded_.size()) {
+      const uint8_t code = encoded_[i++];
+      if (i + code - 1 > encoded_.size()) {
+        ++stats_.decode_errors;
+        return;
+      }
+      decoded.insert(decoded.end(), encoded_.begin() + i,
+                     encoded_.begin() + i + code - 1);
+      i += code - 1;
+      if (code != 0xFF && i < encoded_.size()) {
+        decoded.push_back(0);
+      }
+    }
+    if (decoded.size() > options_.max_frame_size) {
+      ++stats_.overflows;
+      return;
+    }
+    EmitLocked(std::move(decoded), first_timestamp_, frames);
+  }
+
+  std::vector<uint8_t> encoded_;
+  int64_t first_timestamp_ = 0;
+  bool in_frame_ = false;
+  bool discarding_ = false;
+};
+} // namespace
+
+void FrameDecoder::Feed(std::span<const uint8_t> fragment,
+                        const int64_t timestamp,
+                        std::vector<NotificationEntry> &frames) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FeedLocked(fragment, timestamp, frames);
+}
+
+FrameDecoderStats FrameDecoder::stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void FrameDecoder::EmitLocked(std::vector<uint8_t> frame,
+                              const int64_t timestamp,
+                              std::vector<NotificationEntry> &frames) {
+  if (options_.check == FrameCheck::kCrc16Ccitt) {
+    if (frame.size() < 2) {
+      ++stats_.crc_failures;
+      return;
+    }
+    const size_t payload_size = frame.size() - 2;
+    const uint16_t expected = static_cast<uint16_t>(
+        frame[payload_size] | (frame[payload_size + 1] << 8));
+    if (Crc16Ccitt(frame.data(), payload_size) != expected) {
+      ++stats_.crc_failures;
+      return;
+    }
+    frame.resize(payload_size);
+  }
+  ++stats_.frames;
+  frames.push_back({timestamp, std::move(frame)});
+}
+
+std::unique_ptr<FrameDecoder> CreateFrameDecoder(const FramingOptions &options) {
+  switch (options.mode) {
+  case FramingMode::kLengthPrefix:
+    if (options.prefix_size < 1 || options.prefix_size > sizeof(size_t)) {
+      return nullptr;
+    }
+    return std::make_unique<LengthPrefixDecoder>(options);
+  case FramingMode::kSlip:
+    return std::make_unique<SlipDecoder>(options);
+  case FramingMode::kCobs:
+    return std::make_unique<CobsDecoder>(options);
+  case FramingMode::kNone:
+    break;
+  }
+  return nullptr;
+}
+
+uint16_t Crc16Ccitt(const uint8_t *data, const size_t size) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= static_cast<uint16_t>(data[i] << 8);
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                           : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+} // namespace universal_ble
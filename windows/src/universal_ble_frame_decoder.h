@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "universal_ble_notification_buffer.h"
+
+namespace universal_ble {
+
+enum class FramingMode {
+  // Every notification is delivered as is.
+  kNone,
+  // Each frame starts with its length (prefix_size bytes).
+  kLengthPrefix,
+  // RFC 1055 SLIP: frames end with 0xC0, escaped with 0xDB.
+  kSlip,
+  // Consistent Overhead Byte Stuffing, frames end with 0x00.
+  kCobs,
+};
+
+enum class FrameCheck {
+  kNone,
+  // Trailing little-endian CRC-16/CCITT-FALSE over the frame payload,
+  // stripped before delivery.
+  kCrc16Ccitt,
+};
+
+struct FramingOptions {
+  FramingMode mode = FramingMode::kNone;
+  FrameCheck check = FrameCheck::kNone;
+  // Largest decoded frame; anything longer is dropped and counted.
+  size_t max_frame_size = 4096;
+  // kLengthPrefix only.
+  size_t prefix_size = 2;
+  bool prefix_big_endian = false;
+  bool length_includes_prefix = false;
+};
+
+struct FrameDecoderStats {
+  uint64_t frames = 0;
+  uint64_t crc_failures = 0;
+  uint64_t overflows = 0;
+  uint64_t decode_errors = 0;
+};
+
+/// Reassembles frames split across notifications. Thread-safe; one decoder
+/// per subscription.
+class FrameDecoder {
+public:
+  explicit FrameDecoder(const FramingOptions &options) : options_(options) {}
+  virtual ~FrameDecoder() = default;
+
+  FrameDecoder(const FrameDecoder &) = delete;
+  FrameDecoder &operator=(const FrameDecoder &) = delete;
+
+  /// Consumes one notification and appends every frame it completes to
+  /// `frames`, stamped with the timestamp of the frame's first fragment.
+  void Feed(std::span<const uint8_t> fragment, int64_t timestamp,
+            std::vector<NotificationEntry> &frames);
+
+  FrameDecoderStats stats();
+
+protected:
+  virtual void FeedLocked(std::span<const uint8_t> fragment,
+                          int64_t timestamp,
+                          std::vector<NotificationEntry> &frames) = 0;
+  // Verifies and strips the check bytes, then appends the frame.
+  void EmitLocked(std::vector<uint8_t> frame, int64_t timestamp,
+                  std::vector<NotificationEntry> &frames);
+
+  const FramingOptions options_;
+  FrameDecoderStats stats_;
+
+private:
+  std::mutex mutex_;
+};
+
+/// Returns nullptr for FramingMode::kNone.
+std::unique_ptr<FrameDecoder> CreateFrameDecoder(const FramingOptions &options);
+
+uint16_t Crc16Ccitt(const uint8_t *data, size_t size);
+
+} // namespace universal_ble
@@ -0,0 +1,197 @@
+#include "universal_ble_gatt_cache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace universal_ble {
+
+namespace {
+std::string hash_to_hex(const std::vector<uint8_t> &bytes) {
+  std::ostringstream oss;
+  for (const auto b : bytes) {
+    oss << std::hex << std::setw(2) << std::setfill('0')
+        << static_cast<int>(b);
+  }
+  return oss.str();
+}
+
+std::optional<std::vector<uint8_t>> hex_to_hash(const std::string &hex) {
+  if (hex == "-" || hex.size() % 2 != 0) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> bytes;
+  bytes.reserve(hex.size() / 2);
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    bytes.push_back(
+        static_cast<uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+// `<uuid>@<hex handle>`; throws if the handle is missing.
+std::pair<std::string, uint16_t> parse_attribute(const std::string &value) {
+  const auto separator = value.find('@');
+  if (separator == std::string::npos) {
+    throw std::invalid_argument("attribute without a handle");
+  }
+  return {value.substr(0, separator),
+          static_cast<uint16_t>(
+              std::stoul(value.substr(separator + 1), nullptr, 16))};
+}
+
+std::vector<std::string> split(const std::string &value, char separator) {
+  std::vector<std::string> parts;
+  std::string part;
+  std::istringstream iss(value);
+  while (std::getline(iss, part, separator)) {
+    if (!part.empty()) {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+} // namespace
+
+GattLayoutCache::GattLayoutCache(std::filesystem::path path,
+                                 const size_t max_layouts)
+    : path_(std::move(path)), max_layouts_(std::max<size_t>(1, max_layouts)) {}
+
+std::optional<GattLayout>
+GattLayoutCache::Get(const uint64_t bluetooth_address) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadLocked();
+  const auto it = layouts_.find(bluetooth_address);
+  if (it == layouts_.end()) {
+    return std::nullopt;
+  }
+  // Only reordered in memory; the next write persists the order.
+  it->second.last_used = ++use_counter_;
+  return it->second.layout;
+}
+
+void GattLayoutCache::Put(const uint64_t bluetooth_address,
+                          const GattLayout &layout) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadLocked();
+  const auto it = layouts_.find(bluetooth_address);
+  if (it != layouts_.end() && it->second.layout == layout &&
+      it->second.layout.database_hash == layout.database_hash) {
+    it->second.last_used = ++use_counter_;
+    return;
+  }
+  layouts_.insert_or_assign(bluetooth_address, Entry{layout, ++use_counter_});
+  EvictLocked();
+  SaveLocked();
+}
+
+void GattLayoutCache::Invalidate(const uint64_t bluetooth_address) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadLocked();
+  if (layouts_.erase(bluetooth_address) > 0) {
+    SaveLocked();
+  }
+}
+
+void GattLayoutCache::LoadLocked() {
+  if (loaded_) {
+    return;
+  }
+  loaded_ = true;
+  std::ifstream file(path_);
+  std::string line;
+  while (std::getline(file, line)) {
+    try {
+      std::istringstream iss(line);
+      std::string address, hash, services;
+      if (!(iss >> address >> hash)) {
+        continue;
+      }
+      iss >> services;
+      GattLayout layout;
+      layout.database_hash = hex_to_hash(hash);
+      if (hash != "-" && !layout.database_hash.has_value()) {
+        continue;
+      }
+      for (const auto &service : split(services, ';')) {
+        const auto separator = service.find('=');
+        const auto [service_uuid, service_handle] =
+            parse_attribute(service.substr(0, separator));
+        GattServiceLayout &service_layout = layout.services[service_uuid];
+        service_layout.handle = service_handle;
+        if (separator != std::string::npos) {
+          for (const auto &characteristic :
+               split(service.substr(separator + 1), ',')) {
+            service_layout.characteristics.insert(
+                parse_attribute(characteristic));
+          }
+        }
+      }
+      layouts_.insert_or_assign(std::stoull(address, nullptr, 16),
+                                Entry{std::move(layout), ++use_counter_});
+    } catch (...) {
+      // A corrupt line only costs that device a full discovery.
+    }
+  }
+  EvictLocked();
+}
+
+void GattLayoutCache::EvictLocked() {
+  while (layouts_.size() > max_layouts_) {
+    const auto oldest = std::min_element(
+        layouts_.begin(), layouts_.end(), [](const auto &a, const auto &b) {
+          return a.second.last_used < b.second.last_used;
+        });
+    layouts_.erase(oldest);
+  }
+}
+
+void GattLayoutCache::SaveLocked() const {
+  std::error_code error;
+  std::filesystem::create_directories(path_.parent_path(), error);
+  std::ofstream file(path_, std::ios::trunc);
+  if (!file) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, const Entry *>> entries;
+  entries.reserve(layouts_.size());
+  for (const auto &[address, entry] : layouts_) {
+    entries.emplace_back(address, &entry);
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+    return a.second->last_used < b.second->last_used;
+  });
+  for (const auto &[address, entry] : entries) {
+    const GattLayout &layout = entry->layout;
+    file << std::hex << address << std::dec << ' '
+         << (layout.database_hash.has_value()
+                 ? hash_to_hex(layout.database_hash.value())
+                 : "-")
+         << ' ';
+    bool first_service = true;
+    for (const auto &[service_uuid, service] : layout.services) {
+      if (!first_service) {
+        file << ';';
+      }
+      first_service = false;
+      file << service_uuid << '@' << std::hex << service.handle << std::dec
+           << '=';
+      bool first_characteristic = true;
+      for (const auto &[characteristic_uuid, handle] :
+           service.characteristics) {
+        if (!first_characteristic) {
+          file << ',';
+        }
+        first_characteristic = false;
+        file << characteristic_uuid << '@' << std::hex << handle << std::dec;
+      }
+    }
+    file << '\n';
+  }
+}
+
+} // namespace universal_ble
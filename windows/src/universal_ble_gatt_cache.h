@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace universal_ble {
+
+struct GattServiceLayout {
+  uint16_t handle = 0;
+  // Characteristic UUID -> attribute handle.
+  std::map<std::string, uint16_t> characteristics;
+
+  bool operator==(const GattServiceLayout &other) const {
+    return handle == other.handle && characteristics == other.characteristics;
+  }
+  bool operator!=(const GattServiceLayout &other) const {
+    return !(*this == other);
+  }
+};
+
+/// Service and characteristic UUIDs and attribute handles of a peripheral's
+/// GATT database, tagged with its Database Hash (0x2B2A) if it has one.
+struct GattLayout {
+  std::optional<std::vector<uint8_t>> database_hash;
+  // Service UUID -> its handle and characteristics.
+  std::map<std::string, GattServiceLayout> services;
+
+  bool operator==(const GattLayout &other) const {
+    return services == other.services;
+  }
+  bool operator!=(const GattLayout &other) const { return !(*this == other); }
+};
+
+/// Disk-backed GATT layouts keyed by Bluetooth address.
+///
+/// A matching layout lets a reconnect use the OS cache instead of an
+/// over-the-air discovery. A layout is validated against the handles of a
+/// cached discovery, and against the Database Hash when the peripheral has
+/// one. At most `max_layouts` are kept; the least recently used one goes
+/// first. The file has one line per device, least recently used first,
+/// with `-` for a missing hash and handles in hex:
+/// `<address> <hash> <service>@<handle>=<char>@<handle>,...;<service>...`
+class GattLayoutCache {
+public:
+  static constexpr size_t kDefaultMaxLayouts = 64;
+
+  explicit GattLayoutCache(std::filesystem::path path,
+                           size_t max_layouts = kDefaultMaxLayouts);
+
+  std::optional<GattLayout> Get(uint64_t bluetooth_address);
+  // Stores `layout` and writes the file if it differs from the cached one.
+  void Put(uint64_t bluetooth_address, const GattLayout &layout);
+  void Invalidate(uint64_t bluetooth_address);
+
+private:
+  struct Entry {
+    GattLayout layout;
+    // Position in use order; the smallest is evicted first.
+    uint64_t last_used = 0;
+  };
+
+  void LoadLocked();
+  void SaveLocked() const;
+  void EvictLocked();
+
+  std::filesystem::path path_;
+  size_t max_layouts_;
+  std::unordered_map<uint64_t, Entry> layouts_;
+  uint64_t use_counter_ = 0;
+  bool loaded_ = false;
+  std::mutex mutex_;
+};
+
+} // namespace universal_ble
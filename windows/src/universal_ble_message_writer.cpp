@@ -0,0 +1,229 @@
+#include "universal_ble_message_writer.h"
+
+#include <any>
+#include <cstring>
+#include <type_traits>
+
+namespace universal_ble {
+
+namespace {
+// StandardMessageCodec type bytes.
+constexpr uint8_t kNull = 0;
+constexpr uint8_t kTrue = 1;
+constexpr uint8_t kFalse = 2;
+constexpr uint8_t kInt32 = 3;
+constexpr uint8_t kInt64 = 4;
+constexpr uint8_t kFloat64 = 6;
+constexpr uint8_t kString = 7;
+constexpr uint8_t kUInt8List = 8;
+constexpr uint8_t kInt32List = 9;
+constexpr uint8_t kInt64List = 10;
+constexpr uint8_t kFloat64List = 11;
+constexpr uint8_t kList = 12;
+constexpr uint8_t kMap = 13;
+constexpr uint8_t kFloat32List = 14;
+
+// PigeonInternalCodecSerializer type bytes; see universal_ble.g.cpp.
+constexpr uint8_t kPigeonScanResult = 144;
+constexpr uint8_t kPigeonManufacturerData = 153;
+} // namespace
+
+void StandardMessageWriter::WriteNull() { WriteType(kNull); }
+
+void StandardMessageWriter::WriteInt64(const int64_t value) {
+  WriteType(kInt64);
+  WriteRaw(&value, sizeof(value));
+}
+
+void StandardMessageWriter::WriteString(const std::string_view value) {
+  WriteType(kString);
+  WriteSize(value.size());
+  WriteRaw(value.data(), value.size());
+}
+
+void StandardMessageWriter::WriteBytes(const uint8_t *data, const size_t size) {
+  WriteType(kUInt8List);
+  WriteSize(size);
+  WriteRaw(data, size);
+}
+
+void StandardMessageWriter::WriteListHeader(const size_t size) {
+  WriteType(kList);
+  WriteSize(size);
+}
+
+bool StandardMessageWriter::WriteValue(const flutter::EncodableValue &value) {
+  return std::visit(
+      [this](const auto &v) -> bool {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+          WriteType(kNull);
+        } else if constexpr (std::is_same_v<T, bool>) {
+          WriteType(v ? kTrue : kFalse);
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+          WriteType(kInt32);
+          WriteRaw(&v, sizeof(v));
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+          WriteInt64(v);
+        } else if constexpr (std::is_same_v<T, double>) {
+          WriteType(kFloat64);
+          WriteAlignment(8);
+          WriteRaw(&v, sizeof(v));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+          WriteString(v);
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+          WriteBytes(v.data(), v.size());
+        } else if constexpr (std::is_same_v<T, std::vector<int32_t>>) {
+          WriteVector(kInt32List, v);
+        } else if constexpr (std::is_same_v<T, std::vector<int64_t>>) {
+          WriteVector(kInt64List, v);
+        } else if constexpr (std::is_same_v<T, std::vector<double>>) {
+          WriteVector(kFloat64List, v);
+        } else if constexpr (std::is_same_v<T, std::vector<float>>) {
+          WriteVector(kFloat32List, v);
+        } else if constexpr (std::is_same_v<T, flutter::EncodableList>) {
+          return WriteList(v);
+        } else if constexpr (std::is_same_v<T, flutter::EncodableMap>) {
+          return WriteMap(v);
+        } else if constexpr (std::is_same_v<T, flutter::CustomEncodableValue>) {
+          const std::any &custom = v;
+          if (const auto *data =
+                  std::any_cast<UniversalManufacturerData>(&custom)) {
+            WriteManufacturerData(*data);
+          } else if (const auto *result =
+                         std::any_cast<UniversalBleScanResult>(&custom)) {
+            return WriteScanResult(*result);
+          } else {
+            return false;
+          }
+        } else {
+          return false;
+        }
+        return true;
+      },
+      static_cast<const flutter::EncodableValue::super &>(value));
+}
+
+bool StandardMessageWriter::WriteScanResult(
+    const UniversalBleScanResult &result) {
+  // Field order of UniversalBleScanResult::ToEncodableList.
+  WriteType(kPigeonScanResult);
+  WriteListHeader(8);
+  WriteString(result.device_id());
+  if (result.name()) {
+    WriteString(*result.name());
+  } else {
+    WriteNull();
+  }
+  if (result.is_paired()) {
+    WriteType(*result.is_paired() ? kTrue : kFalse);
+  } else {
+    WriteNull();
+  }
+  if (result.rssi()) {
+    WriteInt64(*result.rssi());
+  } else {
+    WriteNull();
+  }
+  // The nested containers are walked in place rather than copied into an
+  // EncodableValue.
+  if (const auto *manufacturer_data = result.manufacturer_data_list()) {
+    if (!WriteList(*manufacturer_data)) {
+      return false;
+    }
+  } else {
+    WriteNull();
+  }
+  if (const auto *service_data = result.service_data()) {
+    if (!WriteMap(*service_data)) {
+      return false;
+    }
+  } else {
+    WriteNull();
+  }
+  if (const auto *services = result.services()) {
+    if (!WriteList(*services)) {
+      return false;
+    }
+  } else {
+    WriteNull();
+  }
+  if (result.timestamp()) {
+    WriteInt64(*result.timestamp());
+  } else {
+    WriteNull();
+  }
+  return true;
+}
+
+bool StandardMessageWriter::WriteList(const flutter::EncodableList &list) {
+  WriteListHeader(list.size());
+  for (const auto &element : list) {
+    if (!WriteValue(element)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool StandardMessageWriter::WriteMap(const flutter::EncodableMap &map) {
+  WriteType(kMap);
+  WriteSize(map.size());
+  for (const auto &[key, element] : map) {
+    if (!WriteValue(key) || !WriteValue(element)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StandardMessageWriter::WriteManufacturerData(
+    const UniversalManufacturerData &data) {
+  WriteType(kPigeonManufacturerData);
+  WriteListHeader(2);
+  WriteInt64(data.company_identifier());
+  WriteBytes(data.data().data(), data.data().size());
+}
+
+void StandardMessageWriter::WriteSize(const size_t size) {
+  if (size < 254) {
+    buffer_.push_back(static_cast<uint8_t>(size));
+  } else if (size <= 0xffff) {
+    buffer_.push_back(254);
+    const auto value = static_cast<uint16_t>(size);
+    WriteRaw(&value, sizeof(value));
+  } else {
+    buffer_.push_back(255);
+    const auto value = static_cast<uint32_t>(size);
+    WriteRaw(&value, sizeof(value));
+  }
+}
+
+void StandardMessageWriter::WriteAlignment(const size_t alignment) {
+  const size_t remainder = buffer_.size() % alignment;
+  if (remainder != 0) {
+    buffer_.insert(buffer_.end(), alignment - remainder, 0);
+  }
+}
+
+void StandardMessageWriter::WriteRaw(const void *data, const size_t size) {
+  if (size == 0) {
+    return;
+  }
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+template <typename T>
+void StandardMessageWriter::WriteVector(const uint8_t type,
+                                        const std::vector<T> &values) {
+  WriteType(type);
+  WriteSize(values.size());
+  if (values.empty()) {
+    return;
+  }
+  WriteAlignment(sizeof(T));
+  WriteRaw(values.data(), values.size() * sizeof(T));
+}
+
+} // namespace universal_ble
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <flutter/encodable_value.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "generated/universal_ble.g.h"
+
+namespace universal_ble {
+
+/// Appends Flutter StandardMessageCodec bytes straight to a buffer.
+///
+/// The output is byte-identical to UniversalBleCallbackChannel::GetCodec()
+/// for every value it accepts, but hot messages are written field by field
+/// instead of first being boxed into an EncodableValue tree (and, for pigeon
+/// classes, a std::any copy plus ToEncodableList deep copy).
+class StandardMessageWriter {
+public:
+  explicit StandardMessageWriter(std::vector<uint8_t> &buffer)
+      : buffer_(buffer) {}
+
+  void WriteNull();
+  void WriteInt64(int64_t value);
+  void WriteString(std::string_view value);
+  void WriteBytes(const uint8_t *data, size_t size);
+  // Follow with `size` values.
+  void WriteListHeader(size_t size);
+
+  // False, with partial output, for a custom value this writer does not
+  // know; the caller should then fall back to the codec.
+  bool WriteValue(const flutter::EncodableValue &value);
+  // Same bytes as CustomEncodableValue(result) through the pigeon codec.
+  bool WriteScanResult(const UniversalBleScanResult &result);
+
+private:
+  void WriteType(uint8_t type) { buffer_.push_back(type); }
+  void WriteSize(size_t size);
+  void WriteAlignment(size_t alignment);
+  void WriteRaw(const void *data, size_t size);
+  template <typename T> void WriteVector(uint8_t type, const std::vector<T> &);
+  bool WriteList(const flutter::EncodableList &list);
+  bool WriteMap(const flutter::EncodableMap &map);
+  void WriteManufacturerData(const UniversalManufacturerData &data);
+
+  std::vector<uint8_t> &buffer_;
+};
+
+} // namespace universal_ble
@@ -0,0 +1,69 @@
+#include "universal_ble_notification_buffer.h"
+
+#include <algorithm>
+
+namespace universal_ble {
+
+NotificationRingBuffer::NotificationRingBuffer(
+    NotificationBufferOptions options)
+    : options_(options) {
+  slots_.resize(options_.policy == BackpressurePolicy::kKeepLatest
+                    ? 1
+                    : std::max<size_t>(1, options_.capacity));
+}
+
+size_t NotificationRingBuffer::Push(NotificationEntry entry) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (count_ == slots_.size()) {
+    if (options_.policy == BackpressurePolicy::kBlockProducer) {
+      not_full_.wait_for(lock, options_.max_block,
+                         [this] { return count_ < slots_.size(); });
+    }
+    if (count_ == slots_.size()) {
+      DropOldestLocked();
+    }
+  }
+  slots_[(head_ + count_) % slots_.size()] = std::move(entry);
+  ++count_;
+  stats_.high_water = std::max(stats_.high_water, count_);
+  return count_;
+}
+
+bool NotificationRingBuffer::ClaimDrain() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (drain_pending_) {
+    return false;
+  }
+  drain_pending_ = true;
+  return true;
+}
+
+std::vector<NotificationEntry> NotificationRingBuffer::Drain() {
+  std::vector<NotificationEntry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.reserve(count_);
+    for (; count_ > 0; --count_) {
+      entries.push_back(std::move(slots_[head_]));
+      head_ = (head_ + 1) % slots_.size();
+    }
+    head_ = 0;
+    drain_pending_ = false;
+  }
+  not_full_.notify_all();
+  return entries;
+}
+
+NotificationBufferStats NotificationRingBuffer::stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void NotificationRingBuffer::DropOldestLocked() {
+  slots_[head_].value.clear();
+  head_ = (head_ + 1) % slots_.size();
+  --count_;
+  ++stats_.dropped;
+}
+
+} // namespace universal_ble
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace universal_ble {
+
+enum class BackpressurePolicy {
+  // A full buffer discards its oldest notification.
+  kDropOldest,
+  // The buffer holds a single notification; newer ones replace it.
+  kKeepLatest,
+  // The WinRT callback thread waits for room, up to max_block, and then
+  // falls back to dropping the oldest notification.
+  kBlockProducer,
+};
+
+struct NotificationBufferOptions {
+  size_t capacity = 256;
+  BackpressurePolicy policy = BackpressurePolicy::kDropOldest;
+  std::chrono::milliseconds max_block{50};
+};
+
+struct NotificationBatchOptions {
+  bool enabled = false;
+  // Deliver as soon as this many notifications are buffered...
+  size_t max_entries = 32;
+  // ...or this long after the first one, whichever comes first.
+  std::chrono::milliseconds max_delay{8};
+};
+
+struct NotificationEntry {
+  // Arrival time, UniversalBleClock microseconds.
+  int64_t timestamp;
+  std::vector<uint8_t> value;
+};
+
+struct NotificationBufferStats {
+  uint64_t dropped = 0;
+  size_t high_water = 0;
+};
+
+/// Fixed-capacity queue between the WinRT notification thread and the
+/// platform thread, one per subscription.
+///
+/// At most one drain is pending per buffer, so a slow Dart side bounds
+/// memory at `capacity` entries instead of growing the UI thread queue.
+class NotificationRingBuffer {
+public:
+  explicit NotificationRingBuffer(NotificationBufferOptions options);
+
+  NotificationRingBuffer(const NotificationRingBuffer &) = delete;
+  NotificationRingBuffer &operator=(const NotificationRingBuffer &) = delete;
+
+  // Returns the number of buffered entries after the push.
+  size_t Push(NotificationEntry entry);
+  // True if the caller should schedule a drain: none is pending yet.
+  bool ClaimDrain();
+  // Removes everything in arrival order and clears the pending drain.
+  std::vector<NotificationEntry> Drain();
+
+  NotificationBufferStats stats();
+
+private:
+  void DropOldestLocked();
+
+  const NotificationBufferOptions options_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::vector<NotificationEntry> slots_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+  bool drain_pending_ = false;
+  NotificationBufferStats stats_;
+};
+
+} // namespace universal_ble
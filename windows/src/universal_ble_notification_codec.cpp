@@ -0,0 +1,51 @@
+#include "universal_ble_notification_codec.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace universal_ble {
+
+namespace {
+template <typename T> void append_le(std::vector<uint8_t> &out, T value) {
+  const auto bits = static_cast<std::make_unsigned_t<T>>(value);
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+  }
+}
+
+void append_string(std::vector<uint8_t> &out, const std::string &value) {
+  const auto length = static_cast<uint16_t>(
+      std::min<size_t>(value.size(), std::numeric_limits<uint16_t>::max()));
+  append_le(out, length);
+  out.insert(out.end(), value.begin(), value.begin() + length);
+}
+} // namespace
+
+void AppendSubscribeFrame(std::vector<uint8_t> &out,
+                          const uint32_t subscription_id,
+                          const std::string &device_id,
+                          const std::string &characteristic_uuid) {
+  out.push_back(static_cast<uint8_t>(NotificationFrameKind::kSubscribe));
+  append_le(out, subscription_id);
+  append_string(out, device_id);
+  append_string(out, characteristic_uuid);
+}
+
+void AppendValueFrame(std::vector<uint8_t> &out,
+                      const uint32_t subscription_id, const int64_t timestamp,
+                      const std::vector<uint8_t> &value) {
+  out.push_back(static_cast<uint8_t>(NotificationFrameKind::kValue));
+  append_le(out, subscription_id);
+  append_le(out, timestamp);
+  append_le(out, static_cast<uint32_t>(value.size()));
+  out.insert(out.end(), value.begin(), value.end());
+}
+
+void AppendUnsubscribeFrame(std::vector<uint8_t> &out,
+                            const uint32_t subscription_id) {
+  out.push_back(static_cast<uint8_t>(NotificationFrameKind::kUnsubscribe));
+  append_le(out, subscription_id);
+}
+
+} // namespace universal_ble
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace universal_ble {
+
+enum class NotificationTransport {
+  // One pigeon OnValueChanged message per notification (or batch).
+  kPigeon,
+  // Compact frames on kNotificationBinaryChannel, no reply decoding.
+  kBinary,
+};
+
+constexpr char kNotificationBinaryChannel[] = "universal_ble/value_changed_binary";
+
+/// Frames of the binary notification channel. A message holds one or more
+/// frames back to back; all integers are little-endian.
+///
+///   subscribe:   u8 0, u32 id, u16 n, device id[n], u16 m, characteristic[m]
+///   value:       u8 1, u32 id, i64 timestamp (us), u32 n, payload[n]
+///   unsubscribe: u8 2, u32 id
+enum class NotificationFrameKind : uint8_t {
+  kSubscribe = 0,
+  kValue = 1,
+  kUnsubscribe = 2,
+};
+
+constexpr size_t kNotificationValueHeaderSize = 1 + 4 + 8 + 4;
+
+void AppendSubscribeFrame(std::vector<uint8_t> &out, uint32_t subscription_id,
+                          const std::string &device_id,
+                          const std::string &characteristic_uuid);
+// Does not reserve; callers appending many frames reserve the total once.
+void AppendValueFrame(std::vector<uint8_t> &out, uint32_t subscription_id,
+                      int64_t timestamp, const std::vector<uint8_t> &value);
+void AppendUnsubscribeFrame(std::vector<uint8_t> &out,
+                            uint32_t subscription_id);
+
+} // namespace universal_ble
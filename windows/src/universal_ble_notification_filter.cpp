@@ -0,0 +1,79 @@
+#include "universal_ble_notification_filter.h"
+
+#include <algorithm>
+
+namespace universal_ble {
+
+NotificationFilter::NotificationFilter(
+    const NotificationFilterOptions &options)
+    : options_(options),
+      period_micros_(options.max_rate_hz > 0
+                         ? static_cast<int64_t>(1000000.0 / options.max_rate_hz)
+                         : 0) {}
+
+NotificationFilter::Decision NotificationFilter::Offer(NotificationEntry &entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Decision decision;
+  switch (options_.mode) {
+  case NotificationFilterMode::kAll:
+    decision.deliver = true;
+    break;
+  case NotificationFilterMode::kOnChange:
+    decision.deliver = !last_value_.has_value() || *last_value_ != entry.value;
+    if (decision.deliver) {
+      last_value_ = entry.value;
+    }
+    break;
+  case NotificationFilterMode::kEveryNth:
+    decision.deliver =
+        seen_++ % std::max<uint32_t>(1, options_.every_nth) == 0;
+    break;
+  case NotificationFilterMode::kRateLimit:
+    if (!last_delivered_at_.has_value() ||
+        entry.timestamp - *last_delivered_at_ >= period_micros_) {
+      // A held value is older than this one; this one supersedes it.
+      if (held_.has_value()) {
+        held_.reset();
+        ++filtered_;
+      }
+      last_delivered_at_ = entry.timestamp;
+      decision.deliver = true;
+      break;
+    }
+    if (held_.has_value()) {
+      ++filtered_;
+    } else {
+      decision.schedule_release = true;
+      decision.release_in_micros =
+          *last_delivered_at_ + period_micros_ - entry.timestamp;
+    }
+    held_ = std::move(entry);
+    return decision;
+  }
+  if (!decision.deliver) {
+    ++filtered_;
+  }
+  return decision;
+}
+
+std::optional<NotificationEntry>
+NotificationFilter::TakeHeld(const int64_t now_micros) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!held_.has_value()) {
+    return std::nullopt;
+  }
+  std::optional<NotificationEntry> entry = std::move(held_);
+  held_.reset();
+  last_delivered_at_ = now_micros;
+  return entry;
+}
+
+std::unique_ptr<NotificationFilter>
+CreateNotificationFilter(const NotificationFilterOptions &options) {
+  if (options.mode == NotificationFilterMode::kAll) {
+    return nullptr;
+  }
+  return std::make_unique<NotificationFilter>(options);
+}
+
+} // namespace universal_ble
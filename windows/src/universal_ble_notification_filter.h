@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "universal_ble_notification_buffer.h"
+
+namespace universal_ble {
+
+enum class NotificationFilterMode {
+  // Deliver every notification.
+  kAll,
+  // Deliver only when the value differs from the last delivered one.
+  kOnChange,
+  // At most max_rate_hz notifications per second; within a period the
+  // latest value is held and delivered when the period ends.
+  kRateLimit,
+  // Deliver every every_nth notification.
+  kEveryNth,
+};
+
+struct NotificationFilterOptions {
+  NotificationFilterMode mode = NotificationFilterMode::kAll;
+  double max_rate_hz = 0;
+  uint32_t every_nth = 1;
+};
+
+/// Per-subscription policy applied on the WinRT callback thread, before a
+/// notification is queued for the platform thread. Thread-safe.
+class NotificationFilter {
+public:
+  struct Decision {
+    bool deliver = false;
+    // kRateLimit: a value was newly held; call TakeHeld() after
+    // `release_in_micros`.
+    bool schedule_release = false;
+    int64_t release_in_micros = 0;
+  };
+
+  explicit NotificationFilter(const NotificationFilterOptions &options);
+
+  // `entry.timestamp` is the arrival time in microseconds. When the result
+  // is not `deliver`, the entry was either dropped or held.
+  Decision Offer(NotificationEntry &entry);
+  // Releases the value held by kRateLimit, if any.
+  std::optional<NotificationEntry> TakeHeld(int64_t now_micros);
+
+  uint64_t filtered() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return filtered_;
+  }
+
+private:
+  const NotificationFilterOptions options_;
+  const int64_t period_micros_;
+  std::mutex mutex_;
+  std::optional<std::vector<uint8_t>> last_value_;
+  std::optional<int64_t> last_delivered_at_;
+  std::optional<NotificationEntry> held_;
+  uint64_t seen_ = 0;
+  uint64_t filtered_ = 0;
+};
+
+/// Returns nullptr for NotificationFilterMode::kAll.
+std::unique_ptr<NotificationFilter>
+CreateNotificationFilter(const NotificationFilterOptions &options);
+
+} // namespace universal_ble
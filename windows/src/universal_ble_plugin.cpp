@@ -2,17 +2,24 @@
 // ReSharper disable CppTooWideScope
 #include "universal_ble_plugin.h"
 #include <windows.h>
+#include <appmodel.h>
 
+#include <flutter/basic_message_channel.h>
 #include <flutter/plugin_registrar_windows.h>
+#include <flutter/standard_message_codec.h>
 
 #include <algorithm>
 #include <cctype>
+#include <deque>
+#include <exception>
 #include <future>
 #include <iomanip>
+#include <limits>
 #include <memory>
 #include <regex>
 #include <sstream>
 #include <thread>
+#include <utility>
 
 #include "enum_parser.h"
 #include "generated/universal_ble.g.h"
@@ -20,7 +27,9 @@
 #include "helper/universal_enum.h"
 #include "helper/utils.h"
 #include "pin_entry.h"
+#include "universal_ble_callback_channels.h"
 #include "universal_ble_filter_util.h"
+#include "universal_ble_gatt_cache.h"
 
 namespace universal_ble {
 using universal_ble::ErrorOr;
@@ -35,7 +44,16 @@ const auto is_paired_key = L"System.Devices.Aep.IsPaired";
 const auto is_present_key = L"System.Devices.Aep.IsPresent";
 const auto device_address_key = L"System.Devices.Aep.DeviceAddress";
 const auto signal_strength_key = L"System.Devices.Aep.SignalStrength";
+const auto generic_attribute_service_uuid =
+    "00001801-0000-1000-8000-00805f9b34fb";
+const auto database_hash_characteristic_uuid =
+    "00002b2a-0000-1000-8000-00805f9b34fb";
 static std::unique_ptr<UniversalBleCallbackChannel> callback_channel;
+// Scan results and notifications, including batches; see
+// UniversalBleCallbackChannels.
+static std::unique_ptr<UniversalBleCallbackChannels> hot_callback_channels;
+// Carries NotificationTransport::kBinary frames; see DeliverNotifications.
+static flutter::BinaryMessenger *notification_messenger = nullptr;
 std::unique_ptr<UniversalBlePeripheralCallback> peripheral_callback_channel_;
 
 namespace {
@@ -52,18 +70,209 @@ IPropertyValue lookup_i_property_value(
   try {
     auto value = properties.Lookup(key).try_as<IPropertyValue>();
     if (!value) {
-      UniversalBleLogger::LogError(std::string(context) +
-                                   ": unexpected type for " + property_name +
-                                   " property");
+      UNIVERSAL_BLE_LOG_ERROR(
+          kScan, std::string(context) + ": unexpected type for " +
+                 property_name + " property");
     }
     return value;
   } catch (const hresult_error &err) {
-    UniversalBleLogger::LogError(std::string(context) + ": failed to lookup " +
-                                 property_name + " property (hr=" +
-                                 std::to_string(err.code()) + ")");
+    UNIVERSAL_BLE_LOG_ERROR(
+        kScan, std::string(context) + ": failed to lookup " + property_name +
+               " property (hr=" + std::to_string(err.code()) + ")");
     return nullptr;
   }
 }
+
+// Package family name of a packaged app, else the executable name, so two
+// apps never share a GATT cache or log file.
+std::wstring app_directory_name() {
+  UINT32 length = 0;
+  if (GetCurrentPackageFamilyName(&length, nullptr) ==
+      ERROR_INSUFFICIENT_BUFFER) {
+    std::wstring name(length, L'\0');
+    if (GetCurrentPackageFamilyName(&length, name.data()) == ERROR_SUCCESS) {
+      name.resize(length > 0 ? length - 1 : 0);
+      return name;
+    }
+  }
+  wchar_t module_path[MAX_PATH];
+  const DWORD module_length =
+      GetModuleFileNameW(nullptr, module_path, MAX_PATH);
+  if (module_length > 0 && module_length < MAX_PATH) {
+    return std::filesystem::path(module_path).stem().wstring();
+  }
+  return L"default";
+}
+
+// %LOCALAPPDATA%\universal_ble\<app>, or the same under the temp directory
+// if LOCALAPPDATA is unset.
+std::filesystem::path data_directory() {
+  wchar_t local_app_data[MAX_PATH];
+  const DWORD length =
+      GetEnvironmentVariableW(L"LOCALAPPDATA", local_app_data, MAX_PATH);
+  std::filesystem::path base;
+  if (length > 0 && length < MAX_PATH) {
+    base = local_app_data;
+  } else {
+    std::error_code error;
+    base = std::filesystem::temp_directory_path(error);
+  }
+  return base / L"universal_ble" / app_directory_name();
+}
+
+flutter::EncodableValue to_encodable(const LatencyHistogram &histogram) {
+  return flutter::EncodableValue(flutter::EncodableMap{
+      {flutter::EncodableValue("count"),
+       flutter::EncodableValue(static_cast<int64_t>(histogram.count()))},
+      {flutter::EncodableValue("p50"),
+       flutter::EncodableValue(histogram.Percentile(50))},
+      {flutter::EncodableValue("p90"),
+       flutter::EncodableValue(histogram.Percentile(90))},
+      {flutter::EncodableValue("p99"),
+       flutter::EncodableValue(histogram.Percentile(99))},
+      {flutter::EncodableValue("max"),
+       flutter::EncodableValue(histogram.max())},
+  });
+}
+
+GattLayout to_gatt_layout(
+    const std::unordered_map<std::string, GattServiceObject> &gatt_map) {
+  GattLayout layout;
+  for (const auto &[service_uuid, service] : gatt_map) {
+    auto &service_layout = layout.services[service_uuid];
+    service_layout.handle = service.obj.AttributeHandle();
+    for (const auto &[characteristic_uuid, characteristic] :
+         service.characteristics) {
+      service_layout.characteristics.insert_or_assign(
+          characteristic_uuid, characteristic.obj.AttributeHandle());
+    }
+  }
+  return layout;
+}
+
+// Owns the GattSession that ConnectAsync opens until the device agent takes
+// it over, so a failed connect never leaves MaintainConnection set.
+struct GattSessionGuard {
+  GattSession session{nullptr};
+  event_token max_pdu_size_changed_token{};
+
+  GattSessionGuard() = default;
+  GattSessionGuard(const GattSessionGuard &) = delete;
+  GattSessionGuard &operator=(const GattSessionGuard &) = delete;
+  ~GattSessionGuard() { Close(); }
+
+  void Close() {
+    if (!session) {
+      return;
+    }
+    try {
+      if (max_pdu_size_changed_token) {
+        session.MaxPduSizeChanged(max_pdu_size_changed_token);
+      }
+      session.Close();
+    } catch (...) {
+      log_and_swallow_unknown("GattSessionGuard: failed to close session");
+    }
+    session = nullptr;
+  }
+};
+
+// Typed access to the argument map of a "universal_ble/gatt" call. Missing
+// or mistyped required arguments throw kIllegalArgument.
+class GattCallArguments {
+public:
+  explicit GattCallArguments(const flutter::EncodableValue *arguments)
+      : map_(arguments == nullptr
+                 ? nullptr
+                 : std::get_if<flutter::EncodableMap>(arguments)) {}
+
+  std::string String(const char *key) const {
+    const auto *value = Find(key);
+    const auto *string =
+        value == nullptr ? nullptr : std::get_if<std::string>(value);
+    if (string == nullptr) {
+      throw Missing(key);
+    }
+    return *string;
+  }
+
+  bool Bool(const char *key) const {
+    const auto *value = Find(key);
+    const auto *flag = value == nullptr ? nullptr : std::get_if<bool>(value);
+    return flag != nullptr && *flag;
+  }
+
+  std::optional<int64_t> OptionalInt(const char *key) const {
+    const auto *value = Find(key);
+    if (value == nullptr) {
+      return std::nullopt;
+    }
+    if (!(std::holds_alternative<int32_t>(*value) ||
+          std::holds_alternative<int64_t>(*value))) {
+      throw Missing(key);
+    }
+    return value->LongValue();
+  }
+
+  int64_t Int(const char *key) const {
+    const auto value = OptionalInt(key);
+    if (!value.has_value()) {
+      throw Missing(key);
+    }
+    return value.value();
+  }
+
+  double Double(const char *key) const {
+    const auto *value = Find(key);
+    const auto *number =
+        value == nullptr ? nullptr : std::get_if<double>(value);
+    if (number == nullptr) {
+      throw Missing(key);
+    }
+    return *number;
+  }
+
+  // Dart enum index in [0, count).
+  int64_t Index(const char *key, int64_t count) const {
+    const auto *value = Find(key);
+    if (value == nullptr || !(std::holds_alternative<int32_t>(*value) ||
+                              std::holds_alternative<int64_t>(*value))) {
+      throw Missing(key);
+    }
+    const int64_t index = value->LongValue();
+    if (index < 0 || index >= count) {
+      throw Missing(key);
+    }
+    return index;
+  }
+
+private:
+  const flutter::EncodableValue *Find(const char *key) const {
+    if (map_ == nullptr) {
+      return nullptr;
+    }
+    const auto it = map_->find(flutter::EncodableValue(key));
+    return it == map_->end() || it->second.IsNull() ? nullptr : &it->second;
+  }
+
+  static FlutterError Missing(const char *key) {
+    return create_flutter_error(UniversalBleErrorCode::kIllegalArgument,
+                                std::string("Missing or invalid argument: ") +
+                                    key);
+  }
+
+  const flutter::EncodableMap *map_;
+};
+
+// The pigeon `timeoutMs` of a GATT call, or `fallback` when it is absent or
+// not positive.
+std::chrono::milliseconds
+call_timeout(const int64_t *timeout_ms,
+             const std::chrono::milliseconds fallback) {
+  return timeout_ms != nullptr && *timeout_ms > 0
+             ? std::chrono::milliseconds(*timeout_ms)
+             : fallback;
+}
 } // namespace
 
 void UniversalBlePlugin::RegisterWithRegistrar(
@@ -73,6 +282,9 @@ void UniversalBlePlugin::RegisterWithRegistrar(
   UniversalBlePeripheralChannel::SetUp(registrar->messenger(), plugin.get());
   callback_channel =
       std::make_unique<UniversalBleCallbackChannel>(registrar->messenger());
+  hot_callback_channels =
+      std::make_unique<UniversalBleCallbackChannels>(registrar->messenger());
+  notification_messenger = registrar->messenger();
   peripheral_callback_channel_ =
       std::make_unique<UniversalBlePeripheralCallback>(registrar->messenger());
   registrar->AddPlugin(std::move(plugin));
@@ -80,11 +292,68 @@ void UniversalBlePlugin::RegisterWithRegistrar(
 
 UniversalBlePlugin::UniversalBlePlugin(
     flutter::PluginRegistrarWindows *registrar)
-    : registrar_(registrar), ui_thread_handler_(registrar) {
+    : registrar_(registrar), ui_thread_handler_(registrar),
+      gatt_layout_cache_(
+          std::make_unique<GattLayoutCache>(data_directory() /
+                                            L"gatt_cache.txt")),
+      log_writer_(std::make_unique<UniversalBleLogWriter>(
+          data_directory() / L"universal_ble.log")) {
+  dispatcher_stats_channel_ =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          registrar->messenger(), "universal_ble/dispatcher_stats",
+          &flutter::StandardMessageCodec::GetInstance());
+  dispatcher_stats_channel_->SetMessageHandler(
+      [this](const flutter::EncodableValue &message,
+             const flutter::MessageReply<flutter::EncodableValue> &reply) {
+        const auto *request = std::get_if<std::string>(&message);
+        if (request != nullptr && *request == "trace") {
+          reply(flutter::EncodableValue(ui_thread_handler_.TraceJson()));
+          return;
+        }
+        reply(DispatcherStats());
+      });
+  native_log_channel_ =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          registrar->messenger(), "universal_ble/native_logs",
+          &flutter::StandardMessageCodec::GetInstance());
+  native_log_channel_->SetMessageHandler(
+      [this](const flutter::EncodableValue &message,
+             const flutter::MessageReply<flutter::EncodableValue> &reply) {
+        // BleLogLevel.index; none stops forwarding. Anything else is
+        // ignored.
+        std::optional<int64_t> level;
+        if (const auto *value = std::get_if<int32_t>(&message)) {
+          level = *value;
+        } else if (const auto *value = std::get_if<int64_t>(&message)) {
+          level = *value;
+        }
+        if (level.has_value() &&
+            level.value() >= static_cast<int64_t>(BleLogLevel::kNone) &&
+            level.value() <= static_cast<int64_t>(BleLogLevel::kVerbose)) {
+          SetNativeLogForwarding(static_cast<BleLogLevel>(level.value()));
+        }
+        reply(flutter::EncodableValue());
+      });
+  mtu_channel_ =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          registrar->messenger(), "universal_ble/mtu",
+          &flutter::StandardMessageCodec::GetInstance());
+  gatt_channel_ =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          registrar->messenger(), "universal_ble/gatt",
+          &flutter::StandardMethodCodec::GetInstance());
+  gatt_channel_->SetMethodCallHandler(
+      [this](const flutter::MethodCall<flutter::EncodableValue> &call,
+             std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
+                 result) { HandleGattCall(call, std::move(result)); });
   InitializeAsync();
 }
 
 UniversalBlePlugin::~UniversalBlePlugin() {
+  dispatcher_stats_channel_->SetMessageHandler(nullptr);
+  native_log_channel_->SetMessageHandler(nullptr);
+  gatt_channel_->SetMethodCallHandler(nullptr);
+  log_writer_->SetForwardSink(nullptr);
   ClearServices();
   peripheral_callback_channel_.reset();
 }
@@ -202,7 +471,7 @@ UniversalBlePlugin::StartScan(const UniversalScanFilter *filter,
       resetScanFilter();
 
       if (filter != nullptr) {
-        UniversalBleLogger::LogInfo("Using Custom Scan Filter");
+        UNIVERSAL_BLE_LOG_INFO(kScan, "Using Custom Scan Filter");
         setScanFilter(*filter);
       }
 
@@ -212,7 +481,7 @@ UniversalBlePlugin::StartScan(const UniversalScanFilter *filter,
     bluetooth_le_watcher_.Start();
     return std::nullopt;
   } catch (...) {
-    UniversalBleLogger::LogError("Unknown error StartScan");
+    UNIVERSAL_BLE_LOG_ERROR(kScan, "Unknown error StartScan");
     return create_flutter_error(UniversalBleErrorCode::kUnknownError,
                                 "Unknown error");
   }
@@ -228,11 +497,21 @@ std::optional<FlutterError> UniversalBlePlugin::StopScan() {
       bluetooth_le_watcher_ = nullptr;
       DisposeDeviceWatcher();
       scan_results_.clear();
+      UNIVERSAL_BLE_LOG_INFO(
+          kScan, "LATENCY scan_result " + scan_result_latency_.Summary());
+      UNIVERSAL_BLE_LOG_INFO(
+          kScan,
+          "LATENCY dispatch_control " +
+              ui_thread_handler_.QueueWait(UiThreadLane::kControl).Summary());
+      UNIVERSAL_BLE_LOG_INFO(
+          kScan, "LATENCY dispatch_bulk " +
+                 ui_thread_handler_.QueueWait(UiThreadLane::kBulk).Summary());
       return std::nullopt;
     } catch (const hresult_error &err) {
       const int error_code = err.code();
-      UniversalBleLogger::LogError("StopScanLog: " + to_string(err.message()) +
-                                   " ErrorCode: " + std::to_string(error_code));
+      UNIVERSAL_BLE_LOG_ERROR(
+          kScan, "StopScanLog: " + to_string(err.message()) + " ErrorCode: " +
+                 std::to_string(error_code));
       return create_flutter_error(UniversalBleErrorCode::kFailed,
                                   to_string(err.message()),
                                   std::to_string(error_code));
@@ -264,7 +543,7 @@ UniversalBlePlugin::GetConnectionState(const std::string &device_id) {
     return BleConnectionState::kDisconnected;
   }
 
-  const auto device_agent = *it->second;
+  const auto &device_agent = *it->second;
 
   if (device_agent.device.ConnectionStatus() ==
       BluetoothConnectionStatus::Connected) {
@@ -275,8 +554,19 @@ UniversalBlePlugin::GetConnectionState(const std::string &device_id) {
 }
 
 std::optional<FlutterError>
-UniversalBlePlugin::SetLogLevel(const BleLogLevel &log_level) {
-  UniversalBleLogger::SetLogLevel(log_level);
+UniversalBlePlugin::SetLogLevel(const BleLogLevel &log_level,
+                                const int64_t *category) {
+  if (category != nullptr) {
+    // BleLogCategory.index; unknown categories are ignored.
+    if (*category >= 0 &&
+        *category < static_cast<int64_t>(kLogCategoryCount)) {
+      SetCategoryLogLevel(static_cast<LogCategory>(*category), log_level);
+    }
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < kLogCategoryCount; ++i) {
+    SetCategoryLogLevel(static_cast<LogCategory>(i), log_level);
+  }
   return std::nullopt;
 }
 
@@ -295,163 +585,142 @@ UniversalBlePlugin::Disconnect(const std::string &device_id) {
   auto device_address = str_to_mac_address(device_id);
   const auto it = connected_devices_.find(device_address);
   if (it != connected_devices_.end()) {
+    CloseGattSession(*it->second);
     it->second->device.Close();
     DisposeServices(it->second);
   } else {
-    ui_thread_handler_.Post([device_id] {
-      callback_channel->OnConnectionChanged(device_id, false, nullptr,
-                                            SuccessCallback, ErrorCallback);
-    });
+    ui_thread_handler_.Post(
+        [device_id] {
+          callback_channel->OnConnectionChanged(
+              device_id, false, nullptr, SuccessCallback, ErrorCallback);
+        },
+        UiCallbackKind::kConnection);
   }
   return std::nullopt;
 }
 
 void UniversalBlePlugin::DiscoverServices(
     const std::string &device_id, bool with_descriptors,
+    const int64_t *timeout_ms,
     std::function<void(ErrorOr<flutter::EncodableList> reply)> result) {
-  DiscoverServicesAsync(device_id, with_descriptors, result);
+  DiscoverServicesAsync(
+      device_id, with_descriptors,
+      call_timeout(timeout_ms, gatt_timeouts_.discover_services), result);
 }
 
 void UniversalBlePlugin::SetNotifiable(
     const std::string &device_id, const std::string &service,
     const std::string &characteristic,
-    const BleInputProperty &ble_input_property,
+    const BleInputProperty &ble_input_property, const int64_t *timeout_ms,
     std::function<void(std::optional<FlutterError> reply)> result) {
   SetNotifiableAsync(device_id, service, characteristic, ble_input_property,
+                     call_timeout(timeout_ms, gatt_timeouts_.set_notifiable),
                      result);
 };
 
 void UniversalBlePlugin::ReadValue(
     const std::string &device_id, const std::string &service,
-    const std::string &characteristic,
+    const std::string &characteristic, const int64_t *timeout_ms,
     std::function<void(ErrorOr<std::vector<uint8_t>> reply)> result) {
-  UniversalBleLogger::LogDebugWithTimestamp("READ -> " + device_id + " " +
-                                            service + " " + characteristic);
-  try {
-    const auto it = connected_devices_.find(str_to_mac_address(device_id));
-    if (it == connected_devices_.end()) {
-      result(create_flutter_error(UniversalBleErrorCode::kDeviceNotFound,
-                                  "Unknown devicesId:" + device_id));
-      return;
-    }
-
-    auto bluetooth_agent = *it->second;
-    const GattCharacteristicObject &gatt_characteristic_holder =
-        bluetooth_agent.FetchCharacteristic(service, characteristic);
-    const GattCharacteristic gatt_characteristic =
-        gatt_characteristic_holder.obj;
-
-    const auto properties = gatt_characteristic.CharacteristicProperties();
-    if ((properties & GattCharacteristicProperties::Read) ==
-        GattCharacteristicProperties::None) {
-      result(create_flutter_error(
-          UniversalBleErrorCode::kCharacteristicDoesNotSupportRead,
-          "Characteristic does not support read"));
-      return;
-    }
-
-    gatt_characteristic.ReadValueAsync(BluetoothCacheMode::Uncached)
-        .Completed([&, result](IAsyncOperation<GattReadResult> const &sender,
-                               AsyncStatus const args) {
-          const auto read_value_result = sender.GetResults();
-          const auto status = read_value_result.Status();
-          if (status != GattCommunicationStatus::Success) {
-            UniversalBleLogger::LogError(
-                "READ_FAILED <- " + device_id + " " + service + " " +
-                characteristic +
-                " status=" + std::to_string(static_cast<int>(status)));
-            result(create_flutter_error_from_gatt_communication_status(status));
-          } else {
-            result(to_bytevc(read_value_result.Value()));
-          }
-        });
-  } catch (const FlutterError &err) {
-    return result(err);
-  } catch (...) {
-    UniversalBleLogger::LogError("ReadValueLog: Unknown error");
-    return result(create_flutter_unknown_error());
-  }
+  ReadValueAsync(device_id, service, characteristic,
+                 call_timeout(timeout_ms, gatt_timeouts_.read), result);
 }
 
 void UniversalBlePlugin::WriteValue(
     const std::string &device_id, const std::string &service,
     const std::string &characteristic, const std::vector<uint8_t> &value,
-    const BleOutputProperty &ble_output_property,
+    const BleOutputProperty &ble_output_property, const int64_t *timeout_ms,
     std::function<void(std::optional<FlutterError> reply)> result) {
-  UniversalBleLogger::LogDebugWithTimestamp(
-      "WRITE -> " + device_id + " " + service + " " + characteristic +
-      " len=" + std::to_string(value.size()) +
-      " property=" + std::to_string(static_cast<int>(ble_output_property)));
-  try {
-    const auto it = connected_devices_.find(str_to_mac_address(device_id));
-    if (it == connected_devices_.end()) {
-      result(create_flutter_error(UniversalBleErrorCode::kDeviceNotFound,
-                                  "Unknown devicesId:" + device_id));
-      return;
-    }
-    auto bluetooth_agent = *it->second;
-    const GattCharacteristicObject &gatt_characteristic_holder =
-        bluetooth_agent.FetchCharacteristic(service, characteristic);
-    const GattCharacteristic gatt_characteristic =
-        gatt_characteristic_holder.obj;
-    const auto properties = gatt_characteristic.CharacteristicProperties();
+  WriteValueAsync(device_id, service, characteristic, value,
+                  ble_output_property,
+                  call_timeout(timeout_ms, gatt_timeouts_.write), result);
+}
 
-    auto write_option = GattWriteOption::WriteWithResponse;
-    if (ble_output_property == BleOutputProperty::kWithoutResponse) {
-      write_option = GattWriteOption::WriteWithoutResponse;
-      if ((properties & GattCharacteristicProperties::WriteWithoutResponse) ==
-          GattCharacteristicProperties::None) {
-        result(create_flutter_error(
-            UniversalBleErrorCode::
-                kCharacteristicDoesNotSupportWriteWithoutResponse,
-            "Characteristic does not support WriteWithoutResponse"));
-        return;
+void UniversalBlePlugin::HandleGattCall(
+    const flutter::MethodCall<flutter::EncodableValue> &call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  // Options that outlive a single call; the GATT operations themselves,
+  // with their per-call timeout, go through the pigeon API.
+  try {
+    const GattCallArguments arguments(call.arguments());
+    const std::string &method = call.method_name();
+    if (method == "setDeviceOptions") {
+      // Replaces every option of the device; see WindowsGattOptions.
+      DeviceGattOptions options;
+      options.persist_layout = arguments.Bool("persistGattLayout");
+      options.read_cache.policy = static_cast<ReadCachePolicy>(
+          arguments.Index("readCachePolicy", 3));
+      if (const auto max_age_ms = arguments.OptionalInt("readCacheMaxAgeMs")) {
+        options.read_cache.max_age =
+            std::chrono::milliseconds(std::max<int64_t>(0, *max_age_ms));
       }
-    } else {
-      if ((properties & GattCharacteristicProperties::Write) ==
-          GattCharacteristicProperties::None) {
-        result(create_flutter_error(
-            UniversalBleErrorCode::kCharacteristicDoesNotSupportWrite,
-            "Characteristic does not support Write"));
-        return;
+      options.discovery.mode = static_cast<GattDiscoveryMode>(
+          arguments.Index("discoveryMode", 2));
+      options.discovery.max_parallel_requests = static_cast<size_t>(
+          std::max<int64_t>(1, arguments.Int("maxParallelDiscoveryRequests")));
+      const uint64_t bluetooth_address =
+          str_to_mac_address(arguments.String("deviceId"));
+      if (options.read_cache.policy != ReadCachePolicy::kNativeCache) {
+        value_cache_.InvalidateDevice(bluetooth_address);
       }
+      device_gatt_options_.insert_or_assign(bluetooth_address, options);
+      result->Success();
+    } else if (method == "setNotificationOptions") {
+      // Replaces every option of the characteristic; see
+      // WindowsNotificationOptions.
+      NotificationOptions options;
+      options.batch.enabled = arguments.Bool("batch");
+      options.batch.max_entries = static_cast<size_t>(
+          std::max<int64_t>(1, arguments.Int("batchMaxEntries")));
+      options.batch.max_delay = std::chrono::milliseconds(
+          std::max<int64_t>(0, arguments.Int("batchMaxDelayMs")));
+      options.buffer.capacity = static_cast<size_t>(
+          std::max<int64_t>(1, arguments.Int("bufferCapacity")));
+      options.buffer.policy = static_cast<BackpressurePolicy>(
+          arguments.Index("backpressurePolicy", 3));
+      options.buffer.max_block = std::chrono::milliseconds(
+          std::max<int64_t>(0, arguments.Int("maxBlockMs")));
+      options.transport = static_cast<NotificationTransport>(
+          arguments.Index("transport", 2));
+      options.framing.mode =
+          static_cast<FramingMode>(arguments.Index("framing", 4));
+      options.framing.check =
+          static_cast<FrameCheck>(arguments.Index("frameCheck", 2));
+      options.framing.max_frame_size = static_cast<size_t>(
+          std::max<int64_t>(1, arguments.Int("maxFrameSize")));
+      options.framing.prefix_size = static_cast<size_t>(std::clamp<int64_t>(
+          arguments.Int("lengthPrefixSize"), 1, sizeof(size_t)));
+      options.framing.prefix_big_endian =
+          arguments.Bool("lengthPrefixBigEndian");
+      options.framing.length_includes_prefix =
+          arguments.Bool("lengthIncludesPrefix");
+      options.filter.mode =
+          static_cast<NotificationFilterMode>(arguments.Index("filter", 4));
+      options.filter.max_rate_hz =
+          std::max(0.0, arguments.Double("filterMaxRateHz"));
+      options.filter.every_nth = static_cast<uint32_t>(std::clamp<int64_t>(
+          arguments.Int("filterEveryNth"), 1,
+          std::numeric_limits<uint32_t>::max()));
+      notification_options_.insert_or_assign(
+          std::make_tuple(str_to_mac_address(arguments.String("deviceId")),
+                          arguments.String("service"),
+                          arguments.String("characteristic")),
+          std::move(options));
+      result->Success();
+    } else {
+      result->NotImplemented();
     }
-
-    gatt_characteristic.WriteValueAsync(from_bytevc(value), write_option)
-        .Completed([&, result](
-                       IAsyncOperation<GattCommunicationStatus> const &sender,
-                       AsyncStatus const args) {
-          if (args == AsyncStatus::Error) {
-            result(create_flutter_error(UniversalBleErrorCode::kFailed,
-                                        "Encountered an error."));
-            return;
-          }
-
-          const auto status = sender.GetResults();
-          if (status != GattCommunicationStatus::Success) {
-            UniversalBleLogger::LogError(
-                "WRITE_FAILED <- " + device_id + " " + service + " " +
-                characteristic +
-                " status=" + std::to_string(static_cast<int>(status)));
-            result(create_flutter_error_from_gatt_communication_status(status));
-          } else {
-            result(std::nullopt);
-          }
-        });
-  } catch (const FlutterError &err) {
-    result(err);
-  } catch (...) {
-    UniversalBleLogger::LogError("WriteValue: Unknown error");
-    result(create_flutter_unknown_error());
+  } catch (const FlutterError &error) {
+    result->Error(error.code(), error.message(), error.details());
   }
 }
 
 void UniversalBlePlugin::RequestMtu(
     const std::string &device_id, int64_t expected_mtu,
     std::function<void(ErrorOr<int64_t> reply)> result) {
-  UniversalBleLogger::LogDebugWithTimestamp(
-      "REQUEST_MTU -> " + device_id +
-      " expected=" + std::to_string(expected_mtu));
+  UNIVERSAL_BLE_LOG_DEBUG_TS(
+      kGatt, "REQUEST_MTU -> " + device_id + " expected=" +
+             std::to_string(expected_mtu));
   try {
     const auto it = connected_devices_.find(str_to_mac_address(device_id));
     if (it == connected_devices_.end()) {
@@ -459,10 +728,15 @@ void UniversalBlePlugin::RequestMtu(
                                   "Unknown devicesId:" + device_id));
       return;
     }
-    const auto bluetooth_agent = *it->second;
-    GattSession::FromDeviceIdAsync(bluetooth_agent.device.BluetoothDeviceId())
-        .Completed([&, result](IAsyncOperation<GattSession> const &sender,
-                               AsyncStatus const args) {
+    // Answered from the session held by the agent, when there is one.
+    if (const uint16_t max_pdu_size = it->second->max_pdu_size->load();
+        max_pdu_size > 0) {
+      result(static_cast<int64_t>(max_pdu_size));
+      return;
+    }
+    GattSession::FromDeviceIdAsync(it->second->device.BluetoothDeviceId())
+        .Completed([result](IAsyncOperation<GattSession> const &sender,
+                            AsyncStatus const args) {
           if (args == AsyncStatus::Error) {
             result(create_flutter_unknown_error());
             return;
@@ -564,7 +838,7 @@ fire_and_forget UniversalBlePlugin::InitializeAsync() {
     }
   }
   if (!bluetooth_radio_) {
-    UniversalBleLogger::LogError("Bluetooth is not available");
+    UNIVERSAL_BLE_LOG_ERROR(kGeneral, "Bluetooth is not available");
     ui_thread_handler_.Post([] {
       callback_channel->OnAvailabilityChanged(AvailabilityState::kUnsupported,
                                               SuccessCallback, ErrorCallback);
@@ -577,7 +851,7 @@ fire_and_forget UniversalBlePlugin::PairAsync(
     const std::string &device_id,
     const std::function<void(ErrorOr<bool> reply)> result) {
   try {
-    UniversalBleLogger::LogInfo("Trying to pair");
+    UNIVERSAL_BLE_LOG_INFO(kPairing, "Trying to pair");
 
     const auto device = co_await BluetoothLEDevice::FromBluetoothAddressAsync(
         str_to_mac_address(device_id));
@@ -587,7 +861,7 @@ fire_and_forget UniversalBlePlugin::PairAsync(
       co_return;
     }
 
-    UniversalBleLogger::LogInfo("Got device");
+    UNIVERSAL_BLE_LOG_INFO(kPairing, "Got device");
 
     const auto device_information = device.DeviceInformation();
     if (device_information.Pairing().IsPaired())
@@ -598,7 +872,7 @@ fire_and_forget UniversalBlePlugin::PairAsync(
     else {
       const auto pair_result =
           co_await device_information.Pairing().PairAsync();
-      UniversalBleLogger::LogInfo("PairLog: Received pairing status");
+      UNIVERSAL_BLE_LOG_INFO(kPairing, "PairLog: Received pairing status");
       bool is_paired =
           pair_result.Status() == DevicePairingResultStatus::Paired;
       result(is_paired);
@@ -609,20 +883,23 @@ fire_and_forget UniversalBlePlugin::PairAsync(
       if (error_str.has_value()) {
         captured_error = error_str.value();
       }
-      ui_thread_handler_.Post([device_id, is_paired, captured_error] {
-        const std::string *error_msg = nullptr;
-        std::string error_string;
-        if (captured_error.has_value()) {
-          error_string = captured_error.value();
-          error_msg = &error_string;
-        }
-        callback_channel->OnPairStateChange(device_id, is_paired, error_msg,
-                                            SuccessCallback, ErrorCallback);
-      });
+      ui_thread_handler_.Post(
+          [device_id, is_paired, captured_error] {
+            const std::string *error_msg = nullptr;
+            std::string error_string;
+            if (captured_error.has_value()) {
+              error_string = captured_error.value();
+              error_msg = &error_string;
+            }
+            callback_channel->OnPairStateChange(device_id, is_paired,
+                                                error_msg, SuccessCallback,
+                                                ErrorCallback);
+          },
+          UiCallbackKind::kConnection);
     }
   } catch (...) {
     result(false);
-    UniversalBleLogger::LogError("PairLog: Unknown error");
+    UNIVERSAL_BLE_LOG_ERROR(kPairing, "PairLog: Unknown error");
   }
 }
 
@@ -647,7 +924,7 @@ fire_and_forget UniversalBlePlugin::CustomPairAsync(
       const auto custom_pairing = device_information.Pairing().Custom();
       const event_token token = custom_pairing.PairingRequested(
           {this, &UniversalBlePlugin::PairingRequestedHandler});
-      UniversalBleLogger::LogInfo("PairLog: Trying to pair");
+      UNIVERSAL_BLE_LOG_INFO(kPairing, "PairLog: Trying to pair");
       const DevicePairingProtectionLevel protection_level =
           device_information.Pairing().ProtectionLevel();
       // DevicePairingKinds => None, ConfirmOnly, DisplayPin, ProvidePin,
@@ -655,7 +932,7 @@ fire_and_forget UniversalBlePlugin::CustomPairAsync(
       const auto pair_result = co_await custom_pairing.PairAsync(
           DevicePairingKinds::ConfirmOnly | DevicePairingKinds::ProvidePin,
           protection_level);
-      UniversalBleLogger::LogInfo("PairLog: Got Pair Result");
+      UNIVERSAL_BLE_LOG_INFO(kPairing, "PairLog: Got Pair Result");
       const DevicePairingResultStatus status = pair_result.Status();
       custom_pairing.PairingRequested(token);
       bool is_paired = status == DevicePairingResultStatus::Paired;
@@ -666,20 +943,23 @@ fire_and_forget UniversalBlePlugin::CustomPairAsync(
       if (error_str.has_value()) {
         captured_error = error_str.value();
       }
-      ui_thread_handler_.Post([device_id, is_paired, captured_error] {
-        const std::string *error_msg = nullptr;
-        std::string error_string;
-        if (captured_error.has_value()) {
-          error_string = captured_error.value();
-          error_msg = &error_string;
-        }
-        callback_channel->OnPairStateChange(device_id, is_paired, error_msg,
-                                            SuccessCallback, ErrorCallback);
-      });
+      ui_thread_handler_.Post(
+          [device_id, is_paired, captured_error] {
+            const std::string *error_msg = nullptr;
+            std::string error_string;
+            if (captured_error.has_value()) {
+              error_string = captured_error.value();
+              error_msg = &error_string;
+            }
+            callback_channel->OnPairStateChange(device_id, is_paired,
+                                                error_msg, SuccessCallback,
+                                                ErrorCallback);
+          },
+          UiCallbackKind::kConnection);
     }
   } catch (...) {
     result(false);
-    UniversalBleLogger::LogError("PairLog Error: Pairing Failed");
+    UNIVERSAL_BLE_LOG_ERROR(kPairing, "PairLog Error: Pairing Failed");
   }
 }
 
@@ -687,16 +967,16 @@ fire_and_forget UniversalBlePlugin::CustomPairAsync(
 void UniversalBlePlugin::PairingRequestedHandler(
     DeviceInformationCustomPairing sender,
     const DevicePairingRequestedEventArgs &event_args) {
-  UniversalBleLogger::LogInfo("PairLog: Got PairingRequest");
+  UNIVERSAL_BLE_LOG_INFO(kPairing, "PairLog: Got PairingRequest");
   const DevicePairingKinds kind = event_args.PairingKind();
   if (kind != DevicePairingKinds::ProvidePin) {
     event_args.Accept();
     return;
   }
 
-  UniversalBleLogger::LogInfo("PairLog: Trying to get pin from user");
+  UNIVERSAL_BLE_LOG_INFO(kPairing, "PairLog: Trying to get pin from user");
   const hstring pin = askForPairingPin();
-  UniversalBleLogger::LogInfo("PairLog: Got Pin: " + to_string(pin));
+  UNIVERSAL_BLE_LOG_INFO(kPairing, "PairLog: Got Pin: " + to_string(pin));
   event_args.Accept(pin);
 }
 
@@ -765,7 +1045,8 @@ UniversalBlePlugin::ExpandServiceUuid(const std::vector<uint8_t> &uuid_bytes,
 // Send device to callback channel
 // if device is already discovered in deviceWatcher then merge the scan result
 void UniversalBlePlugin::PushUniversalScanResult(
-    UniversalBleScanResult scan_result, const bool is_connectable) {
+    UniversalBleScanResult scan_result, const bool is_connectable,
+    const int64_t arrival_micros) {
   const std::optional<UniversalBleScanResult> it =
       scan_results_.get(scan_result.device_id());
   if (it.has_value()) {
@@ -820,11 +1101,14 @@ void UniversalBlePlugin::PushUniversalScanResult(
 
   // Filter final result before sending to Flutter
   if (is_connectable && filterDevice(scan_result)) {
-    scan_result.set_timestamp(GetCurrentTimestampMillis());
-    ui_thread_handler_.Post([scan_result] {
-      callback_channel->OnScanResult(scan_result, SuccessCallback,
-                                     ErrorCallback);
-    });
+    scan_result.set_timestamp(UniversalBleClock::ToMillis(arrival_micros));
+    ui_thread_handler_.Post(
+        [this, scan_result = std::move(scan_result), arrival_micros] {
+          hot_callback_channels->OnScanResult(scan_result);
+          scan_result_latency_.Record(UniversalBleClock::NowMicros() -
+                                      arrival_micros);
+        },
+        UiCallbackKind::kScan);
   }
 }
 
@@ -905,7 +1189,8 @@ void UniversalBlePlugin::SetupDeviceWatcher() {
   device_watcher_enumeration_completed_token_ =
       device_watcher_.EnumerationCompleted([this](DeviceWatcher sender,
                                                   IInspectable args) {
-        UniversalBleLogger::LogInfo("DeviceWatcherEvent: EnumerationCompleted");
+        UNIVERSAL_BLE_LOG_INFO(
+            kScan, "DeviceWatcherEvent: EnumerationCompleted");
         DisposeDeviceWatcher();
         // EnumerationCompleted
       });
@@ -989,7 +1274,8 @@ void UniversalBlePlugin::OnDeviceInfoReceived(
       }
     }
 
-    PushUniversalScanResult(universal_scan_result, true);
+    PushUniversalScanResult(universal_scan_result, true,
+                            UniversalBleClock::NowMicros());
   }
 }
 
@@ -997,6 +1283,7 @@ void UniversalBlePlugin::OnDeviceInfoReceived(
 void UniversalBlePlugin::BluetoothLeWatcherReceived(
     const BluetoothLEAdvertisementWatcher &,
     const BluetoothLEAdvertisementReceivedEventArgs &args) {
+  const int64_t arrival_micros = UniversalBleClock::NowMicros();
   try {
     auto device_id = mac_address_to_str(args.BluetoothAddress());
     auto universal_scan_result = UniversalBleScanResult(device_id);
@@ -1129,9 +1416,10 @@ void UniversalBlePlugin::BluetoothLeWatcherReceived(
     }
 
     // Filter Device
-    PushUniversalScanResult(universal_scan_result, args.IsConnectable());
+    PushUniversalScanResult(universal_scan_result, args.IsConnectable(),
+                            arrival_micros);
   } catch (...) {
-    UniversalBleLogger::LogError("ScanResultErrorInParsing");
+    UNIVERSAL_BLE_LOG_ERROR(kScan, "ScanResultErrorInParsing");
   }
 }
 
@@ -1153,88 +1441,98 @@ void UniversalBlePlugin::RadioStateChanged(const Radio &sender,
 void UniversalBlePlugin::NotifyConnectionChanged(
     const uint64_t bluetooth_address, const bool connected,
     std::optional<std::string> error) {
-  ui_thread_handler_.Post([bluetooth_address, connected,
-                           error = std::move(error)] {
-    const std::string *error_ptr = error.has_value() ? &error.value() : nullptr;
-    callback_channel->OnConnectionChanged(mac_address_to_str(bluetooth_address),
-                                          connected, error_ptr, SuccessCallback,
-                                          ErrorCallback);
-  });
+  ui_thread_handler_.Post(
+      [bluetooth_address, connected, error = std::move(error)] {
+        const std::string *error_ptr =
+            error.has_value() ? &error.value() : nullptr;
+        callback_channel->OnConnectionChanged(
+            mac_address_to_str(bluetooth_address), connected, error_ptr,
+            SuccessCallback, ErrorCallback);
+      },
+      UiCallbackKind::kConnection);
 }
 
 void UniversalBlePlugin::NotifyConnectionException(
     const uint64_t bluetooth_address, const std::string &error_message) {
-  UniversalBleLogger::LogError(error_message);
+  UNIVERSAL_BLE_LOG_ERROR(kGeneral, error_message);
   if (bluetooth_address != 0) {
     CleanConnection(bluetooth_address);
     NotifyConnectionChanged(bluetooth_address, false, error_message);
   }
 }
 
+void UniversalBlePlugin::NotifyMtuChanged(const uint64_t bluetooth_address,
+                                          const uint16_t mtu) {
+  UNIVERSAL_BLE_LOG_INFO(kGeneral, "MTU_CHANGED <- " +
+                                   mac_address_to_str(bluetooth_address) +
+                                   " mtu=" + std::to_string(mtu));
+  ui_thread_handler_.Post(
+      [this, bluetooth_address, mtu] {
+        mtu_channel_->Send(flutter::EncodableValue(flutter::EncodableList{
+            flutter::EncodableValue(mac_address_to_str(bluetooth_address)),
+            flutter::EncodableValue(static_cast<int64_t>(mtu)),
+        }));
+      },
+      UiCallbackKind::kConnection);
+}
+
 fire_and_forget UniversalBlePlugin::ConnectAsync(uint64_t bluetooth_address) {
   try {
+    const auto connect_started = std::chrono::steady_clock::now();
     BluetoothLEDevice device =
         co_await BluetoothLEDevice::FromBluetoothAddressAsync(
             bluetooth_address);
     if (!device) {
-      UniversalBleLogger::LogError(
-          "ConnectionLog: ConnectionFailed: Failed to get device");
+      UNIVERSAL_BLE_LOG_ERROR(
+          kGeneral, "ConnectionLog: ConnectionFailed: Failed to get device");
       NotifyConnectionChanged(bluetooth_address, false,
                               std::string("Failed to get device"));
       co_return;
     }
-    UniversalBleLogger::LogInfo("ConnectionLog: Device found");
-    auto services_result =
-        co_await device.GetGattServicesAsync((BluetoothCacheMode::Uncached));
-    auto services_result_error =
-        gatt_communication_status_to_error(services_result.Status());
-    if (services_result_error.has_value()) {
-      UniversalBleLogger::LogError(
-          "ConnectionFailed: Failed to get services: " +
-          services_result_error.value());
-      NotifyConnectionChanged(bluetooth_address, false,
-                              services_result_error.value());
-      co_return;
-    }
+    UNIVERSAL_BLE_LOG_INFO(kGeneral, "ConnectionLog: Device found");
 
-    UniversalBleLogger::LogInfo("ConnectionLog: Services discovered");
-    std::unordered_map<std::string, GattServiceObject> gatt_map;
-    auto gatt_services = services_result.Services();
-    for (GattDeviceService &&service : gatt_services) {
-      try {
-        GattServiceObject gatt_service;
-        gatt_service.obj = service;
-        std::string service_uuid = guid_to_uuid(service.Uuid());
-        auto characteristics_result = co_await service.GetCharacteristicsAsync(
-            BluetoothCacheMode::Uncached);
-        auto characteristics_result_error =
-            gatt_communication_status_to_error(characteristics_result.Status());
-
-        if (characteristics_result_error.has_value()) {
-          UniversalBleLogger::LogError(
-              "Failed to get characteristics for service: " + service_uuid +
-              ", With Status: " + characteristics_result_error.value());
-          continue;
-        }
-        auto gatt_characteristics = characteristics_result.Characteristics();
-        for (GattCharacteristic &&characteristic : gatt_characteristics) {
-          GattCharacteristicObject gatt_characteristic;
-          gatt_characteristic.obj = characteristic;
-          gatt_characteristic.subscription_token = std::nullopt;
-          std::string characteristic_uuid = guid_to_uuid(characteristic.Uuid());
-          gatt_service.characteristics.insert_or_assign(
-              characteristic_uuid, std::move(gatt_characteristic));
-        }
-        gatt_map.insert_or_assign(service_uuid, std::move(gatt_service));
-      } catch (const hresult_error &err) {
-        UniversalBleLogger::LogError(
-            "ConnectAsync service loop hresult_error hr=" +
-            std::to_string(err.code()) + " msg=" + to_string(err.message()));
-      } catch (const std::exception &ex) {
-        UniversalBleLogger::LogError(
-            std::string("ConnectAsync service loop exception: ") + ex.what());
-      } catch (...) {
-        UniversalBleLogger::LogError("ConnectAsync service loop unknown error");
+    // The session is opened before discovery so the link is held for it.
+    // The guard closes it on every exit until the agent takes it over.
+    GattSessionGuard gatt_session;
+    const auto max_pdu_size = std::make_shared<std::atomic<uint16_t>>(0);
+    try {
+      gatt_session.session =
+          co_await GattSession::FromDeviceIdAsync(device.BluetoothDeviceId());
+      gatt_session.session.MaintainConnection(true);
+      max_pdu_size->store(gatt_session.session.MaxPduSize());
+      gatt_session.max_pdu_size_changed_token =
+          gatt_session.session.MaxPduSizeChanged(
+              [this, bluetooth_address, max_pdu_size](
+                  const GattSession &session, const IInspectable &) {
+                try {
+                  const uint16_t size = session.MaxPduSize();
+                  if (max_pdu_size->exchange(size) != size) {
+                    NotifyMtuChanged(bluetooth_address, size);
+                  }
+                } catch (...) {
+                }
+              });
+    } catch (const hresult_error &err) {
+      // Not fatal: RequestMtu falls back to a one-off session.
+      UNIVERSAL_BLE_LOG_ERROR(
+          kGeneral, "ConnectionLog: GattSession unavailable hr=" +
+                    std::to_string(err.code()) + " msg=" +
+                    to_string(err.message()));
+      gatt_session.Close();
+    }
+
+    const GattDiscoveryMode discovery_mode =
+        GattOptions(bluetooth_address).discovery.mode;
+    auto discovery = std::make_shared<GattDiscoveryResult>();
+    if (discovery_mode != GattDiscoveryMode::kOnDemand) {
+      co_await DiscoverGattWithCacheAsync(device, bluetooth_address,
+                                          gatt_timeouts_.discover_services,
+                                          discovery);
+      if (discovery->error.has_value()) {
+        gatt_session.Close();
+        NotifyConnectionChanged(bluetooth_address, false,
+                                discovery->error->message());
+        co_return;
       }
     }
 
@@ -1242,11 +1540,36 @@ fire_and_forget UniversalBlePlugin::ConnectAsync(uint64_t bluetooth_address) {
         device.ConnectionStatusChanged(
             {this,
              &UniversalBlePlugin::BluetoothLeDeviceConnectionStatusChanged});
+    // Windows raises this when the peripheral indicates Service Changed.
+    event_token gatt_services_changed_token = device.GattServicesChanged(
+        [this, bluetooth_address](const BluetoothLEDevice &,
+                                  const IInspectable &) {
+          UNIVERSAL_BLE_LOG_INFO(
+              kGeneral, "GattServicesChanged: invalidating cached layout of " +
+                        mac_address_to_str(bluetooth_address));
+          gatt_layout_cache_->Invalidate(bluetooth_address);
+        });
     auto device_agent = std::make_unique<BluetoothDeviceAgent>(
-        device, connection_status_changed_token, gatt_map);
+        device, connection_status_changed_token,
+        std::move(discovery->gatt_map));
+    device_agent->gatt_services_changed_token = gatt_services_changed_token;
+    device_agent->max_pdu_size_changed_token =
+        gatt_session.max_pdu_size_changed_token;
+    device_agent->gatt_session = std::exchange(gatt_session.session, nullptr);
+    device_agent->max_pdu_size = max_pdu_size;
+    device_agent->gatt_discovered =
+        discovery_mode != GattDiscoveryMode::kOnDemand;
+    device_agent->discovery_timings = discovery->timings;
     auto pair = std::make_pair(bluetooth_address, std::move(device_agent));
     connected_devices_.insert(std::move(pair));
-    UniversalBleLogger::LogInfo("ConnectionLog: Connected");
+    UNIVERSAL_BLE_LOG_INFO(
+        kGeneral,
+        "ConnectionLog: Connected in " +
+            std::to_string(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - connect_started)
+                    .count()) +
+            "ms");
     NotifyConnectionChanged(bluetooth_address, true, std::nullopt);
   } catch (const hresult_error &err) {
     NotifyConnectionException(
@@ -1263,6 +1586,470 @@ fire_and_forget UniversalBlePlugin::ConnectAsync(uint64_t bluetooth_address) {
   }
 }
 
+IAsyncAction UniversalBlePlugin::DiscoverGattWithCacheAsync(
+    const BluetoothLEDevice device, const uint64_t bluetooth_address,
+    const std::chrono::milliseconds timeout,
+    std::shared_ptr<GattDiscoveryResult> out) {
+  // Runs as IAsyncAction, so nothing may escape: errors go into `out`.
+  try {
+    if (!GattOptions(bluetooth_address).persist_layout) {
+      co_await DiscoverGattAsync(device, bluetooth_address,
+                                 BluetoothCacheMode::Uncached, timeout, out);
+      co_return;
+    }
+    const auto cached_layout = gatt_layout_cache_->Get(bluetooth_address);
+    co_await DiscoverGattAsync(device, bluetooth_address,
+                               cached_layout.has_value()
+                                   ? BluetoothCacheMode::Cached
+                                   : BluetoothCacheMode::Uncached,
+                               timeout, out);
+    if (out->error.has_value()) {
+      co_return;
+    }
+
+    GattLayout layout = to_gatt_layout(out->gatt_map);
+    if (const auto hash = co_await ReadDatabaseHashAsync(out)) {
+      layout.database_hash = to_bytevc(hash);
+    }
+
+    if (cached_layout.has_value()) {
+      // Trusted only while the cached discovery has the same attribute
+      // handles and, if the peripheral has one, it reports the same
+      // Database Hash over the air.
+      const bool validated =
+          out->complete &&
+          layout.database_hash == cached_layout->database_hash &&
+          layout == cached_layout.value();
+      if (validated) {
+        UNIVERSAL_BLE_LOG_INFO(
+            kGatt, "DiscoveryLog: cached GATT layout of " +
+                   mac_address_to_str(bluetooth_address) + " is current");
+        co_return;
+      }
+      UNIVERSAL_BLE_LOG_INFO(kGatt, "DiscoveryLog: cached GATT layout of " +
+                                    mac_address_to_str(bluetooth_address) +
+                                    " is stale, rediscovering");
+      auto uncached = std::make_shared<GattDiscoveryResult>();
+      co_await DiscoverGattAsync(device, bluetooth_address,
+                                 BluetoothCacheMode::Uncached, timeout,
+                                 uncached);
+      *out = std::move(*uncached);
+      if (out->error.has_value()) {
+        gatt_layout_cache_->Invalidate(bluetooth_address);
+        co_return;
+      }
+      layout = to_gatt_layout(out->gatt_map);
+      if (const auto hash = co_await ReadDatabaseHashAsync(out)) {
+        layout.database_hash = to_bytevc(hash);
+      }
+    }
+    // A partial layout would hide services.
+    if (out->complete) {
+      gatt_layout_cache_->Put(bluetooth_address, layout);
+    } else {
+      gatt_layout_cache_->Invalidate(bluetooth_address);
+    }
+  } catch (const hresult_error &err) {
+    out->error = create_flutter_error(
+        UniversalBleErrorCode::kFailed,
+        "DiscoverGattWithCacheAsync hresult_error msg=" +
+            to_string(err.message()),
+        "hr=" + std::to_string(err.code()));
+  } catch (...) {
+    out->error = create_flutter_error(
+        UniversalBleErrorCode::kUnknownError,
+        "DiscoverGattWithCacheAsync unknown exception");
+  }
+}
+
+IAsyncOperation<IBuffer> UniversalBlePlugin::ReadDatabaseHashAsync(
+    std::shared_ptr<GattDiscoveryResult> discovery) {
+  // Optional GATT Caching support: absent on most peripherals.
+  try {
+    const auto service_it =
+        discovery->gatt_map.find(generic_attribute_service_uuid);
+    if (service_it == discovery->gatt_map.end()) {
+      co_return nullptr;
+    }
+    const auto characteristic_it = service_it->second.characteristics.find(
+        database_hash_characteristic_uuid);
+    if (characteristic_it == service_it->second.characteristics.end()) {
+      co_return nullptr;
+    }
+    const auto read_operation = characteristic_it->second.obj.ReadValueAsync(
+        BluetoothCacheMode::Uncached);
+    const OperationDeadline deadline(timer_service_, gatt_timeouts_.read,
+                                     [read_operation] { read_operation.Cancel(); });
+    const auto read_result = co_await read_operation;
+    if (read_result.Status() != GattCommunicationStatus::Success) {
+      co_return nullptr;
+    }
+    co_return read_result.Value();
+  } catch (...) {
+    co_return nullptr;
+  }
+}
+
+IAsyncAction
+UniversalBlePlugin::DiscoverGattAsync(const BluetoothLEDevice device,
+                                      const uint64_t bluetooth_address,
+                                      const BluetoothCacheMode cache_mode,
+                                      const std::chrono::milliseconds timeout,
+                                      std::shared_ptr<GattDiscoveryResult> out) {
+  // Runs as IAsyncAction, so nothing may escape: errors go into `out`.
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  using std::chrono::steady_clock;
+  try {
+    const auto discovery_started = steady_clock::now();
+    const auto services_operation = device.GetGattServicesAsync(cache_mode);
+    GattDeviceServicesResult services_result{nullptr};
+    {
+      const OperationDeadline deadline(
+          timer_service_, timeout,
+          [services_operation] { services_operation.Cancel(); });
+      bool timed_out = false;
+      try {
+        services_result = co_await services_operation;
+      } catch (const hresult_canceled &) {
+        if (!deadline.expired()) {
+          throw;
+        }
+        timed_out = true;
+      }
+      if (timed_out) {
+        out->error =
+            GattTimeoutError(bluetooth_address, "DISCOVER_SERVICES", timeout);
+        co_return;
+      }
+    }
+    auto services_result_error =
+        gatt_communication_status_to_error(services_result.Status());
+    if (services_result_error.has_value()) {
+      UNIVERSAL_BLE_LOG_ERROR(
+          kGatt, "ConnectionFailed: Failed to get services: " +
+                 services_result_error.value());
+      out->error = create_flutter_error_from_gatt_communication_status(
+          services_result.Status(), services_result_error.value());
+      co_return;
+    }
+    const auto services_discovered = steady_clock::now();
+    UNIVERSAL_BLE_LOG_INFO(kGatt, "ConnectionLog: Services discovered");
+
+    std::vector<GattDeviceService> gatt_services;
+    for (GattDeviceService &&service : services_result.Services()) {
+      gatt_services.push_back(service);
+    }
+
+    // Characteristic requests are issued in windows of at most
+    // `max_parallel_requests`, so large GATT tables overlap their round trips
+    // without flooding the radio. Each deadline starts with its request.
+    const size_t window_size = std::max<size_t>(
+        1, GattOptions(bluetooth_address).discovery.max_parallel_requests);
+    for (size_t window_start = 0; window_start < gatt_services.size();
+         window_start += window_size) {
+      const size_t window_end =
+          std::min(gatt_services.size(), window_start + window_size);
+      std::vector<IAsyncOperation<GattCharacteristicsResult>> operations;
+      std::deque<OperationDeadline> deadlines;
+      for (size_t i = window_start; i < window_end; ++i) {
+        const auto operation =
+            gatt_services[i].GetCharacteristicsAsync(cache_mode);
+        operations.push_back(operation);
+        deadlines.emplace_back(timer_service_, timeout,
+                               [operation] { operation.Cancel(); });
+      }
+      for (size_t i = window_start; i < window_end; ++i) {
+        const GattDeviceService &service = gatt_services[i];
+        const auto &characteristics_operation = operations[i - window_start];
+        const auto &deadline = deadlines[i - window_start];
+        try {
+          GattServiceObject gatt_service;
+          gatt_service.obj = service;
+          std::string service_uuid = guid_to_uuid(service.Uuid());
+          GattCharacteristicsResult characteristics_result{nullptr};
+          bool timed_out = false;
+          try {
+            characteristics_result = co_await characteristics_operation;
+          } catch (const hresult_canceled &) {
+            if (!deadline.expired()) {
+              throw;
+            }
+            timed_out = true;
+          }
+          if (timed_out) {
+            GattTimeoutError(bluetooth_address,
+                             "DISCOVER_CHARACTERISTICS " + service_uuid,
+                             timeout);
+            out->complete = false;
+            continue;
+          }
+          auto characteristics_result_error =
+              gatt_communication_status_to_error(characteristics_result.Status());
+
+          if (characteristics_result_error.has_value()) {
+            UNIVERSAL_BLE_LOG_ERROR(
+                kGatt, "Failed to get characteristics for service: " +
+                       service_uuid + ", With Status: " +
+                       characteristics_result_error.value());
+            out->complete = false;
+            continue;
+          }
+          auto gatt_characteristics = characteristics_result.Characteristics();
+          for (GattCharacteristic &&characteristic : gatt_characteristics) {
+            GattCharacteristicObject gatt_characteristic;
+            gatt_characteristic.obj = characteristic;
+            gatt_characteristic.subscription_token = std::nullopt;
+            std::string characteristic_uuid =
+                guid_to_uuid(characteristic.Uuid());
+            gatt_service.characteristics.insert_or_assign(
+                characteristic_uuid, std::move(gatt_characteristic));
+          }
+          out->gatt_map.insert_or_assign(service_uuid, std::move(gatt_service));
+        } catch (const hresult_error &err) {
+          UNIVERSAL_BLE_LOG_ERROR(
+              kGatt, "DiscoverGattAsync service loop hresult_error hr=" +
+                     std::to_string(err.code()) + " msg=" +
+                     to_string(err.message()));
+          out->complete = false;
+        } catch (const std::exception &ex) {
+          UNIVERSAL_BLE_LOG_ERROR(
+              kGatt, std::string("DiscoverGattAsync service loop exception: ") +
+                     ex.what());
+          out->complete = false;
+        } catch (...) {
+          UNIVERSAL_BLE_LOG_ERROR(
+              kGatt, "DiscoverGattAsync service loop unknown error");
+          out->complete = false;
+        }
+      }
+    }
+
+    const auto discovery_finished = steady_clock::now();
+    out->timings.service_count = gatt_services.size();
+    out->timings.services =
+        duration_cast<milliseconds>(services_discovered - discovery_started);
+    out->timings.characteristics =
+        duration_cast<milliseconds>(discovery_finished - services_discovered);
+    out->timings.total =
+        duration_cast<milliseconds>(discovery_finished - discovery_started);
+    UNIVERSAL_BLE_LOG_INFO(
+        kGatt, "DiscoveryLog: " + mac_address_to_str(bluetooth_address) +
+               " services=" + std::to_string(out->timings.service_count) +
+               " services_ms=" + std::to_string(out->timings.services.count()) +
+               " characteristics_ms=" +
+               std::to_string(out->timings.characteristics.count()) +
+               " total_ms=" + std::to_string(out->timings.total.count()) +
+               " parallel=" + std::to_string(window_size) + " cached=" +
+               (cache_mode == BluetoothCacheMode::Cached ? "true" : "false"));
+  } catch (const hresult_error &err) {
+    out->error = create_flutter_error(
+        UniversalBleErrorCode::kFailed,
+        "DiscoverGattAsync hresult_error msg=" + to_string(err.message()),
+        "hr=" + std::to_string(err.code()));
+  } catch (const std::exception &ex) {
+    out->error = create_flutter_error(
+        UniversalBleErrorCode::kFailed,
+        std::string("DiscoverGattAsync std::exception: ") + ex.what());
+  } catch (...) {
+    out->error = create_flutter_error(UniversalBleErrorCode::kUnknownError,
+                                      "DiscoverGattAsync unknown exception");
+  }
+}
+
+IAsyncAction UniversalBlePlugin::EnsureGattDiscoveredAsync(
+    const uint64_t bluetooth_address, const CallDeadline deadline,
+    std::shared_ptr<std::optional<FlutterError>> error) {
+  // Runs as IAsyncAction, so nothing may escape: failures go into `error`.
+  try {
+    const auto it = connected_devices_.find(bluetooth_address);
+    if (it == connected_devices_.end() || it->second->gatt_discovered) {
+      co_return;
+    }
+    std::shared_ptr<PendingGattDiscovery> pending =
+        it->second->pending_discovery;
+    if (!pending) {
+      pending = std::make_shared<PendingGattDiscovery>();
+      it->second->pending_discovery = pending;
+      RunOnDemandDiscoveryAsync(it->second->device, bluetooth_address,
+                                pending);
+    }
+    // Waits on this thread; a call that gives up leaves the discovery
+    // running for the others.
+    const winrt::apartment_context caller_context;
+    const bool done = co_await winrt::resume_on_signal(pending->done.get(),
+                                                       deadline.remaining());
+    co_await caller_context;
+    if (!done) {
+      *error = GattTimeoutError(bluetooth_address, "DISCOVER_SERVICES",
+                                deadline.timeout());
+      co_return;
+    }
+    if (pending->result->error.has_value()) {
+      *error = pending->result->error;
+    }
+  } catch (...) {
+    *error = create_flutter_error(UniversalBleErrorCode::kUnknownError,
+                                  "EnsureGattDiscoveredAsync failed");
+  }
+}
+
+fire_and_forget UniversalBlePlugin::RunOnDemandDiscoveryAsync(
+    const BluetoothLEDevice device, const uint64_t bluetooth_address,
+    const std::shared_ptr<PendingGattDiscovery> pending) {
+  try {
+    co_await DiscoverGattWithCacheAsync(device, bluetooth_address,
+                                        gatt_timeouts_.discover_services,
+                                        pending->result);
+    // The device may have disconnected while we were suspended.
+    const auto it = connected_devices_.find(bluetooth_address);
+    if (it != connected_devices_.end() &&
+        it->second->pending_discovery == pending) {
+      it->second->pending_discovery = nullptr;
+      if (!pending->result->error.has_value()) {
+        it->second->gatt_map = std::move(pending->result->gatt_map);
+        it->second->discovery_timings = pending->result->timings;
+        it->second->gatt_discovered = true;
+      }
+    }
+    if (pending->result->error.has_value()) {
+      UNIVERSAL_BLE_LOG_ERROR(kGatt, "On-demand discovery failed: " +
+                                     pending->result->error->message());
+    }
+  } catch (...) {
+    pending->result->error = create_flutter_error(
+        UniversalBleErrorCode::kUnknownError, "On-demand discovery failed");
+  }
+  // Never leave waiters blocked on a discovery that is gone.
+  SetEvent(pending->done.get());
+}
+
+IAsyncAction UniversalBlePlugin::EnsureDescriptorsDiscoveredAsync(
+    const uint64_t bluetooth_address, const CallDeadline deadline) {
+  // Runs as IAsyncAction, so nothing may escape: failures are logged and the
+  // affected characteristics, including those left when `deadline` passes,
+  // are retried on the next call.
+  struct PendingCharacteristic {
+    std::string service_uuid;
+    std::string characteristic_uuid;
+    GattCharacteristic obj{nullptr};
+    std::optional<std::vector<std::string>> descriptor_uuids;
+  };
+  try {
+    std::vector<PendingCharacteristic> pending;
+    {
+      const auto it = connected_devices_.find(bluetooth_address);
+      if (it == connected_devices_.end()) {
+        co_return;
+      }
+      for (const auto &[service_uuid, service] : it->second->gatt_map) {
+        for (const auto &[characteristic_uuid, characteristic] :
+             service.characteristics) {
+          if (!characteristic.descriptor_uuids.has_value()) {
+            pending.push_back(
+                {service_uuid, characteristic_uuid, characteristic.obj, {}});
+          }
+        }
+      }
+    }
+    if (pending.empty()) {
+      co_return;
+    }
+
+    // Same bounded windows as characteristic discovery.
+    const size_t window_size = std::max<size_t>(
+        1, GattOptions(bluetooth_address).discovery.max_parallel_requests);
+    for (size_t window_start = 0; window_start < pending.size();
+         window_start += window_size) {
+      const auto remaining = deadline.remaining();
+      if (remaining == std::chrono::milliseconds::zero()) {
+        GattTimeoutError(bluetooth_address, "DISCOVER_DESCRIPTORS",
+                         deadline.timeout());
+        break;
+      }
+      const size_t window_end =
+          std::min(pending.size(), window_start + window_size);
+      std::vector<IAsyncOperation<GattDescriptorsResult>> operations;
+      std::deque<OperationDeadline> deadlines;
+      for (size_t i = window_start; i < window_end; ++i) {
+        const auto operation =
+            pending[i].obj.GetDescriptorsAsync(BluetoothCacheMode::Cached);
+        operations.push_back(operation);
+        deadlines.emplace_back(timer_service_, remaining,
+                               [operation] { operation.Cancel(); });
+      }
+      for (size_t i = window_start; i < window_end; ++i) {
+        auto &characteristic = pending[i];
+        const auto &descriptors_operation = operations[i - window_start];
+        const auto &operation_deadline = deadlines[i - window_start];
+        try {
+          GattDescriptorsResult descriptors_result{nullptr};
+          bool timed_out = false;
+          try {
+            descriptors_result = co_await descriptors_operation;
+          } catch (const hresult_canceled &) {
+            if (!operation_deadline.expired()) {
+              throw;
+            }
+            timed_out = true;
+          }
+          if (timed_out) {
+            GattTimeoutError(bluetooth_address,
+                             "DISCOVER_DESCRIPTORS " +
+                                 characteristic.characteristic_uuid,
+                             deadline.timeout());
+            continue;
+          }
+          if (descriptors_result.Status() != GattCommunicationStatus::Success) {
+            UNIVERSAL_BLE_LOG_ERROR(
+                kGatt, "Failed to get descriptors for characteristic: " +
+                       characteristic.characteristic_uuid);
+            continue;
+          }
+          std::vector<std::string> descriptor_uuids;
+          for (auto &&descriptor : descriptors_result.Descriptors()) {
+            descriptor_uuids.push_back(to_uuidstr(descriptor.Uuid()));
+          }
+          characteristic.descriptor_uuids = std::move(descriptor_uuids);
+        } catch (const hresult_error &err) {
+          UNIVERSAL_BLE_LOG_ERROR(
+              kGatt, "EnsureDescriptorsDiscoveredAsync hresult_error hr=" +
+                     std::to_string(err.code()) + " msg=" +
+                     to_string(err.message()));
+        } catch (...) {
+          UNIVERSAL_BLE_LOG_ERROR(
+              kGatt, "EnsureDescriptorsDiscoveredAsync unknown error");
+        }
+      }
+    }
+
+    // The device may have disconnected while we were suspended.
+    const auto it = connected_devices_.find(bluetooth_address);
+    if (it == connected_devices_.end()) {
+      co_return;
+    }
+    for (auto &characteristic : pending) {
+      if (!characteristic.descriptor_uuids.has_value()) {
+        continue;
+      }
+      const auto service_it =
+          it->second->gatt_map.find(characteristic.service_uuid);
+      if (service_it == it->second->gatt_map.end()) {
+        continue;
+      }
+      const auto characteristic_it = service_it->second.characteristics.find(
+          characteristic.characteristic_uuid);
+      if (characteristic_it != service_it->second.characteristics.end()) {
+        characteristic_it->second.descriptor_uuids =
+            std::move(characteristic.descriptor_uuids);
+      }
+    }
+  } catch (...) {
+    UNIVERSAL_BLE_LOG_ERROR(
+        kGatt, "EnsureDescriptorsDiscoveredAsync unknown exception");
+  }
+}
+
 void UniversalBlePlugin::BluetoothLeDeviceConnectionStatusChanged(
     const BluetoothLEDevice &sender, const IInspectable &) {
   uint64_t bluetooth_address = 0;
@@ -1289,24 +2076,36 @@ void UniversalBlePlugin::BluetoothLeDeviceConnectionStatusChanged(
 
 void UniversalBlePlugin::CleanConnection(const uint64_t bluetooth_address) {
   try {
+    value_cache_.InvalidateDevice(bluetooth_address);
     const auto node = connected_devices_.extract(bluetooth_address);
     if (!node.empty()) {
       const auto device_agent = std::move(node.mapped());
       try {
         device_agent->device.ConnectionStatusChanged(
             device_agent->connection_status_changed_token);
+        device_agent->device.GattServicesChanged(
+            device_agent->gatt_services_changed_token);
       } catch (const hresult_error &err) {
-        UniversalBleLogger::LogError("CleanConnection hresult_error: " +
-                                     to_string(err.message()));
+        UNIVERSAL_BLE_LOG_ERROR(kGeneral, "CleanConnection hresult_error: " +
+                                          to_string(err.message()));
       } catch (...) {
-        UniversalBleLogger::LogError(
+        UNIVERSAL_BLE_LOG_ERROR(
+            kGeneral,
             "CleanConnection: failed to remove connection status handler");
       }
       DisposeServices(device_agent);
+      CloseGattSession(*device_agent);
+      if (const auto timeout_count = GattTimeoutCount(bluetooth_address);
+          timeout_count > 0) {
+        UNIVERSAL_BLE_LOG_INFO(
+            kGeneral, "CleanConnection: " +
+                      mac_address_to_str(bluetooth_address) + " had " +
+                      std::to_string(timeout_count) + " GATT timeouts");
+      }
     }
   } catch (const hresult_error &err) {
-    UniversalBleLogger::LogError("CleanConnection outer hresult_error: " +
-                                 to_string(err.message()));
+    UNIVERSAL_BLE_LOG_ERROR(kGeneral, "CleanConnection outer hresult_error: " +
+                                      to_string(err.message()));
   } catch (const std::exception &ex) {
     log_and_swallow("CleanConnection std::exception", ex);
   } catch (...) {
@@ -1314,29 +2113,273 @@ void UniversalBlePlugin::CleanConnection(const uint64_t bluetooth_address) {
   }
 }
 
+void UniversalBlePlugin::CloseGattSession(BluetoothDeviceAgent &device_agent) {
+  if (!device_agent.gatt_session) {
+    return;
+  }
+  try {
+    device_agent.gatt_session.MaxPduSizeChanged(
+        device_agent.max_pdu_size_changed_token);
+    device_agent.gatt_session.Close();
+  } catch (...) {
+    log_and_swallow_unknown("CloseGattSession: failed to close session");
+  }
+  device_agent.gatt_session = nullptr;
+  device_agent.max_pdu_size->store(0);
+}
+
+const DeviceGattOptions &
+UniversalBlePlugin::GattOptions(const uint64_t bluetooth_address) const {
+  static const DeviceGattOptions defaults{};
+  const auto it = device_gatt_options_.find(bluetooth_address);
+  return it == device_gatt_options_.end() ? defaults : it->second;
+}
+
+const NotificationOptions &UniversalBlePlugin::NotificationOptionsFor(
+    const uint64_t bluetooth_address, const std::string &service,
+    const std::string &characteristic) const {
+  static const NotificationOptions defaults{};
+  const auto it = notification_options_.find(
+      std::make_tuple(bluetooth_address, service, characteristic));
+  return it == notification_options_.end() ? defaults : it->second;
+}
+
+FlutterError
+UniversalBlePlugin::GattTimeoutError(const uint64_t bluetooth_address,
+                                     const std::string &operation,
+                                     const std::chrono::milliseconds timeout) {
+  uint32_t timeout_count;
+  {
+    std::lock_guard<std::mutex> lock(gatt_timeout_counts_mutex_);
+    timeout_count = ++gatt_timeout_counts_[bluetooth_address];
+  }
+  const std::string device_id = mac_address_to_str(bluetooth_address);
+  UNIVERSAL_BLE_LOG_ERROR(
+      kGeneral, "TIMEOUT <- " + device_id + " " + operation + " after " +
+                std::to_string(timeout.count()) + "ms timeouts=" +
+                std::to_string(timeout_count));
+  return create_flutter_error(UniversalBleErrorCode::kOperationTimeout,
+                              operation + " timed out after " +
+                                  std::to_string(timeout.count()) + "ms",
+                              "timeouts=" + std::to_string(timeout_count));
+}
+
+uint32_t UniversalBlePlugin::GattTimeoutCount(const uint64_t bluetooth_address) {
+  std::lock_guard<std::mutex> lock(gatt_timeout_counts_mutex_);
+  const auto it = gatt_timeout_counts_.find(bluetooth_address);
+  return it == gatt_timeout_counts_.end() ? 0 : it->second;
+}
+
 void UniversalBlePlugin::DisposeServices(
     const std::unique_ptr<BluetoothDeviceAgent> &device_agent) {
   for (auto &[service_id, service] : device_agent->gatt_map) {
     for (auto &[char_id, characteristic] : service.characteristics) {
       if (characteristic.subscription_token.has_value()) {
         try {
-          characteristic.obj.ValueChanged(
-              characteristic.subscription_token.value());
+          EndSubscription(characteristic);
         } catch (const hresult_error &err) {
-          UniversalBleLogger::LogError("DisposeServices hresult_error unsub " +
-                                       to_string(err.message()));
+          UNIVERSAL_BLE_LOG_ERROR(
+              kGeneral, "DisposeServices hresult_error unsub " +
+                        to_string(err.message()));
         } catch (const std::exception &ex) {
           log_and_swallow("DisposeServices unsub std::exception", ex);
         } catch (...) {
           log_and_swallow_unknown("DisposeServices unsub");
         }
         characteristic.subscription_token = std::nullopt;
+        characteristic.notification_context = nullptr;
       }
     }
   }
   device_agent->gatt_map.clear();
 }
 
+void UniversalBlePlugin::EndSubscription(
+    GattCharacteristicObject &characteristic) {
+  if (characteristic.subscription_token.has_value()) {
+    characteristic.obj.ValueChanged(characteristic.subscription_token.value());
+    characteristic.subscription_token = std::nullopt;
+  }
+  if (const auto context = std::move(characteristic.notification_context)) {
+    const auto stats = context->buffer->stats();
+    {
+      std::lock_guard<std::mutex> lock(notification_stats_mutex_);
+      const auto key = std::make_pair(context->bluetooth_address,
+                                      context->characteristic_uuid);
+      auto &total = notification_stats_[key];
+      total.dropped += stats.dropped;
+      total.high_water = std::max(total.high_water, stats.high_water);
+      // A new subscription may already have replaced this buffer.
+      const auto live = notification_buffers_.find(key);
+      if (live != notification_buffers_.end() &&
+          live->second == context->buffer) {
+        notification_buffers_.erase(live);
+      }
+    }
+    UNIVERSAL_BLE_LOG_INFO(
+        kNotify, "NOTIFY_STATS " + context->device_id + " " +
+                 context->characteristic_uuid + " dropped=" +
+                 std::to_string(stats.dropped) + " high_water=" +
+                 std::to_string(stats.high_water));
+    UNIVERSAL_BLE_LOG_INFO(
+        kNotify, "LATENCY notification " + notification_latency_.Summary());
+    if (context->filter) {
+      UNIVERSAL_BLE_LOG_INFO(
+          kNotify, "FILTER_STATS " + context->device_id + " " +
+                   context->characteristic_uuid + " filtered=" +
+                   std::to_string(context->filter->filtered()));
+    }
+    if (context->decoder) {
+      const auto decoder_stats = context->decoder->stats();
+      UNIVERSAL_BLE_LOG_INFO(
+          kNotify, "FRAME_STATS " + context->device_id + " " +
+                   context->characteristic_uuid + " frames=" +
+                   std::to_string(decoder_stats.frames) + " crc_failures=" +
+                   std::to_string(decoder_stats.crc_failures) + " overflows=" +
+                   std::to_string(decoder_stats.overflows) + " decode_errors=" +
+                   std::to_string(decoder_stats.decode_errors));
+    }
+    // Deliver what is still buffered rather than dropping it.
+    ScheduleNotificationDrain(context);
+    if (context->transport == NotificationTransport::kBinary) {
+      std::vector<uint8_t> frame;
+      AppendUnsubscribeFrame(frame, context->subscription_id);
+      ui_thread_handler_.Post(
+          [frame = std::move(frame)]() mutable {
+            SendBinaryNotificationFrames(std::move(frame));
+          },
+          UiCallbackKind::kNotify);
+    }
+  }
+}
+
+flutter::EncodableValue UniversalBlePlugin::DispatcherStats() const {
+  flutter::EncodableMap execution;
+  for (size_t i = 0; i < kUiCallbackKindCount; ++i) {
+    const auto kind = static_cast<UiCallbackKind>(i);
+    execution.insert_or_assign(
+        flutter::EncodableValue(UiCallbackKindName(kind)),
+        to_encodable(ui_thread_handler_.Execution(kind)));
+  }
+  flutter::EncodableMap gatt_timeouts;
+  {
+    std::lock_guard<std::mutex> lock(gatt_timeout_counts_mutex_);
+    for (const auto &[bluetooth_address, count] : gatt_timeout_counts_) {
+      gatt_timeouts.insert_or_assign(
+          flutter::EncodableValue(mac_address_to_str(bluetooth_address)),
+          flutter::EncodableValue(static_cast<int64_t>(count)));
+    }
+  }
+  auto notification_stats = [this] {
+    std::lock_guard<std::mutex> lock(notification_stats_mutex_);
+    auto totals = notification_stats_;
+    for (const auto &[key, buffer] : notification_buffers_) {
+      const auto live = buffer->stats();
+      auto &total = totals[key];
+      total.dropped += live.dropped;
+      total.high_water = std::max(total.high_water, live.high_water);
+    }
+    return totals;
+  }();
+  // Device id -> characteristic UUID -> {dropped, high_water}.
+  flutter::EncodableMap notification_buffers;
+  for (const auto &[key, stats] : notification_stats) {
+    const auto &[bluetooth_address, characteristic_uuid] = key;
+    auto &device = std::get<flutter::EncodableMap>(
+        notification_buffers
+            .try_emplace(
+                flutter::EncodableValue(mac_address_to_str(bluetooth_address)),
+                flutter::EncodableMap{})
+            .first->second);
+    device.insert_or_assign(
+        flutter::EncodableValue(characteristic_uuid),
+        flutter::EncodableValue(flutter::EncodableMap{
+            {flutter::EncodableValue("dropped"),
+             flutter::EncodableValue(static_cast<int64_t>(stats.dropped))},
+            {flutter::EncodableValue("high_water"),
+             flutter::EncodableValue(static_cast<int64_t>(stats.high_water))},
+        }));
+  }
+  return flutter::EncodableValue(flutter::EncodableMap{
+      {flutter::EncodableValue("depth"),
+       flutter::EncodableValue(
+           static_cast<int64_t>(ui_thread_handler_.depth()))},
+      {flutter::EncodableValue("peak_depth"),
+       flutter::EncodableValue(
+           static_cast<int64_t>(ui_thread_handler_.peak_depth()))},
+      {flutter::EncodableValue("callbacks_per_second"),
+       flutter::EncodableValue(ui_thread_handler_.CallbacksPerSecond())},
+      {flutter::EncodableValue("queue_wait"),
+       flutter::EncodableValue(flutter::EncodableMap{
+           {flutter::EncodableValue("control"),
+            to_encodable(ui_thread_handler_.QueueWait(UiThreadLane::kControl))},
+           {flutter::EncodableValue("bulk"),
+            to_encodable(ui_thread_handler_.QueueWait(UiThreadLane::kBulk))},
+       })},
+      {flutter::EncodableValue("execution"),
+       flutter::EncodableValue(std::move(execution))},
+      {flutter::EncodableValue("log_dropped"),
+       flutter::EncodableValue(
+           static_cast<int64_t>(UniversalBleLogger::dropped_records()))},
+      {flutter::EncodableValue("gatt_timeouts"),
+       flutter::EncodableValue(std::move(gatt_timeouts))},
+      {flutter::EncodableValue("notification_buffers"),
+       flutter::EncodableValue(std::move(notification_buffers))},
+  });
+}
+
+void UniversalBlePlugin::SetCategoryLogLevel(const LogCategory category,
+                                             const BleLogLevel level) {
+  if (forward_level_ == BleLogLevel::kNone) {
+    UniversalBleLogger::SetLogLevel(category, level);
+    return;
+  }
+  chosen_log_levels_[static_cast<size_t>(category)] = level;
+  UniversalBleLogger::SetLogLevel(category, std::max(level, forward_level_));
+}
+
+void UniversalBlePlugin::SetNativeLogForwarding(BleLogLevel level) {
+  if (level < BleLogLevel::kNone || level > BleLogLevel::kVerbose) {
+    level = BleLogLevel::kNone;
+  }
+  if (forward_level_ == BleLogLevel::kNone) {
+    for (size_t i = 0; i < kLogCategoryCount; ++i) {
+      chosen_log_levels_[i] =
+          UniversalBleLogger::log_level(static_cast<LogCategory>(i));
+    }
+  }
+  // Forwarding is an explicit opt-in, so it also works in release builds
+  // where the Dart side skips setLogLevel. It only raises categories that
+  // are quieter than `level`; stopping puts the chosen levels back.
+  for (size_t i = 0; i < kLogCategoryCount; ++i) {
+    UniversalBleLogger::SetLogLevel(
+        static_cast<LogCategory>(i), std::max(chosen_log_levels_[i], level));
+  }
+  forward_level_ = level;
+  if (level == BleLogLevel::kNone) {
+    log_writer_->SetForwardSink(nullptr);
+    return;
+  }
+  log_writer_->SetForwardSink([this](std::vector<ForwardedLog> batch) {
+    ui_thread_handler_.Post(
+        [this, batch = std::move(batch)] {
+          // Flat [level, category, micros, message, level, ...] so a batch is
+          // one message with no per-record maps.
+          flutter::EncodableList records;
+          records.reserve(batch.size() * 4);
+          for (const auto &record : batch) {
+            records.emplace_back(static_cast<int32_t>(record.level));
+            records.emplace_back(static_cast<int32_t>(record.category));
+            records.emplace_back(record.micros);
+            records.emplace_back(record.message);
+          }
+          native_log_channel_->Send(
+              flutter::EncodableValue(std::move(records)));
+        },
+        UiCallbackKind::kLog);
+  });
+}
+
 /**
  * @brief In some cases, it helps to reset the whole Bluetooth state to get
  * rid of any dangling connections, before scanning or connecting.
@@ -1348,7 +2391,8 @@ void UniversalBlePlugin::ResetState() {
       try {
         bluetooth_le_watcher_.Stop();
       } catch (...) {
-        UniversalBleLogger::LogWarning("ResetState: failed to stop LE watcher");
+        UNIVERSAL_BLE_LOG_WARNING(
+            kGeneral, "ResetState: failed to stop LE watcher");
       }
       try {
         bluetooth_le_watcher_.Received(bluetooth_le_watcher_received_token_);
@@ -1376,10 +2420,10 @@ void UniversalBlePlugin::ResetState() {
     }
     connected_devices_.clear();
 
-    UniversalBleLogger::LogInfo("ResetState: completed clean slate");
+    UNIVERSAL_BLE_LOG_INFO(kGeneral, "ResetState: completed clean slate");
   } catch (const hresult_error &err) {
-    UniversalBleLogger::LogError("ResetState hresult_error: " +
-                                 to_string(err.message()));
+    UNIVERSAL_BLE_LOG_ERROR(
+        kGeneral, "ResetState hresult_error: " + to_string(err.message()));
   } catch (const std::exception &ex) {
     log_and_swallow("ResetState std::exception", ex);
   } catch (...) {
@@ -1430,56 +2474,58 @@ fire_and_forget UniversalBlePlugin::GetSystemDevicesAsync(
     result(results);
   } catch (const hresult_error &err) {
     int error_code = err.code();
-    UniversalBleLogger::LogError(
-        "GetConnectedDeviceLog: " + to_string(err.message()) +
-        " ErrorCode: " + std::to_string(error_code));
+    UNIVERSAL_BLE_LOG_ERROR(
+        kGeneral, "GetConnectedDeviceLog: " + to_string(err.message()) +
+                  " ErrorCode: " + std::to_string(error_code));
     result(create_flutter_error(UniversalBleErrorCode::kFailed,
                                 to_string(err.message()),
                                 std::to_string(error_code)));
   } catch (...) {
-    UniversalBleLogger::LogError("Unknown error GetSystemDevicesAsyncAsync");
+    UNIVERSAL_BLE_LOG_ERROR(
+        kGeneral, "Unknown error GetSystemDevicesAsyncAsync");
     result(create_flutter_error(UniversalBleErrorCode::kUnknownError,
                                 "Unknown error"));
   }
 }
 
 fire_and_forget UniversalBlePlugin::DiscoverServicesAsync(
-    const std::string &device_id, bool with_descriptors,
+    const std::string device_id, bool with_descriptors,
+    const std::chrono::milliseconds timeout,
     std::function<void(ErrorOr<flutter::EncodableList> reply)> result) {
   try {
-    const auto it = connected_devices_.find(str_to_mac_address(device_id));
+    const CallDeadline deadline(timeout);
+    const uint64_t bluetooth_address = str_to_mac_address(device_id);
+    const auto discovery_error = std::make_shared<std::optional<FlutterError>>();
+    co_await EnsureGattDiscoveredAsync(bluetooth_address, deadline,
+                                       discovery_error);
+    if (discovery_error->has_value()) {
+      result(discovery_error->value());
+      co_return;
+    }
+    if (with_descriptors) {
+      co_await EnsureDescriptorsDiscoveredAsync(bluetooth_address, deadline);
+    }
+    const auto it = connected_devices_.find(bluetooth_address);
     if (it == connected_devices_.end()) {
       result(create_flutter_error(UniversalBleErrorCode::kDeviceNotFound,
                                   "Unknown devicesId:" + device_id));
       co_return;
     }
 
+    // Everything below is served from the agent's GATT map, no I/O.
     auto universal_services = flutter::EncodableList();
     for (auto &[service_id, service] : it->second->gatt_map) {
       flutter::EncodableList universal_characteristics;
-      for (auto [char_id, characteristic] : service.characteristics) {
+      for (const auto &[char_id, characteristic] : service.characteristics) {
         auto &c = characteristic.obj;
         const auto properties_value = c.CharacteristicProperties();
         auto properties = properties_to_flutter_encodable(properties_value);
         auto descriptors = flutter::EncodableList();
-        if (with_descriptors) {
-          try {
-            // move continuation to background and execute in safe thread
-            // context
-            co_await winrt::resume_background();
-            auto descriptor_result =
-                co_await c.GetDescriptorsAsync(BluetoothCacheMode::Cached);
-            if (descriptor_result.Status() ==
-                GattCommunicationStatus::Success) {
-              auto descriptors_list = descriptor_result.Descriptors();
-              for (auto &&descriptor : descriptors_list) {
-                descriptors.push_back(flutter::CustomEncodableValue(
-                    UniversalBleDescriptor(to_uuidstr(descriptor.Uuid()))));
-              }
-            }
-          } catch (...) {
-            UniversalBleLogger::LogError("DiscoverServicesAsync: failed to get "
-                                         "descriptors for characteristic");
+        if (with_descriptors && characteristic.descriptor_uuids.has_value()) {
+          for (const auto &descriptor_uuid :
+               characteristic.descriptor_uuids.value()) {
+            descriptors.push_back(flutter::CustomEncodableValue(
+                UniversalBleDescriptor(descriptor_uuid)));
           }
         }
         universal_characteristics.push_back(
@@ -1521,22 +2567,243 @@ fire_and_forget UniversalBlePlugin::IsPairedAsync(
     const bool is_paired = device.DeviceInformation().Pairing().IsPaired();
     result(is_paired);
   } catch (...) {
-    UniversalBleLogger::LogError("IsPairedAsync: Error");
+    UNIVERSAL_BLE_LOG_ERROR(kPairing, "IsPairedAsync: Error");
     result(create_flutter_error(UniversalBleErrorCode::kUnknownError,
                                 "Unknown error"));
   }
 }
 
+fire_and_forget UniversalBlePlugin::ReadValueAsync(
+    const std::string device_id, const std::string service,
+    const std::string characteristic, const std::chrono::milliseconds timeout,
+    const std::function<void(ErrorOr<std::vector<uint8_t>> reply)> result) {
+  UNIVERSAL_BLE_LOG_DEBUG_TS(
+      kGatt, "READ -> " + device_id + " " + service + " " + characteristic);
+  try {
+    // Bounds the whole call, an on-demand discovery included.
+    const CallDeadline call_deadline(timeout);
+    const uint64_t bluetooth_address = str_to_mac_address(device_id);
+    const auto discovery_error = std::make_shared<std::optional<FlutterError>>();
+    co_await EnsureGattDiscoveredAsync(bluetooth_address, call_deadline,
+                                       discovery_error);
+    if (discovery_error->has_value()) {
+      result(discovery_error->value());
+      co_return;
+    }
+    const auto it = connected_devices_.find(bluetooth_address);
+    if (it == connected_devices_.end()) {
+      result(create_flutter_error(UniversalBleErrorCode::kDeviceNotFound,
+                                  "Unknown devicesId:" + device_id));
+      co_return;
+    }
+
+    const GattCharacteristic gatt_characteristic =
+        it->second->FetchCharacteristic(service, characteristic).obj;
+
+    const auto properties = gatt_characteristic.CharacteristicProperties();
+    if ((properties & GattCharacteristicProperties::Read) ==
+        GattCharacteristicProperties::None) {
+      result(create_flutter_error(
+          UniversalBleErrorCode::kCharacteristicDoesNotSupportRead,
+          "Characteristic does not support read"));
+      co_return;
+    }
+
+    const uint16_t handle = gatt_characteristic.AttributeHandle();
+    const ReadCacheOptions cache_options =
+        GattOptions(bluetooth_address).read_cache;
+    if (cache_options.policy == ReadCachePolicy::kNativeCache) {
+      if (auto cached = value_cache_.Get(bluetooth_address, handle,
+                                         cache_options.max_age)) {
+        UNIVERSAL_BLE_LOG_DEBUG_TS(
+            kGatt, "READ_CACHED <- " + device_id + " " + characteristic +
+                   " len=" + std::to_string(cached->size()));
+        result(std::move(cached.value()));
+        co_return;
+      }
+    }
+
+    const uint64_t cache_generation = value_cache_.generation();
+    const auto read_operation = gatt_characteristic.ReadValueAsync(
+        cache_options.policy == ReadCachePolicy::kOsCached
+            ? BluetoothCacheMode::Cached
+            : BluetoothCacheMode::Uncached);
+    const OperationDeadline deadline(timer_service_, call_deadline.remaining(),
+                                     [read_operation] { read_operation.Cancel(); });
+    GattReadResult read_value_result{nullptr};
+    bool timed_out = false;
+    try {
+      read_value_result = co_await read_operation;
+    } catch (const hresult_canceled &) {
+      if (!deadline.expired()) {
+        throw;
+      }
+      timed_out = true;
+    }
+    if (timed_out) {
+      result(GattTimeoutError(bluetooth_address, "READ " + characteristic,
+                              timeout));
+      co_return;
+    }
+
+    const auto status = read_value_result.Status();
+    if (status != GattCommunicationStatus::Success) {
+      UNIVERSAL_BLE_LOG_ERROR(
+          kGatt, "READ_FAILED <- " + device_id + " " + service + " " +
+                 characteristic + " status=" +
+                 std::to_string(static_cast<int>(status)));
+      result(create_flutter_error_from_gatt_communication_status(status));
+    } else {
+      auto value = to_bytevc(read_value_result.Value());
+      if (cache_options.policy == ReadCachePolicy::kNativeCache) {
+        value_cache_.Put(bluetooth_address, handle, value, cache_generation);
+      }
+      result(std::move(value));
+    }
+  } catch (const FlutterError &err) {
+    result(err);
+  } catch (const hresult_error &err) {
+    UNIVERSAL_BLE_LOG_ERROR(
+        kGatt, "ReadValueLog hresult_error: hr=" + std::to_string(err.code()) +
+               " msg=" + to_string(err.message()));
+    result(create_flutter_error(UniversalBleErrorCode::kFailed,
+                                to_string(err.message()),
+                                std::to_string(err.code())));
+  } catch (...) {
+    UNIVERSAL_BLE_LOG_ERROR(kGatt, "ReadValueLog: Unknown error");
+    result(create_flutter_unknown_error());
+  }
+}
+
+fire_and_forget UniversalBlePlugin::WriteValueAsync(
+    const std::string device_id, const std::string service,
+    const std::string characteristic, const std::vector<uint8_t> value,
+    const BleOutputProperty ble_output_property,
+    const std::chrono::milliseconds timeout,
+    const std::function<void(std::optional<FlutterError> reply)> result) {
+  UNIVERSAL_BLE_LOG_DEBUG_TS(
+      kGatt, "WRITE -> " + device_id + " " + service + " " + characteristic +
+             " len=" + std::to_string(value.size()) + " property=" +
+             std::to_string(static_cast<int>(ble_output_property)));
+  try {
+    // Bounds the whole call, an on-demand discovery included.
+    const CallDeadline call_deadline(timeout);
+    const uint64_t bluetooth_address = str_to_mac_address(device_id);
+    const auto discovery_error = std::make_shared<std::optional<FlutterError>>();
+    co_await EnsureGattDiscoveredAsync(bluetooth_address, call_deadline,
+                                       discovery_error);
+    if (discovery_error->has_value()) {
+      result(discovery_error->value());
+      co_return;
+    }
+    const auto it = connected_devices_.find(bluetooth_address);
+    if (it == connected_devices_.end()) {
+      result(create_flutter_error(UniversalBleErrorCode::kDeviceNotFound,
+                                  "Unknown devicesId:" + device_id));
+      co_return;
+    }
+    const GattCharacteristic gatt_characteristic =
+        it->second->FetchCharacteristic(service, characteristic).obj;
+    const auto properties = gatt_characteristic.CharacteristicProperties();
+
+    auto write_option = GattWriteOption::WriteWithResponse;
+    if (ble_output_property == BleOutputProperty::kWithoutResponse) {
+      write_option = GattWriteOption::WriteWithoutResponse;
+      if ((properties & GattCharacteristicProperties::WriteWithoutResponse) ==
+          GattCharacteristicProperties::None) {
+        result(create_flutter_error(
+            UniversalBleErrorCode::
+                kCharacteristicDoesNotSupportWriteWithoutResponse,
+            "Characteristic does not support WriteWithoutResponse"));
+        co_return;
+      }
+    } else {
+      if ((properties & GattCharacteristicProperties::Write) ==
+          GattCharacteristicProperties::None) {
+        result(create_flutter_error(
+            UniversalBleErrorCode::kCharacteristicDoesNotSupportWrite,
+            "Characteristic does not support Write"));
+        co_return;
+      }
+    }
+
+    const uint16_t handle = gatt_characteristic.AttributeHandle();
+    const auto write_operation =
+        gatt_characteristic.WriteValueAsync(from_bytevc(value), write_option);
+    const OperationDeadline deadline(
+        timer_service_, call_deadline.remaining(),
+        [write_operation] { write_operation.Cancel(); });
+    GattCommunicationStatus status{};
+    bool timed_out = false;
+    std::exception_ptr write_error;
+    try {
+      status = co_await write_operation;
+    } catch (const hresult_canceled &) {
+      timed_out = deadline.expired();
+      if (!timed_out) {
+        write_error = std::current_exception();
+      }
+    } catch (...) {
+      write_error = std::current_exception();
+    }
+    // However the write ended, a cached value can no longer be trusted.
+    // Invalidating only now also drops what a read overlapping the write
+    // would cache; see GattValueCache::Put.
+    value_cache_.Invalidate(bluetooth_address, handle);
+    if (write_error) {
+      std::rethrow_exception(write_error);
+    }
+    if (timed_out) {
+      result(GattTimeoutError(bluetooth_address, "WRITE " + characteristic,
+                              timeout));
+      co_return;
+    }
+
+    if (status != GattCommunicationStatus::Success) {
+      UNIVERSAL_BLE_LOG_ERROR(
+          kGatt, "WRITE_FAILED <- " + device_id + " " + service + " " +
+                 characteristic + " status=" +
+                 std::to_string(static_cast<int>(status)));
+      result(create_flutter_error_from_gatt_communication_status(status));
+    } else {
+      result(std::nullopt);
+    }
+  } catch (const FlutterError &err) {
+    result(err);
+  } catch (const hresult_error &err) {
+    UNIVERSAL_BLE_LOG_ERROR(
+        kGatt, "WriteValue hresult_error: hr=" + std::to_string(err.code()) +
+               " msg=" + to_string(err.message()));
+    result(create_flutter_error(UniversalBleErrorCode::kFailed,
+                                "Encountered an error.",
+                                std::to_string(err.code())));
+  } catch (...) {
+    UNIVERSAL_BLE_LOG_ERROR(kGatt, "WriteValue: Unknown error");
+    result(create_flutter_unknown_error());
+  }
+}
+
 fire_and_forget UniversalBlePlugin::SetNotifiableAsync(
-    const std::string &device_id, const std::string &service,
-    const std::string &characteristic,
-    const BleInputProperty &ble_input_property,
+    const std::string device_id, const std::string service,
+    const std::string characteristic, const BleInputProperty ble_input_property,
+    const std::chrono::milliseconds timeout,
     const std::function<void(std::optional<FlutterError> reply)> result) {
-  UniversalBleLogger::LogDebugWithTimestamp(
-      "SET_NOTIFY -> " + device_id + " " + service + " " + characteristic +
-      " input=" + std::to_string(static_cast<int>(ble_input_property)));
+  UNIVERSAL_BLE_LOG_DEBUG_TS(
+      kNotify, "SET_NOTIFY -> " + device_id + " " + service + " " +
+               characteristic + " input=" +
+               std::to_string(static_cast<int>(ble_input_property)));
   try {
-    const auto it = connected_devices_.find(str_to_mac_address(device_id));
+    // Bounds the whole call, an on-demand discovery included.
+    const CallDeadline call_deadline(timeout);
+    const uint64_t bluetooth_address = str_to_mac_address(device_id);
+    const auto discovery_error = std::make_shared<std::optional<FlutterError>>();
+    co_await EnsureGattDiscoveredAsync(bluetooth_address, call_deadline,
+                                       discovery_error);
+    if (discovery_error->has_value()) {
+      result(discovery_error->value());
+      co_return;
+    }
+    const auto it = connected_devices_.find(bluetooth_address);
     if (it == connected_devices_.end()) {
       result(create_flutter_error(UniversalBleErrorCode::kDeviceNotFound,
                                   "Unknown devicesId:" + device_id));
@@ -1574,26 +2841,45 @@ fire_and_forget UniversalBlePlugin::SetNotifiableAsync(
     const auto uuid = to_uuidstr(gatt_characteristic.Uuid());
 
     // Write to the descriptor.
+    const auto cccd_operation =
+        gatt_characteristic.WriteClientCharacteristicConfigurationDescriptorAsync(
+            descriptor_value);
+    const OperationDeadline deadline(
+        timer_service_, call_deadline.remaining(),
+        [cccd_operation] { cccd_operation.Cancel(); });
     GattCommunicationStatus status{};
+    bool timed_out = false;
     try {
-      status = co_await gatt_characteristic
-                   .WriteClientCharacteristicConfigurationDescriptorAsync(
-                       descriptor_value);
+      status = co_await cccd_operation;
+    } catch (const hresult_canceled &err) {
+      if (!deadline.expired()) {
+        result(create_flutter_error(UniversalBleErrorCode::kOperationCancelled,
+                                    "SetNotifiable cancelled",
+                                    "hr=" + std::to_string(err.code())));
+        co_return;
+      }
+      timed_out = true;
     } catch (const hresult_error &err) {
-      UniversalBleLogger::LogError(
-          "SET_NOTIFY exception hr=" + std::to_string(err.code()) +
-          " msg=" + to_string(err.message()) + " device=" + device_id +
-          " service=" + service + " char=" + characteristic);
+      UNIVERSAL_BLE_LOG_ERROR(
+          kNotify, "SET_NOTIFY exception hr=" + std::to_string(err.code()) +
+                   " msg=" + to_string(err.message()) + " device=" + device_id +
+                   " service=" + service + " char=" + characteristic);
       result(create_flutter_error(UniversalBleErrorCode::kFailed,
                                   "SetNotifiable exception: " +
                                       to_string(err.message()),
                                   "hr=" + std::to_string(err.code())));
       co_return;
     }
+    if (timed_out) {
+      result(GattTimeoutError(bluetooth_address, "SET_NOTIFY " + characteristic,
+                              timeout));
+      co_return;
+    }
     if (status != GattCommunicationStatus::Success) {
-      UniversalBleLogger::LogError("SET_NOTIFY_FAILED <- " + device_id + " " +
-                                   service + " " + characteristic + " status=" +
-                                   std::to_string(static_cast<int>(status)));
+      UNIVERSAL_BLE_LOG_ERROR(
+          kNotify, "SET_NOTIFY_FAILED <- " + device_id + " " + service + " " +
+                   characteristic + " status=" +
+                   std::to_string(static_cast<int>(status)));
       result(create_flutter_error_from_gatt_communication_status(status));
       co_return;
     }
@@ -1602,62 +2888,110 @@ fire_and_forget UniversalBlePlugin::SetNotifiableAsync(
     if (descriptor_value ==
         GattClientCharacteristicConfigurationDescriptorValue::None) {
       if (gatt_char.subscription_token.has_value()) {
-        gatt_characteristic.ValueChanged(gatt_char.subscription_token.value());
-        gatt_char.subscription_token = std::nullopt;
-        UniversalBleLogger::LogInfo("Unsubscribed " +
-                                    to_uuidstr(gatt_characteristic.Uuid()));
+        EndSubscription(gatt_char);
+        UNIVERSAL_BLE_LOG_INFO(
+            kNotify, "Unsubscribed " + to_uuidstr(gatt_characteristic.Uuid()));
       }
     } else {
       // If a notification for the given characteristic is already in progress,
       // swap the callbacks.
       if (gatt_char.subscription_token.has_value()) {
-        UniversalBleLogger::LogWarning(
+        UNIVERSAL_BLE_LOG_WARNING(
+            kNotify,
             "A notification for the given characteristic is already in "
             "progress. Swapping callbacks.");
-        gatt_characteristic.ValueChanged(gatt_char.subscription_token.value());
-        gatt_char.subscription_token = std::nullopt;
+        EndSubscription(gatt_char);
       }
 
+      const NotificationOptions &options =
+          NotificationOptionsFor(bluetooth_address, service, characteristic);
+      const auto context = std::make_shared<const NotificationContext>(
+          NotificationContext{bluetooth_address,
+                              gatt_characteristic.AttributeHandle(),
+                              mac_address_to_str(bluetooth_address), uuid,
+                              std::make_shared<NotificationRingBuffer>(
+                                  options.buffer),
+                              options.batch,
+                              options.transport,
+                              next_subscription_id_.fetch_add(1),
+                              CreateFrameDecoder(options.framing),
+                              CreateNotificationFilter(options.filter)});
+      gatt_char.notification_context = context;
+      {
+        std::lock_guard<std::mutex> lock(notification_stats_mutex_);
+        notification_buffers_.insert_or_assign(
+            std::make_pair(bluetooth_address, context->characteristic_uuid),
+            context->buffer);
+      }
+      if (context->transport == NotificationTransport::kBinary) {
+        // Posted before the handler exists, so Dart learns the id before
+        // any value frame that uses it.
+        std::vector<uint8_t> frame;
+        AppendSubscribeFrame(frame, context->subscription_id,
+                             context->device_id, context->characteristic_uuid);
+        ui_thread_handler_.Post(
+            [frame = std::move(frame)]() mutable {
+              SendBinaryNotificationFrames(std::move(frame));
+            },
+            UiCallbackKind::kNotify);
+      }
       gatt_char.subscription_token =
           std::make_optional(gatt_characteristic.ValueChanged(
-              {this, &UniversalBlePlugin::GattCharacteristicValueChanged}));
+              [this, context](const GattCharacteristic &,
+                              const GattValueChangedEventArgs &args) {
+                GattCharacteristicValueChanged(context, args);
+              }));
     }
 
     result(std::nullopt);
   } catch (const FlutterError &err) {
     result(err);
   } catch (const hresult_error &err) {
-    UniversalBleLogger::LogError(
-        "SetNotifiableLog hresult_error: hr=" + std::to_string(err.code()) +
-        " msg=" + to_string(err.message()) + " device=" + device_id +
-        " service=" + service + " char=" + characteristic);
+    UNIVERSAL_BLE_LOG_ERROR(
+        kNotify, "SetNotifiableLog hresult_error: hr=" +
+                 std::to_string(err.code()) + " msg=" +
+                 to_string(err.message()) + " device=" + device_id +
+                 " service=" + service + " char=" + characteristic);
     result(create_flutter_error(UniversalBleErrorCode::kFailed,
                                 to_string(err.message()),
                                 std::to_string(err.code())));
   } catch (...) {
-    UniversalBleLogger::LogError("SetNotifiableLog: Unknown error");
+    UNIVERSAL_BLE_LOG_ERROR(kNotify, "SetNotifiableLog: Unknown error");
     result(create_flutter_unknown_error());
   }
 }
 
 void UniversalBlePlugin::GattCharacteristicValueChanged(
-    const GattCharacteristic &sender, const GattValueChangedEventArgs &args) {
-  uint64_t bluetooth_address = 0;
+    const std::shared_ptr<const NotificationContext> &context,
+    const GattValueChangedEventArgs &args) {
+  // Stamped before any other work so queueing never skews it.
+  const int64_t arrival_micros = UniversalBleClock::NowMicros();
+  const uint64_t bluetooth_address = context->bluetooth_address;
   try {
-    bluetooth_address = sender.Service().Device().BluetoothAddress();
-    const auto uuid = to_uuidstr(sender.Uuid());
-    const auto bytes = to_bytevc(args.CharacteristicValue());
-    const auto device_id = mac_address_to_str(bluetooth_address);
-
-    UniversalBleLogger::LogVerboseWithTimestamp(
-        "NOTIFY <- " + device_id + " " + uuid +
-        " len=" + std::to_string(bytes.size()));
-
-    const auto timestamp = GetCurrentTimestampMillis();
-    ui_thread_handler_.Post([device_id, uuid, bytes, timestamp] {
-      callback_channel->OnValueChanged(device_id, uuid, bytes, &timestamp,
-                                       SuccessCallback, ErrorCallback);
-    });
+    // Read in place; the only copy is the owned payload handed onwards.
+    const IBuffer value = args.CharacteristicValue();
+    const auto bytes = buffer_span(value);
+    if (!value_cache_.empty()) {
+      value_cache_.UpdateIfPresent(bluetooth_address, context->handle, bytes);
+    }
+
+    UNIVERSAL_BLE_LOG_VERBOSE_TS(
+        kNotify, "NOTIFY <- " + context->device_id + " " +
+                 context->characteristic_uuid + " len=" +
+                 std::to_string(bytes.size()));
+
+    if (context->decoder) {
+      // Only complete frames go past this point.
+      std::vector<NotificationEntry> frames;
+      context->decoder->Feed(bytes, arrival_micros, frames);
+      for (auto &frame : frames) {
+        FilterNotification(context, std::move(frame));
+      }
+      return;
+    }
+    FilterNotification(context,
+                       {arrival_micros,
+                        std::vector<uint8_t>(bytes.begin(), bytes.end())});
   } catch (const hresult_error &err) {
     NotifyConnectionException(
         bluetooth_address, "GattCharacteristicValueChanged hresult_error hr=" +
@@ -1674,6 +3008,118 @@ void UniversalBlePlugin::GattCharacteristicValueChanged(
   }
 }
 
+void UniversalBlePlugin::FilterNotification(
+    const std::shared_ptr<const NotificationContext> &context,
+    NotificationEntry entry) {
+  if (!context->filter) {
+    EnqueueNotification(context, std::move(entry));
+    return;
+  }
+  const auto decision = context->filter->Offer(entry);
+  if (decision.deliver) {
+    EnqueueNotification(context, std::move(entry));
+  } else if (decision.schedule_release) {
+    // Rate limit: deliver the latest held value when the period ends.
+    timer_service_.Schedule(
+        // Rounded up: firing early would find the period not yet over.
+        std::chrono::ceil<std::chrono::milliseconds>(
+            std::chrono::microseconds(decision.release_in_micros)),
+        [this,
+         weak_context = std::weak_ptr<const NotificationContext>(context)] {
+          const auto pending = weak_context.lock();
+          if (!pending) {
+            return;
+          }
+          if (auto held =
+                  pending->filter->TakeHeld(UniversalBleClock::NowMicros())) {
+            EnqueueNotification(pending, std::move(held.value()));
+          }
+        });
+  }
+}
+
+void UniversalBlePlugin::EnqueueNotification(
+    const std::shared_ptr<const NotificationContext> &context,
+    NotificationEntry entry) {
+  const size_t buffered = context->buffer->Push(std::move(entry));
+  if (!context->batch.enabled || buffered >= context->batch.max_entries) {
+    ScheduleNotificationDrain(context);
+  } else if (buffered == 1) {
+    // First entry of a batch: deliver it within max_delay at the latest.
+    timer_service_.Schedule(
+        context->batch.max_delay,
+        [this,
+         weak_context = std::weak_ptr<const NotificationContext>(context)] {
+          if (const auto pending = weak_context.lock()) {
+            ScheduleNotificationDrain(pending);
+          }
+        });
+  }
+}
+
+void UniversalBlePlugin::ScheduleNotificationDrain(
+    const std::shared_ptr<const NotificationContext> &context) {
+  // A drain already pending will pick up this entry too.
+  if (context->buffer->ClaimDrain()) {
+    ui_thread_handler_.Post([this, context] { DeliverNotifications(context); },
+                            UiCallbackKind::kNotify);
+  }
+}
+
+void UniversalBlePlugin::DeliverNotifications(
+    const std::shared_ptr<const NotificationContext> &context) {
+  auto entries = context->buffer->Drain();
+  if (entries.empty()) {
+    return;
+  }
+  if (context->transport == NotificationTransport::kBinary) {
+    // Every buffered notification goes out in one fire-and-forget message.
+    size_t frames_size = 0;
+    for (const auto &entry : entries) {
+      frames_size += kNotificationValueHeaderSize + entry.value.size();
+    }
+    std::vector<uint8_t> frames;
+    frames.reserve(frames_size);
+    for (const auto &entry : entries) {
+      AppendValueFrame(frames, context->subscription_id, entry.timestamp,
+                       entry.value);
+    }
+    SendBinaryNotificationFrames(std::move(frames));
+    RecordNotificationLatency(entries);
+    return;
+  }
+  if (!context->batch.enabled) {
+    // Microseconds, unlike the other platforms' milliseconds;
+    // UniversalBlePigeonChannel.onValueChanged converts them.
+    for (const auto &entry : entries) {
+      hot_callback_channels->OnValueChanged(context->device_id,
+                                            context->characteristic_uuid,
+                                            entry.value, &entry.timestamp);
+    }
+    RecordNotificationLatency(entries);
+    return;
+  }
+  hot_callback_channels->OnValueChangedBatch(
+      context->device_id, context->characteristic_uuid, entries);
+  RecordNotificationLatency(entries);
+}
+
+void UniversalBlePlugin::RecordNotificationLatency(
+    const std::vector<NotificationEntry> &entries) {
+  const int64_t now = UniversalBleClock::NowMicros();
+  for (const auto &entry : entries) {
+    notification_latency_.Record(now - entry.timestamp);
+  }
+}
+
+void UniversalBlePlugin::SendBinaryNotificationFrames(
+    std::vector<uint8_t> frames) {
+  if (notification_messenger != nullptr && !frames.empty()) {
+    notification_messenger->Send(kNotificationBinaryChannel, frames.data(),
+                                 frames.size());
+  }
+}
+
 ErrorOr<PeripheralAdvertisingState> UniversalBlePlugin::GetAdvertisingState() {
   std::lock_guard<std::mutex> lock(peripheral_mutex_);
   if (peripheral_service_provider_map_.empty()) {
@@ -1700,11 +3146,13 @@ std::optional<FlutterError> UniversalBlePlugin::StopAdvertising() {
     } catch (...) {
     }
   }
-  ui_thread_handler_.Post([this] {
-    peripheral_callback_channel_->OnAdvertisingStateChange(
-        PeripheralAdvertisingState::kIdle, nullptr, SuccessCallback,
-        ErrorCallback);
-  });
+  ui_thread_handler_.Post(
+      [this] {
+        peripheral_callback_channel_->OnAdvertisingStateChange(
+            PeripheralAdvertisingState::kIdle, nullptr, SuccessCallback,
+            ErrorCallback);
+      },
+      UiCallbackKind::kPeripheral);
   return std::nullopt;
 }
 
@@ -1810,15 +3258,18 @@ std::optional<FlutterError> UniversalBlePlugin::StartAdvertising(
     return FlutterError("failed", "No services added to advertise");
   }
   if (local_name != nullptr) {
-    UniversalBleLogger::LogDebug("Windows GattServiceProvider advertising does "
-                                 "not support overriding local name");
+    UNIVERSAL_BLE_LOG_DEBUG(
+        kPeripheral, "Windows GattServiceProvider advertising does "
+                     "not support overriding local name");
   }
   if (manufacturer_data != nullptr) {
-    UniversalBleLogger::LogDebug("Windows GattServiceProvider advertising does "
-                                 "not support manufacturer data");
+    UNIVERSAL_BLE_LOG_DEBUG(
+        kPeripheral, "Windows GattServiceProvider advertising does "
+                     "not support manufacturer data");
   }
   if (timeout != nullptr && *timeout > 0) {
-    UniversalBleLogger::LogDebug(
+    UNIVERSAL_BLE_LOG_DEBUG(
+        kPeripheral,
         "Windows GattServiceProvider advertising timeout is not supported");
   }
   try {
@@ -1895,12 +3346,8 @@ UniversalBlePlugin::UpdateCharacteristic(const std::string &characteristic_id,
     if (characteristic_object == nullptr) {
       return FlutterError("not-found", "Characteristic not found", nullptr);
     }
-    IBuffer bytes = from_bytevc(value);
-    DataWriter writer;
-    writer.ByteOrder(ByteOrder::LittleEndian);
-    writer.WriteBuffer(bytes);
     local_char = characteristic_object->obj;
-    buffer = writer.DetachBuffer();
+    buffer = make_buffer(value);
   }
 
   try {
@@ -2062,7 +3509,8 @@ fire_and_forget UniversalBlePlugin::PeripheralAddServiceAsync(const PeripheralSe
     peripheral_service_provider_map_.insert_or_assign(guid_to_uuid(serviceProvider.Service().Uuid()), gattServiceProviderObject);
 
     ui_thread_handler_.Post([serviceUuid]
-                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, nullptr, SuccessCallback, ErrorCallback); });
+                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, nullptr, SuccessCallback, ErrorCallback); },
+                          UiCallbackKind::kPeripheral);
   }
   catch (const winrt::hresult_error &e)
   {
@@ -2070,7 +3518,8 @@ fire_and_forget UniversalBlePlugin::PeripheralAddServiceAsync(const PeripheralSe
     std::string errorMessage = winrt::to_string(e.message());
 
     ui_thread_handler_.Post([serviceUuid, errorMessage]
-                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, &errorMessage, SuccessCallback, ErrorCallback); });
+                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, &errorMessage, SuccessCallback, ErrorCallback); },
+                          UiCallbackKind::kPeripheral);
   }
   catch (const std::exception &e)
   {
@@ -2078,14 +3527,16 @@ fire_and_forget UniversalBlePlugin::PeripheralAddServiceAsync(const PeripheralSe
     std::wstring errorMessage = winrt::to_hstring(e.what()).c_str();
     std::string *err = new std::string(winrt::to_string(errorMessage));
     ui_thread_handler_.Post([serviceUuid, err]
-                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, err, SuccessCallback, ErrorCallback); });
+                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, err, SuccessCallback, ErrorCallback); },
+                          UiCallbackKind::kPeripheral);
   }
   catch (...)
   {
     std::cout << "Error: Unknown error" << std::endl;
     std::string *err = new std::string(winrt::to_string(L"Unknown error"));
     ui_thread_handler_.Post([serviceUuid, err]
-                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, err, SuccessCallback, ErrorCallback); });
+                          { peripheral_callback_channel_->OnServiceAdded(serviceUuid, err, SuccessCallback, ErrorCallback); },
+                          UiCallbackKind::kPeripheral);
   }
 }
 
@@ -2132,12 +3583,15 @@ fire_and_forget UniversalBlePlugin::PeripheralSubscribedClientsChanged(
             peripheral_callback_channel_->OnCharacteristicSubscriptionChange(
                 device_id, characteristic_id, true, name_ptr, SuccessCallback,
                 ErrorCallback);
-          });
+          },
+          UiCallbackKind::kPeripheral);
       const int64_t mtu = client.Session().MaxPduSize();
-      ui_thread_handler_.Post([this, device_id, mtu] {
-        peripheral_callback_channel_->OnMtuChange(
-            device_id, mtu, SuccessCallback, ErrorCallback);
-      });
+      ui_thread_handler_.Post(
+          [this, device_id, mtu] {
+            peripheral_callback_channel_->OnMtuChange(
+                device_id, mtu, SuccessCallback, ErrorCallback);
+          },
+          UiCallbackKind::kPeripheral);
     }
   }
 
@@ -2153,11 +3607,13 @@ fire_and_forget UniversalBlePlugin::PeripheralSubscribedClientsChanged(
     if (!found) {
       const auto device_id =
           ParsePeripheralBluetoothClientId(client.Session().DeviceId().Id());
-      ui_thread_handler_.Post([this, device_id, characteristic_id] {
-        peripheral_callback_channel_->OnCharacteristicSubscriptionChange(
-            device_id, characteristic_id, false, nullptr, SuccessCallback,
-            ErrorCallback);
-      });
+      ui_thread_handler_.Post(
+          [this, device_id, characteristic_id] {
+            peripheral_callback_channel_->OnCharacteristicSubscriptionChange(
+                device_id, characteristic_id, false, nullptr, SuccessCallback,
+                ErrorCallback);
+          },
+          UiCallbackKind::kPeripheral);
     }
   }
 }
@@ -2196,10 +3652,7 @@ fire_and_forget UniversalBlePlugin::PeripheralReadRequestedAsync(GattLocalCharac
                 deferral.Complete();
                 return;
               }
-              DataWriter writer;
-              writer.ByteOrder(ByteOrder::LittleEndian);
-              writer.WriteBuffer(from_bytevc(result->value()));
-              request.RespondWithValue(writer.DetachBuffer());
+              request.RespondWithValue(make_buffer(result->value()));
             } else {
               request.RespondWithProtocolError(0x01);
             }
@@ -2210,7 +3663,7 @@ fire_and_forget UniversalBlePlugin::PeripheralReadRequestedAsync(GattLocalCharac
             request.RespondWithProtocolError(0x0E);
             deferral.Complete();
           });
-    });
+    }, UiCallbackKind::kPeripheral);
   } catch (...) {
     deferral.Complete();
   }
@@ -2234,22 +3687,26 @@ fire_and_forget UniversalBlePlugin::PeripheralWriteRequestedAsync(
     try {
       offset = request.Offset();
     } catch (const hresult_error &err) {
-      UniversalBleLogger::LogError(
-          "PERIPHERAL_WRITE_REQ failed offset hr=" +
-          std::to_string(err.code()) + " msg=" + to_string(err.message()));
+      UNIVERSAL_BLE_LOG_ERROR(
+          kPeripheral, "PERIPHERAL_WRITE_REQ failed offset hr=" +
+                       std::to_string(err.code()) + " msg=" +
+                       to_string(err.message()));
     } catch (...) {
-      UniversalBleLogger::LogError("PERIPHERAL_WRITE_REQ failed offset unknown");
+      UNIVERSAL_BLE_LOG_ERROR(
+          kPeripheral, "PERIPHERAL_WRITE_REQ failed offset unknown");
     }
 
     bool with_response = false;
     try {
       with_response = request.Option() == GattWriteOption::WriteWithResponse;
     } catch (const hresult_error &err) {
-      UniversalBleLogger::LogError(
-          "PERIPHERAL_WRITE_REQ failed option hr=" +
-          std::to_string(err.code()) + " msg=" + to_string(err.message()));
+      UNIVERSAL_BLE_LOG_ERROR(
+          kPeripheral, "PERIPHERAL_WRITE_REQ failed option hr=" +
+                       std::to_string(err.code()) + " msg=" +
+                       to_string(err.message()));
     } catch (...) {
-      UniversalBleLogger::LogError("PERIPHERAL_WRITE_REQ failed option unknown");
+      UNIVERSAL_BLE_LOG_ERROR(
+          kPeripheral, "PERIPHERAL_WRITE_REQ failed option unknown");
     }
 
     auto value_holder = std::make_shared<std::vector<uint8_t>>();
@@ -2258,12 +3715,13 @@ fire_and_forget UniversalBlePlugin::PeripheralWriteRequestedAsync(
         *value_holder = to_bytevc(request.Value());
       }
     } catch (const hresult_error &err) {
-      UniversalBleLogger::LogError(
-          "PERIPHERAL_WRITE_REQ failed value extraction hr=" +
-          std::to_string(err.code()) + " msg=" + to_string(err.message()));
+      UNIVERSAL_BLE_LOG_ERROR(
+          kPeripheral, "PERIPHERAL_WRITE_REQ failed value extraction hr=" +
+                       std::to_string(err.code()) + " msg=" +
+                       to_string(err.message()));
     } catch (...) {
-      UniversalBleLogger::LogError(
-          "PERIPHERAL_WRITE_REQ failed value extraction unknown");
+      UNIVERSAL_BLE_LOG_ERROR(
+          kPeripheral, "PERIPHERAL_WRITE_REQ failed value extraction unknown");
     }
 
     ui_thread_handler_.Post([this, characteristicId, offset, value_holder, request,
@@ -2281,12 +3739,14 @@ fire_and_forget UniversalBlePlugin::PeripheralWriteRequestedAsync(
                 }
               }
             } catch (const hresult_error &err) {
-              UniversalBleLogger::LogError(
+              UNIVERSAL_BLE_LOG_ERROR(
+                  kPeripheral,
                   "PERIPHERAL_WRITE_REQ response hresult_error hr=" +
-                  std::to_string(err.code()) + " msg=" +
-                  to_string(err.message()));
+                      std::to_string(err.code()) + " msg=" +
+                      to_string(err.message()));
             } catch (...) {
-              UniversalBleLogger::LogError(
+              UNIVERSAL_BLE_LOG_ERROR(
+                  kPeripheral,
                   "PERIPHERAL_WRITE_REQ response unknown exception");
             }
             deferral.Complete();
@@ -2297,25 +3757,28 @@ fire_and_forget UniversalBlePlugin::PeripheralWriteRequestedAsync(
                 request.RespondWithProtocolError(0x0E);
               }
             } catch (const hresult_error &err) {
-              UniversalBleLogger::LogError(
+              UNIVERSAL_BLE_LOG_ERROR(
+                  kPeripheral,
                   "PERIPHERAL_WRITE_REQ error-response hresult_error hr=" +
-                  std::to_string(err.code()) + " msg=" +
-                  to_string(err.message()));
+                      std::to_string(err.code()) + " msg=" +
+                      to_string(err.message()));
             } catch (...) {
-              UniversalBleLogger::LogError(
+              UNIVERSAL_BLE_LOG_ERROR(
+                  kPeripheral,
                   "PERIPHERAL_WRITE_REQ error-response unknown exception");
             }
             deferral.Complete();
           });
-    });
+    }, UiCallbackKind::kPeripheral);
   } catch (const hresult_error &err) {
-    UniversalBleLogger::LogError(
-        "PERIPHERAL_WRITE_REQ outer hresult_error hr=" +
-        std::to_string(err.code()) + " msg=" + to_string(err.message()));
+    UNIVERSAL_BLE_LOG_ERROR(
+        kPeripheral, "PERIPHERAL_WRITE_REQ outer hresult_error hr=" +
+                     std::to_string(err.code()) + " msg=" +
+                     to_string(err.message()));
     deferral.Complete();
   } catch (...) {
-    UniversalBleLogger::LogError(
-        "PERIPHERAL_WRITE_REQ outer unknown exception");
+    UNIVERSAL_BLE_LOG_ERROR(
+        kPeripheral, "PERIPHERAL_WRITE_REQ outer unknown exception");
     deferral.Complete();
   }
 }
@@ -2325,20 +3788,24 @@ void UniversalBlePlugin::PeripheralAdvertisementStatusChanged(
     GattServiceProviderAdvertisementStatusChangedEventArgs const &args) {
   if (args.Error() != BluetoothError::Success) {
     auto error_str = ParsePeripheralBluetoothError(args.Error());
-    ui_thread_handler_.Post([this, error_str] {
-      peripheral_callback_channel_->OnAdvertisingStateChange(
-          PeripheralAdvertisingState::kError, &error_str, SuccessCallback,
-          ErrorCallback);
-    });
+    ui_thread_handler_.Post(
+        [this, error_str] {
+          peripheral_callback_channel_->OnAdvertisingStateChange(
+              PeripheralAdvertisingState::kError, &error_str, SuccessCallback,
+              ErrorCallback);
+        },
+        UiCallbackKind::kPeripheral);
     return;
   }
   std::lock_guard<std::mutex> lock(peripheral_mutex_);
   if (ArePeripheralAdvertisingTargetsStarted()) {
-    ui_thread_handler_.Post([this] {
-      peripheral_callback_channel_->OnAdvertisingStateChange(
-          PeripheralAdvertisingState::kAdvertising, nullptr, SuccessCallback,
-          ErrorCallback);
-    });
+    ui_thread_handler_.Post(
+        [this] {
+          peripheral_callback_channel_->OnAdvertisingStateChange(
+              PeripheralAdvertisingState::kAdvertising, nullptr,
+              SuccessCallback, ErrorCallback);
+        },
+        UiCallbackKind::kPeripheral);
   }
 }
 
@@ -1,8 +1,10 @@
 #ifndef FLUTTER_PLUGIN_UNIVERSAL_BLE_PLUGIN_H_
 #define FLUTTER_PLUGIN_UNIVERSAL_BLE_PLUGIN_H_
 
+#include <flutter/basic_message_channel.h>
 #include <flutter/method_channel.h>
 #include <flutter/plugin_registrar_windows.h>
+#include <flutter/standard_method_codec.h>
 
 #include <windows.h>
 #include <winrt/Windows.Devices.Bluetooth.Advertisement.h>
@@ -17,17 +19,65 @@
 
 #include "generated/universal_ble.g.h"
 #include "helper/universal_ble_base.h"
+#include "helper/universal_ble_clock.h"
+#include "helper/universal_ble_latency_histogram.h"
+#include "helper/universal_ble_log_writer.h"
+#include "helper/universal_ble_timer_service.h"
 #include "helper/universal_enum.h"
 #include "helper/utils.h"
 #include "ui_thread_handler.hpp"
+#include "universal_ble_frame_decoder.h"
+#include "universal_ble_gatt_cache.h"
+#include "universal_ble_notification_buffer.h"
+#include "universal_ble_notification_codec.h"
+#include "universal_ble_notification_filter.h"
 #include "universal_ble_thread_safe.h"
+#include "universal_ble_value_cache.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 namespace universal_ble {
+/// Per-subscription state computed once in SetNotifiableAsync, so a
+/// notification needs no WinRT lookups or string formatting.
+struct NotificationContext {
+  uint64_t bluetooth_address = 0;
+  uint16_t handle = 0;
+  std::string device_id;
+  std::string characteristic_uuid;
+  // Notifications waiting for the platform thread.
+  std::shared_ptr<NotificationRingBuffer> buffer;
+  NotificationBatchOptions batch;
+  NotificationTransport transport = NotificationTransport::kPigeon;
+  // Identifies the subscription in binary frames.
+  uint32_t subscription_id = 0;
+  // Set when notifications are fragments of larger frames.
+  std::shared_ptr<FrameDecoder> decoder;
+  // Set when not every (decoded) notification should reach Dart.
+  std::shared_ptr<NotificationFilter> filter;
+};
+
+/// Delivery settings of one characteristic's notifications, from the
+/// "setNotificationOptions" call. Read when the characteristic is
+/// subscribed, so changes apply from the next subscription.
+struct NotificationOptions {
+  NotificationBufferOptions buffer;
+  NotificationBatchOptions batch;
+  NotificationTransport transport = NotificationTransport::kPigeon;
+  FramingOptions framing;
+  NotificationFilterOptions filter;
+};
+
 struct GattCharacteristicObject {
   GattCharacteristic obj = nullptr;
   std::optional<event_token> subscription_token;
+  std::shared_ptr<const NotificationContext> notification_context;
+  // Descriptor UUIDs, fetched on the first discoverServices(withDescriptors).
+  std::optional<std::vector<std::string>> descriptor_uuids;
 };
 
 struct GattServiceObject {
@@ -49,6 +99,30 @@ struct PeripheralGattServiceProviderObject {
   std::map<std::string, PeripheralGattCharacteristicObject*> characteristics;
 };
 
+/// Upper bounds for GATT operations. Without them a silent peripheral keeps
+/// the Dart future pending until Windows drops the link.
+struct GattOperationTimeouts {
+  std::chrono::milliseconds read{TEN_SECONDS_IN_MSECS};
+  std::chrono::milliseconds write{TEN_SECONDS_IN_MSECS};
+  std::chrono::milliseconds set_notifiable{TEN_SECONDS_IN_MSECS};
+  std::chrono::milliseconds discover_services{THIRTY_SECONDS_IN_MSECS};
+};
+
+enum class ReadCachePolicy {
+  // Always read over the air.
+  kUncached,
+  // Let Windows answer from its own GATT cache when it has a value.
+  kOsCached,
+  // Answer from GattValueCache; read over the air only on a miss.
+  kNativeCache,
+};
+
+struct ReadCacheOptions {
+  ReadCachePolicy policy = ReadCachePolicy::kUncached;
+  // Maximum age of a kNativeCache entry; no limit when empty.
+  std::optional<std::chrono::milliseconds> max_age;
+};
+
 enum class PeripheralBlePermission {
   none,
   readable,
@@ -57,18 +131,79 @@ enum class PeripheralBlePermission {
   writeEncryptionRequired,
 };
 
+/// Time spent in each phase of GATT discovery, logged and kept on the agent.
+struct GattDiscoveryTimings {
+  size_t service_count = 0;
+  std::chrono::milliseconds services{0};
+  std::chrono::milliseconds characteristics{0};
+  std::chrono::milliseconds total{0};
+};
+
+struct GattDiscoveryResult {
+  std::unordered_map<std::string, GattServiceObject> gatt_map;
+  GattDiscoveryTimings timings;
+  // False when the characteristics of some service could not be read.
+  bool complete = true;
+  std::optional<FlutterError> error;
+};
+
+/// A discovery in progress, shared by every GATT call that needs it so a
+/// device is only discovered once at a time. `done` is signalled when
+/// `result` is final.
+struct PendingGattDiscovery {
+  winrt::handle done{CreateEventW(nullptr, TRUE, FALSE, nullptr)};
+  std::shared_ptr<GattDiscoveryResult> result =
+      std::make_shared<GattDiscoveryResult>();
+};
+
+enum class GattDiscoveryMode {
+  // Discover every service and characteristic before reporting connected.
+  kOnConnect,
+  // Report connected right away and discover on the first GATT call.
+  kOnDemand,
+};
+
+struct GattDiscoveryOptions {
+  GattDiscoveryMode mode = GattDiscoveryMode::kOnConnect;
+  // Maximum number of GetCharacteristicsAsync calls in flight at once.
+  // 1 restores strictly serial discovery.
+  size_t max_parallel_requests = 4;
+};
+
+/// Settings of one device, from the "setDeviceOptions" call. Devices
+/// without any use the defaults.
+struct DeviceGattOptions {
+  GattDiscoveryOptions discovery;
+  // Keep the layout in GattLayoutCache so a reconnect can use the OS cache.
+  bool persist_layout = false;
+  ReadCacheOptions read_cache;
+};
+
 struct BluetoothDeviceAgent {
   BluetoothLEDevice device;
   event_token connection_status_changed_token;
+  event_token gatt_services_changed_token;
   std::unordered_map<std::string, GattServiceObject> gatt_map;
+  bool gatt_discovered = false;
+  // Set while an on-demand discovery runs; see EnsureGattDiscoveredAsync.
+  std::shared_ptr<PendingGattDiscovery> pending_discovery;
+  GattDiscoveryTimings discovery_timings{};
+  // Owned for the whole connection with MaintainConnection set, so Windows
+  // keeps the link up between GATT calls.
+  GattSession gatt_session{nullptr};
+  event_token max_pdu_size_changed_token;
+  // Latest GattSession::MaxPduSize (0 until known). Shared with the
+  // MaxPduSizeChanged handler, which may run after the agent is gone.
+  std::shared_ptr<std::atomic<uint16_t>> max_pdu_size =
+      std::make_shared<std::atomic<uint16_t>>(0);
 
   BluetoothDeviceAgent(
       const BluetoothLEDevice &device,
       const event_token connection_status_changed_token,
-      const std::unordered_map<std::string, GattServiceObject> &gatt_map)
+      std::unordered_map<std::string, GattServiceObject> gatt_map)
       : device(device),
         connection_status_changed_token(connection_status_changed_token),
-        gatt_map(gatt_map) {}
+        gatt_map(std::move(gatt_map)) {}
 
   ~BluetoothDeviceAgent() { device = nullptr; }
 
@@ -112,15 +247,60 @@ private:
     }
   }
   static int64_t GetCurrentTimestampMillis() {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-               std::chrono::system_clock::now().time_since_epoch())
-        .count();
+    return UniversalBleClock::ToMillis(UniversalBleClock::NowMicros());
   }
 
   flutter::PluginRegistrarWindows *registrar_;
   bool initialized_ = false;
 
   UniversalBleUiThreadHandler ui_thread_handler_;
+  // Answers "stats" with a map and "trace" with Chrome trace JSON; see
+  // DispatcherStats.
+  std::unique_ptr<flutter::BasicMessageChannel<flutter::EncodableValue>>
+      dispatcher_stats_channel_;
+  // Sends forwarded log batches to Dart; Dart sends the level to opt in.
+  // See SetNativeLogForwarding.
+  std::unique_ptr<flutter::BasicMessageChannel<flutter::EncodableValue>>
+      native_log_channel_;
+  // Sends [deviceId, mtu] whenever a connection's MaxPduSize changes.
+  std::unique_ptr<flutter::BasicMessageChannel<flutter::EncodableValue>>
+      mtu_channel_;
+  // Per-device and per-characteristic GATT options. See HandleGattCall.
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>
+      gatt_channel_;
+  UniversalBleTimerService timer_service_;
+  // Used by calls that carry no timeout of their own.
+  GattOperationTimeouts gatt_timeouts_{};
+  std::unordered_map<uint64_t, DeviceGattOptions> device_gatt_options_{};
+  // Keyed by device address, service and characteristic UUID.
+  std::map<std::tuple<uint64_t, std::string, std::string>, NotificationOptions>
+      notification_options_{};
+  // Arrival (WinRT callback) to hand-off to the Flutter messenger.
+  LatencyHistogram notification_latency_;
+  LatencyHistogram scan_result_latency_;
+  std::atomic<uint32_t> next_subscription_id_{1};
+  GattValueCache value_cache_;
+  std::unique_ptr<GattLayoutCache> gatt_layout_cache_;
+  // Drains log records to the console and universal_ble.log, which rotates
+  // next to the GATT cache.
+  std::unique_ptr<UniversalBleLogWriter> log_writer_;
+  // Platform thread only. While forward_level_ is not kNone the logger runs
+  // each category at max(chosen_log_levels_, forward_level_).
+  BleLogLevel forward_level_ = BleLogLevel::kNone;
+  std::array<BleLogLevel, kLogCategoryCount> chosen_log_levels_{};
+  // Number of GATT operations cancelled by their deadline, per device.
+  // Kept across reconnects so flaky peripherals stay visible.
+  std::unordered_map<uint64_t, uint32_t> gatt_timeout_counts_{};
+  mutable std::mutex gatt_timeout_counts_mutex_;
+  // Notification buffer statistics per device and characteristic UUID, also
+  // kept across reconnects: those of ended subscriptions folded together,
+  // and the buffers of live ones. See DispatcherStats.
+  std::map<std::pair<uint64_t, std::string>, NotificationBufferStats>
+      notification_stats_{};
+  std::map<std::pair<uint64_t, std::string>,
+           std::shared_ptr<NotificationRingBuffer>>
+      notification_buffers_{};
+  mutable std::mutex notification_stats_mutex_;
   Radio bluetooth_radio_{nullptr};
   RadioState old_radio_state_ = RadioState::Unknown;
   BluetoothLEAdvertisementWatcher bluetooth_le_watcher_{nullptr};
@@ -144,10 +324,43 @@ private:
 
   fire_and_forget InitializeAsync();
   fire_and_forget ConnectAsync(uint64_t bluetooth_address);
+  IAsyncAction DiscoverGattAsync(BluetoothLEDevice device,
+                                 uint64_t bluetooth_address,
+                                 BluetoothCacheMode cache_mode,
+                                 std::chrono::milliseconds timeout,
+                                 std::shared_ptr<GattDiscoveryResult> out);
+  IAsyncAction
+  DiscoverGattWithCacheAsync(BluetoothLEDevice device,
+                             uint64_t bluetooth_address,
+                             std::chrono::milliseconds timeout,
+                             std::shared_ptr<GattDiscoveryResult> out);
+  IAsyncOperation<IBuffer>
+  ReadDatabaseHashAsync(std::shared_ptr<GattDiscoveryResult> discovery);
+  // Discovers the GATT table of a connected kOnDemand device unless done.
+  // Concurrent calls share one discovery, which runs on gatt_timeouts_;
+  // each call waits for it until its own deadline. A failure is stored in
+  // `error`.
+  IAsyncAction
+  EnsureGattDiscoveredAsync(uint64_t bluetooth_address, CallDeadline deadline,
+                            std::shared_ptr<std::optional<FlutterError>> error);
+  fire_and_forget
+  RunOnDemandDiscoveryAsync(BluetoothLEDevice device,
+                            uint64_t bluetooth_address,
+                            std::shared_ptr<PendingGattDiscovery> pending);
+  IAsyncAction EnsureDescriptorsDiscoveredAsync(uint64_t bluetooth_address,
+                                                CallDeadline deadline);
   fire_and_forget SetNotifiableAsync(
-      const std::string &device_id, const std::string &service,
-      const std::string &characteristic,
-      const BleInputProperty &ble_input_property,
+      std::string device_id, std::string service, std::string characteristic,
+      BleInputProperty ble_input_property, std::chrono::milliseconds timeout,
+      std::function<void(std::optional<FlutterError> reply)> result);
+  fire_and_forget
+  ReadValueAsync(std::string device_id, std::string service,
+                 std::string characteristic, std::chrono::milliseconds timeout,
+                 std::function<void(ErrorOr<std::vector<uint8_t>> reply)> result);
+  fire_and_forget WriteValueAsync(
+      std::string device_id, std::string service, std::string characteristic,
+      std::vector<uint8_t> value, BleOutputProperty ble_output_property,
+      std::chrono::milliseconds timeout,
       std::function<void(std::optional<FlutterError> reply)> result);
   fire_and_forget PairAsync(const std::string &device_id,
                             std::function<void(ErrorOr<bool> reply)> result);
@@ -161,8 +374,12 @@ private:
   IsPairedAsync(const std::string &device_id,
                 std::function<void(ErrorOr<bool> reply)> result);
   fire_and_forget DiscoverServicesAsync(
-      const std::string &device_id, bool with_descriptors,
+      std::string device_id, bool with_descriptors,
+      std::chrono::milliseconds timeout,
       std::function<void(ErrorOr<flutter::EncodableList> reply)> result);
+  void HandleGattCall(
+      const flutter::MethodCall<flutter::EncodableValue> &call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
   void
   PairingRequestedHandler(DeviceInformationCustomPairing sender,
@@ -172,7 +389,7 @@ private:
   void SetupDeviceWatcher();
   void DisposeDeviceWatcher();
   void PushUniversalScanResult(UniversalBleScanResult scan_result,
-                               bool is_connectable);
+                               bool is_connectable, int64_t arrival_micros);
   static std::string ExpandServiceUuid(const std::vector<uint8_t>& uuid_bytes, 
                                         uint8_t uuid_type);
   void BluetoothLeWatcherReceived(
@@ -185,13 +402,46 @@ private:
                                std::optional<std::string> error = std::nullopt);
   void NotifyConnectionException(uint64_t bluetooth_address,
                                  const std::string &error_message);
+  void NotifyMtuChanged(uint64_t bluetooth_address, uint16_t mtu);
   void CleanConnection(uint64_t bluetooth_address);
+  static void CloseGattSession(BluetoothDeviceAgent &device_agent);
+  const DeviceGattOptions &GattOptions(uint64_t bluetooth_address) const;
+  const NotificationOptions &
+  NotificationOptionsFor(uint64_t bluetooth_address,
+                         const std::string &service,
+                         const std::string &characteristic) const;
+  FlutterError GattTimeoutError(uint64_t bluetooth_address,
+                                const std::string &operation,
+                                std::chrono::milliseconds timeout);
+  uint32_t GattTimeoutCount(uint64_t bluetooth_address);
   void ResetState();
   void
   DisposeServices(const std::unique_ptr<BluetoothDeviceAgent> &device_agent);
 
-  void GattCharacteristicValueChanged(const GattCharacteristic &sender,
-                                      const GattValueChangedEventArgs &args);
+  void GattCharacteristicValueChanged(
+      const std::shared_ptr<const NotificationContext> &context,
+      const GattValueChangedEventArgs &args);
+  void FilterNotification(
+      const std::shared_ptr<const NotificationContext> &context,
+      NotificationEntry entry);
+  void EnqueueNotification(
+      const std::shared_ptr<const NotificationContext> &context,
+      NotificationEntry entry);
+  void ScheduleNotificationDrain(
+      const std::shared_ptr<const NotificationContext> &context);
+  void
+  DeliverNotifications(const std::shared_ptr<const NotificationContext> &context);
+  static void SendBinaryNotificationFrames(std::vector<uint8_t> frames);
+  void RecordNotificationLatency(const std::vector<NotificationEntry> &entries);
+  void EndSubscription(GattCharacteristicObject &characteristic);
+  flutter::EncodableValue DispatcherStats() const;
+  // Sets `category` to `level`, or to forward_level_ if that is more
+  // verbose while forwarding.
+  void SetCategoryLogLevel(LogCategory category, BleLogLevel level);
+  // Raises every log category to at least `level` and forwards records to
+  // Dart in batches on native_log_channel_; kNone stops forwarding and
+  // restores the levels set through SetCategoryLogLevel.
+  void SetNativeLogForwarding(BleLogLevel level);
   // Peripheral runtime state
   std::map<std::string, PeripheralGattServiceProviderObject *> peripheral_service_provider_map_{};
   /// Lowercased service UUIDs from the last successful `StartAdvertising` call.
@@ -236,8 +486,8 @@ private:
   DisableBluetooth(std::function<void(ErrorOr<bool> reply)> result) override;
   ErrorOr<BleConnectionState> GetConnectionState(
       const std::string &device_id) override;
-  std::optional<FlutterError>
-  SetLogLevel(const BleLogLevel &log_level) override;
+  std::optional<FlutterError> SetLogLevel(const BleLogLevel &log_level,
+                                          const int64_t *category) override;
   std::optional<FlutterError>
   StartScan(const UniversalScanFilter *filter, const UniversalScanConfig *config) override;
   std::optional<FlutterError> StopScan() override;
@@ -251,21 +501,22 @@ private:
       std::function<void(std::optional<FlutterError> reply)> result) override;
   void
   DiscoverServices(const std::string &device_id, bool with_descriptors,
+                   const int64_t *timeout_ms,
                    std::function<void(ErrorOr<flutter::EncodableList> reply)>
                        result) override;
   void SetNotifiable(
       const std::string &device_id, const std::string &service,
       const std::string &characteristic,
-      const BleInputProperty &ble_input_property,
+      const BleInputProperty &ble_input_property, const int64_t *timeout_ms,
       std::function<void(std::optional<FlutterError> reply)> result) override;
   void ReadValue(
       const std::string &device_id, const std::string &service,
-      const std::string &characteristic,
+      const std::string &characteristic, const int64_t *timeout_ms,
       std::function<void(ErrorOr<std::vector<uint8_t>> reply)> result) override;
   void WriteValue(
       const std::string &device_id, const std::string &service,
       const std::string &characteristic, const std::vector<uint8_t> &value,
-      const BleOutputProperty &ble_output_property,
+      const BleOutputProperty &ble_output_property, const int64_t *timeout_ms,
       std::function<void(std::optional<FlutterError> reply)> result) override;
   void RequestMtu(const std::string &device_id, int64_t expected_mtu,
                   std::function<void(ErrorOr<int64_t> reply)> result) override;
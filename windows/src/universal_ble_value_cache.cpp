@@ -0,0 +1,75 @@
+#include "universal_ble_value_cache.h"
+
+namespace universal_ble {
+
+std::optional<std::vector<uint8_t>>
+GattValueCache::Get(const uint64_t bluetooth_address, const uint16_t handle,
+                    const std::optional<std::chrono::milliseconds> max_age) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto device_it = entries_.find(bluetooth_address);
+  if (device_it == entries_.end()) {
+    return std::nullopt;
+  }
+  const auto it = device_it->second.find(handle);
+  if (it == device_it->second.end()) {
+    return std::nullopt;
+  }
+  if (max_age.has_value() &&
+      Clock::now() - it->second.updated_at > max_age.value()) {
+    device_it->second.erase(it);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  return it->second.value;
+}
+
+void GattValueCache::Put(const uint64_t bluetooth_address,
+                         const uint16_t handle, std::vector<uint8_t> value,
+                         const uint64_t read_generation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generation_.load(std::memory_order_relaxed) != read_generation) {
+    return;
+  }
+  const auto [it, inserted] = entries_[bluetooth_address].insert_or_assign(
+      handle, Entry{std::move(value), Clock::now()});
+  if (inserted) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void GattValueCache::UpdateIfPresent(const uint64_t bluetooth_address,
+                                     const uint16_t handle,
+                                     std::span<const uint8_t> value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto device_it = entries_.find(bluetooth_address);
+  if (device_it == entries_.end()) {
+    return;
+  }
+  const auto it = device_it->second.find(handle);
+  if (it != device_it->second.end()) {
+    it->second.value.assign(value.begin(), value.end());
+    it->second.updated_at = Clock::now();
+  }
+}
+
+void GattValueCache::Invalidate(const uint64_t bluetooth_address,
+                                const uint16_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generation_.fetch_add(1, std::memory_order_release);
+  const auto device_it = entries_.find(bluetooth_address);
+  if (device_it != entries_.end() && device_it->second.erase(handle) > 0) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void GattValueCache::InvalidateDevice(const uint64_t bluetooth_address) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generation_.fetch_add(1, std::memory_order_release);
+  const auto device_it = entries_.find(bluetooth_address);
+  if (device_it != entries_.end()) {
+    size_.fetch_sub(device_it->second.size(), std::memory_order_relaxed);
+    entries_.erase(device_it);
+  }
+}
+
+} // namespace universal_ble
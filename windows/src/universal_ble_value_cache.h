@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace universal_ble {
+
+/// Last known characteristic values, keyed by device address and attribute
+/// handle (unique per device, unlike characteristic UUIDs).
+///
+/// Filled by native-cache reads, refreshed by notifications for entries that
+/// already exist, and invalidated once a write completes and on disconnect.
+class GattValueCache {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Returns the cached value if present and younger than `max_age`
+  /// (no age limit when `max_age` is empty).
+  std::optional<std::vector<uint8_t>>
+  Get(uint64_t bluetooth_address, uint16_t handle,
+      std::optional<std::chrono::milliseconds> max_age);
+  // Taken before a read is issued and passed back to Put with its value.
+  uint64_t generation() const {
+    return generation_.load(std::memory_order_acquire);
+  }
+  // Stores `value` unless anything was invalidated since `read_generation`,
+  // in which case the read may have raced a write and returned the old value.
+  void Put(uint64_t bluetooth_address, uint16_t handle,
+           std::vector<uint8_t> value, uint64_t read_generation);
+  // Replaces the value only if the characteristic is already cached, so
+  // notifications do not grow the cache for characteristics never read.
+  void UpdateIfPresent(uint64_t bluetooth_address, uint16_t handle,
+                       std::span<const uint8_t> value);
+  void Invalidate(uint64_t bluetooth_address, uint16_t handle);
+  void InvalidateDevice(uint64_t bluetooth_address);
+  // Lock-free, so notification paths can skip the cache while it is unused.
+  bool empty() const { return size_.load(std::memory_order_relaxed) == 0; }
+
+private:
+  struct Entry {
+    std::vector<uint8_t> value;
+    Clock::time_point updated_at;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, std::unordered_map<uint16_t, Entry>> entries_;
+  // Number of entries, written under mutex_.
+  std::atomic<size_t> size_{0};
+  // Bumped by every invalidation, under mutex_.
+  std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace universal_ble
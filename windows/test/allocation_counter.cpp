@@ -0,0 +1,66 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *block = std::malloc(size ? size : 1)) {
+    return block;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  const auto alignment = static_cast<std::size_t>(align);
+  const std::size_t rounded =
+      size ? (size + alignment - 1) / alignment * alignment : alignment;
+#ifdef _WIN32
+  void *block = _aligned_malloc(rounded, alignment);
+#else
+  void *block = std::aligned_alloc(alignment, rounded);
+#endif
+  if (block != nullptr) {
+    return block;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *block) noexcept { std::free(block); }
+void operator delete(void *block, std::size_t) noexcept { std::free(block); }
+
+void operator delete(void *block, std::align_val_t) noexcept {
+#ifdef _WIN32
+  _aligned_free(block);
+#else
+  std::free(block);
+#endif
+}
+
+void operator delete(void *block, std::size_t,
+                     std::align_val_t align) noexcept {
+  operator delete(block, align);
+}
+
+namespace universal_ble {
+namespace benchmark {
+
+uint64_t AllocationCount() {
+  return g_allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace benchmark
+} // namespace universal_ble
@@ -0,0 +1,14 @@
+// Heap allocation count for benchmarks. Linking allocation_counter.cpp
+// replaces the global operator new and delete for the whole executable.
+#pragma once
+
+#include <cstdint>
+
+namespace universal_ble {
+namespace benchmark {
+
+// Calls of any global operator new so far, on every thread.
+uint64_t AllocationCount();
+
+} // namespace benchmark
+} // namespace universal_ble
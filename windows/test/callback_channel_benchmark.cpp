@@ -0,0 +1,115 @@
+// Per-call overhead of sending a scan result or a notification to Dart
+// through the generated UniversalBleCallbackChannel, which builds the
+// channel name, a BasicMessageChannel and a reply closure per call, and
+// through the plugin's cached UniversalBleCallbackChannels. The messenger
+// drops every message, so only the plugin side is measured. Run without
+// arguments; not part of ctest.
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "generated/universal_ble.g.h"
+#include "universal_ble_callback_channels.h"
+
+namespace {
+
+using flutter::CustomEncodableValue;
+using flutter::EncodableList;
+using universal_ble::FlutterError;
+using universal_ble::UniversalBleCallbackChannel;
+using universal_ble::UniversalBleCallbackChannels;
+using universal_ble::UniversalBleScanResult;
+using universal_ble::UniversalManufacturerData;
+using universal_ble::benchmark::AllocationCount;
+
+// Strings, as the plugin holds them; building them per call would count
+// against both paths.
+const std::string kDeviceId = "AA:BB:CC:DD:EE:FF";
+const std::string kCharacteristicId = "00002a37-0000-1000-8000-00805f9b34fb";
+constexpr int kCalls = 200000;
+
+class DroppingMessenger : public flutter::BinaryMessenger {
+public:
+  void Send(const std::string & /* channel */, const uint8_t * /* message */,
+            const size_t message_size,
+            flutter::BinaryReply /* reply */) const override {
+    bytes += message_size;
+  }
+
+  void SetMessageHandler(const std::string & /* channel */,
+                         flutter::BinaryMessageHandler /* handler */) override {
+  }
+
+  mutable size_t bytes = 0;
+};
+
+struct Measurement {
+  double nanos;
+  double allocations;
+};
+
+template <typename Call> Measurement Measure(Call &&call) {
+  call();
+  const uint64_t allocations = AllocationCount();
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kCalls; ++i) {
+    call();
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return {elapsed.count() / kCalls,
+          static_cast<double>(AllocationCount() - allocations) / kCalls};
+}
+
+void Print(const char *name, const Measurement &generated,
+           const Measurement &cached) {
+  std::printf("%-22s generated %7.1f ns %5.1f allocs  cached %6.1f ns "
+              "%4.1f allocs\n",
+              name, generated.nanos, generated.allocations, cached.nanos,
+              cached.allocations);
+}
+
+void Ignore() {}
+void IgnoreError(const FlutterError & /* error */) {}
+
+} // namespace
+
+int main() {
+  DroppingMessenger messenger;
+  // Multi-engine apps give each plugin instance a channel suffix.
+  UniversalBleCallbackChannel generated(&messenger, "1");
+  UniversalBleCallbackChannels cached(&messenger, "1");
+
+  UniversalBleScanResult scan_result(kDeviceId);
+  scan_result.set_name("Sensor 7F2A19");
+  scan_result.set_rssi(-60);
+  scan_result.set_manufacturer_data_list(EncodableList{CustomEncodableValue(
+      UniversalManufacturerData(0x004C, std::vector<uint8_t>(24, 0x5a)))});
+  Print("scan result",
+        Measure([&] {
+          generated.OnScanResult(scan_result, Ignore, IgnoreError);
+        }),
+        Measure([&] { cached.OnScanResult(scan_result); }));
+
+  for (const size_t size : {20, 244}) {
+    const std::vector<uint8_t> value(size, 0xab);
+    const int64_t timestamp = 1700000000123;
+    const std::string name =
+        "value changed (" + std::to_string(size) + " B)";
+    Print(name.c_str(), Measure([&] {
+            generated.OnValueChanged(kDeviceId, kCharacteristicId, value,
+                                     &timestamp, Ignore, IgnoreError);
+          }),
+          Measure([&] {
+            cached.OnValueChanged(kDeviceId, kCharacteristicId, value,
+                                  &timestamp);
+          }));
+  }
+  return messenger.bytes > 0 ? 0 : 1;
+}
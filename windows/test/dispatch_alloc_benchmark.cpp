@@ -0,0 +1,171 @@
+// Heap allocations per UI thread post, before and after the move-only
+// pooled dispatcher, for the captures the plugin posts most. Payloads are
+// built before counting starts, as they come from WinRT either way; only
+// Post and the drain that runs the task are counted. Run without
+// arguments; not part of ctest.
+#include "allocation_counter.h"
+#include "dispatch_benchmark_queues.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using universal_ble::benchmark::ListDispatcher;
+using universal_ble::benchmark::PooledDispatcher;
+
+constexpr int kEvents = 100000;
+// Posted back to back before each drain, like a notification burst.
+constexpr int kBurst = 64;
+
+const std::string kDeviceId = "AA:BB:CC:DD:EE:FF";
+const std::string kCharacteristic = "0000ffe1-0000-1000-8000-00805f9b34fb";
+
+// Stands in for UniversalBleScanResult: too large to fit inline.
+struct ScanResult {
+  std::string device_id = kDeviceId;
+  std::optional<std::string> name = std::string("Thermometer 7F2A19");
+  std::optional<bool> is_paired = false;
+  std::optional<int64_t> rssi = -61;
+  std::vector<std::string> services = {kCharacteristic};
+  std::vector<uint8_t> manufacturer_data = std::vector<uint8_t>(26, 0x4c);
+  std::optional<int64_t> timestamp = 0;
+};
+
+// What a notification lambda captured before the precomputed context.
+struct Notification {
+  std::vector<uint8_t> bytes = std::vector<uint8_t>(20, 0xab);
+  int64_t micros = 0;
+};
+
+struct SubscriptionContext {
+  std::string device_id = kDeviceId;
+  std::string characteristic = kCharacteristic;
+};
+
+template <typename Dispatcher, typename Post>
+double AllocationsPerEvent(Dispatcher &dispatcher, Post &&post) {
+  // Warm up on the spare payloads, so the pools are at their steady state.
+  for (int i = kEvents; i < kEvents + kBurst; ++i) {
+    post(i);
+  }
+  dispatcher.Drain();
+  const uint64_t before = universal_ble::benchmark::AllocationCount();
+  for (int i = 0; i < kEvents; i += kBurst) {
+    for (int j = i; j < i + kBurst && j < kEvents; ++j) {
+      post(j);
+    }
+    dispatcher.Drain();
+  }
+  return static_cast<double>(universal_ble::benchmark::AllocationCount() - before) / kEvents;
+}
+
+std::atomic<int64_t> g_sink{0};
+
+} // namespace
+
+int main() {
+  const auto context = std::make_shared<const SubscriptionContext>();
+  std::vector<Notification> notifications(kEvents + kBurst);
+  std::vector<ScanResult> scan_results(kEvents + kBurst);
+  std::vector<std::vector<uint8_t>> payloads(kEvents + kBurst,
+                                             std::vector<uint8_t>(20, 0xab));
+
+  struct Row {
+    const char *event;
+    double before;
+    double after;
+  };
+  std::vector<Row> rows;
+
+  {
+    ListDispatcher before;
+    PooledDispatcher after;
+    rows.push_back(
+        {"availability [state]",
+         AllocationsPerEvent(before,
+                             [&](int i) {
+                               before.Post([state = i] { g_sink += state; });
+                             }),
+         AllocationsPerEvent(after, [&](int i) {
+           after.Post([state = i] { g_sink += state; });
+         })});
+  }
+  {
+    ListDispatcher before;
+    PooledDispatcher after;
+    std::vector<std::string> ids(kEvents + kBurst, kDeviceId);
+    rows.push_back(
+        {"connection [id, connected, error]",
+         AllocationsPerEvent(before,
+                             [&](int i) {
+                               const std::string &device_id = ids[i];
+                               std::optional<std::string> error;
+                               before.Post([device_id, connected = true,
+                                            error] {
+                                 g_sink += device_id.size() + connected +
+                                           error.has_value();
+                               });
+                             }),
+         AllocationsPerEvent(after, [&](int i) {
+           after.Post([device_id = std::move(ids[i]), connected = true,
+                       error = std::optional<std::string>()] {
+             g_sink += device_id.size() + connected + error.has_value();
+           });
+         })});
+  }
+  {
+    ListDispatcher before;
+    PooledDispatcher after;
+    rows.push_back(
+        {"notification (20 B)",
+         AllocationsPerEvent(before,
+                             [&](int i) {
+                               const Notification &n = notifications[i];
+                               before.Post([device_id = kDeviceId,
+                                            uuid = kCharacteristic,
+                                            bytes = n.bytes,
+                                            timestamp = n.micros / 1000] {
+                                 g_sink += device_id.size() + uuid.size() +
+                                           bytes.size() + timestamp;
+                               });
+                             }),
+         AllocationsPerEvent(after, [&](int i) {
+           after.Post([context, bytes = std::move(payloads[i]),
+                       micros = notifications[i].micros] {
+             g_sink += context->device_id.size() + bytes.size() + micros;
+           });
+         })});
+  }
+  {
+    ListDispatcher before;
+    PooledDispatcher after;
+    std::vector<ScanResult> copies = scan_results;
+    rows.push_back(
+        {"scan result",
+         AllocationsPerEvent(before,
+                             [&](int i) {
+                               const ScanResult &scan_result = copies[i];
+                               before.Post([scan_result] {
+                                 g_sink += scan_result.device_id.size();
+                               });
+                             }),
+         AllocationsPerEvent(after, [&](int i) {
+           after.Post([scan_result = std::move(scan_results[i])] {
+             g_sink += scan_result.device_id.size();
+           });
+         })});
+  }
+
+  std::printf("%-36s %18s %18s\n", "event", "before (list)", "after (pooled)");
+  for (const Row &row : rows) {
+    std::printf("%-36s %12.2f allocs %12.2f allocs\n", row.event, row.before,
+                row.after);
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+// The UI thread dispatcher's queue with its window plumbing stripped, for
+// the dispatch benchmarks, next to the std::mutex + std::list dispatcher it
+// replaced. A wake stands for the PostMessage that would run Drain.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <utility>
+
+#include "helper/universal_ble_mpsc_queue.h"
+#include "helper/universal_ble_task.h"
+
+namespace universal_ble {
+namespace benchmark {
+
+// UniversalBleUiThreadHandler before the lock-free queue: every post locks,
+// allocates a list node (and a std::function target for larger captures)
+// and posts a wake.
+class ListDispatcher {
+public:
+  void Post(std::function<void()> &&func) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queued_.emplace_back(std::move(func));
+    }
+    wakes_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  size_t Drain() {
+    std::list<std::function<void()>> queued;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(queued_, queued);
+    }
+    for (auto &func : queued) {
+      func();
+    }
+    return queued.size();
+  }
+
+  uint64_t wakes() const { return wakes_.load(std::memory_order_relaxed); }
+
+private:
+  std::list<std::function<void()>> queued_;
+  std::mutex mutex_;
+  std::atomic<uint64_t> wakes_{0};
+};
+
+// Post and RunOne of UniversalBleUiThreadHandler for a single lane.
+class PooledDispatcher {
+public:
+  static constexpr size_t kTaskNodeCount = 1024;
+
+  ~PooledDispatcher() {
+    while (Task *task = queue_.Pop()) {
+      task_pool_.Delete(task);
+    }
+  }
+
+  void Post(UniversalBleTask &&func) {
+    Task *task = task_pool_.New(std::move(func));
+    const int64_t previous = pending_.fetch_add(1, std::memory_order_acq_rel);
+    queue_.Push(task);
+    if (previous == 0) {
+      wakes_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  size_t Drain() {
+    size_t ran = 0;
+    while (Task *task = queue_.Pop()) {
+      pending_.fetch_sub(1, std::memory_order_acq_rel);
+      task->func();
+      task_pool_.Delete(task);
+      ++ran;
+    }
+    return ran;
+  }
+
+  uint64_t wakes() const { return wakes_.load(std::memory_order_relaxed); }
+
+private:
+  struct Task {
+    Task() = default;
+    explicit Task(UniversalBleTask &&func) : func(std::move(func)) {}
+
+    std::atomic<Task *> next{nullptr};
+    UniversalBleTask func;
+    int kind = 0;
+    int64_t enqueued_micros = 0;
+  };
+
+  ObjectPool<Task, kTaskNodeCount> task_pool_;
+  MpscQueue<Task> queue_;
+  std::atomic<int64_t> pending_{0};
+  std::atomic<uint64_t> wakes_{0};
+};
+
+} // namespace benchmark
+} // namespace universal_ble
@@ -0,0 +1,95 @@
+// libFuzzer target for the notification frame decoders. The first input
+// bytes pick the options and the fragment size; the rest is decoded both as
+// a raw byte stream and, encoded, as a single frame that must round-trip.
+//
+// Built as frame_decoder_fuzz with UNIVERSAL_BLE_FUZZ=ON and Clang, and as
+// the frame_decoder_fuzz_smoke ctest on every compiler.
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+#include "frame_test_encoders.h"
+#include "universal_ble_frame_decoder.h"
+
+namespace {
+
+using universal_ble::FrameCheck;
+using universal_ble::FramingMode;
+using universal_ble::FramingOptions;
+using universal_ble::NotificationEntry;
+
+void Require(const bool condition) {
+  if (!condition) {
+    std::abort();
+  }
+}
+
+constexpr size_t kOptionBytes = 3;
+
+FramingOptions OptionsFrom(const uint8_t *data) {
+  FramingOptions options;
+  options.mode = static_cast<FramingMode>(1 + data[0] % 3);
+  options.check =
+      (data[0] & 0x04) ? FrameCheck::kCrc16Ccitt : FrameCheck::kNone;
+  options.prefix_big_endian = (data[0] & 0x08) != 0;
+  options.length_includes_prefix = (data[0] & 0x10) != 0;
+  options.prefix_size = 1 + (data[0] >> 5) % 4;
+  options.max_frame_size = 1 + data[1] * 4;
+  return options;
+}
+
+std::vector<NotificationEntry>
+Feed(universal_ble::FrameDecoder &decoder, std::span<const uint8_t> stream,
+     const size_t fragment_size) {
+  std::vector<NotificationEntry> frames;
+  for (size_t offset = 0; offset < stream.size(); offset += fragment_size) {
+    decoder.Feed(stream.subspan(offset,
+                                std::min(fragment_size, stream.size() - offset)),
+                 static_cast<int64_t>(offset), frames);
+  }
+  return frames;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size < kOptionBytes) {
+    return 0;
+  }
+  const FramingOptions options = OptionsFrom(data);
+  const size_t fragment_size = 1 + data[2] % 64;
+  const std::span<const uint8_t> rest(data + kOptionBytes,
+                                      size - kOptionBytes);
+
+  // Arbitrary input: no crash, frames within bounds and counted.
+  {
+    const auto decoder = universal_ble::CreateFrameDecoder(options);
+    Require(decoder != nullptr);
+    const auto frames = Feed(*decoder, rest, fragment_size);
+    for (const auto &frame : frames) {
+      Require(frame.value.size() <= options.max_frame_size);
+    }
+    Require(decoder->stats().frames == frames.size());
+  }
+
+  // The same bytes as a payload: encoded, they decode to exactly it.
+  const std::vector<uint8_t> payload(rest.begin(), rest.end());
+  const size_t framed_size =
+      payload.size() + (options.check == FrameCheck::kCrc16Ccitt ? 2 : 0);
+  const bool representable =
+      framed_size <= options.max_frame_size &&
+      (options.mode != FramingMode::kSlip || framed_size > 0) &&
+      (options.mode != FramingMode::kLengthPrefix ||
+       options.prefix_size >= sizeof(size_t) ||
+       framed_size + options.prefix_size < (size_t{1} << (8 * options.prefix_size)));
+  if (representable) {
+    const auto decoder = universal_ble::CreateFrameDecoder(options);
+    const auto encoded = universal_ble::test::Encode(payload, options);
+    const auto frames = Feed(*decoder, encoded, fragment_size);
+    Require(frames.size() == 1);
+    Require(frames[0].value == payload);
+    Require(frames[0].timestamp == 0);
+  }
+  return 0;
+}
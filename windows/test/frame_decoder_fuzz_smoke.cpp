@@ -0,0 +1,28 @@
+// Runs the fuzz target over deterministic pseudo-random inputs, so every
+// build exercises it without libFuzzer.
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int main() {
+  std::mt19937 random(0x5eed);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::uniform_int_distribution<size_t> length(0, 1100);
+  // Mostly delimiters and escapes, so frames actually complete.
+  const uint8_t special[] = {0x00, 0xC0, 0xDB, 0xDC, 0xDD, 0x01, 0xFF};
+  std::uniform_int_distribution<size_t> pick(0, sizeof(special) - 1);
+  constexpr int kRuns = 20000;
+  for (int run = 0; run < kRuns; ++run) {
+    std::vector<uint8_t> input(length(random));
+    for (auto &value : input) {
+      value = static_cast<uint8_t>(random() % 4 == 0 ? special[pick(random)]
+                                                     : byte(random));
+    }
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  std::printf("%d inputs\n", kRuns);
+  return 0;
+}
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <vector>
+
+#include "frame_test_encoders.h"
+#include "universal_ble_frame_decoder.h"
+
+namespace universal_ble {
+namespace test {
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+FramingOptions Options(const FramingMode mode) {
+  FramingOptions options;
+  options.mode = mode;
+  return options;
+}
+
+// Feeds `stream` in fragments of `fragment_size`, the i-th stamped i, and
+// returns the decoded frames.
+std::vector<NotificationEntry> Decode(FrameDecoder &decoder,
+                                      const Bytes &stream,
+                                      const size_t fragment_size) {
+  std::vector<NotificationEntry> frames;
+  for (size_t offset = 0, i = 0; offset < stream.size();
+       offset += fragment_size, ++i) {
+    const size_t size = std::min(fragment_size, stream.size() - offset);
+    decoder.Feed(std::span<const uint8_t>(stream.data() + offset, size),
+                 static_cast<int64_t>(i), frames);
+  }
+  return frames;
+}
+
+std::vector<Bytes> Values(const std::vector<NotificationEntry> &frames) {
+  std::vector<Bytes> values;
+  for (const auto &frame : frames) {
+    values.push_back(frame.value);
+  }
+  return values;
+}
+
+const std::vector<Bytes> &Payloads() {
+  static const std::vector<Bytes> payloads = [] {
+    std::vector<Bytes> result{
+        {0x01},
+        {0x00},
+        {0x00, 0x00},
+        {0xC0, 0xDB, 0xDC, 0xDD},
+        {0x11, 0x00, 0x22, 0x00},
+    };
+    Bytes long_payload(600);
+    for (size_t i = 0; i < long_payload.size(); ++i) {
+      long_payload[i] = static_cast<uint8_t>(i % 7 == 0 ? 0 : i);
+    }
+    result.push_back(long_payload);
+    // Exactly one full COBS block.
+    result.push_back(Bytes(254, 0x55));
+    return result;
+  }();
+  return payloads;
+}
+
+} // namespace
+
+TEST(FrameDecoder, NoneCreatesNoDecoder) {
+  EXPECT_EQ(CreateFrameDecoder(Options(FramingMode::kNone)), nullptr);
+}
+
+TEST(FrameDecoder, RejectsInvalidPrefixSize) {
+  auto options = Options(FramingMode::kLengthPrefix);
+  options.prefix_size = 0;
+  EXPECT_EQ(CreateFrameDecoder(options), nullptr);
+  options.prefix_size = sizeof(size_t) + 1;
+  EXPECT_EQ(CreateFrameDecoder(options), nullptr);
+}
+
+TEST(FrameDecoder, Crc16CcittCheckValue) {
+  const Bytes check{'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  EXPECT_EQ(Crc16Ccitt(check.data(), check.size()), 0x29B1);
+}
+
+class FrameDecoderRoundTrip
+    : public ::testing::TestWithParam<std::tuple<FramingMode, size_t>> {};
+
+TEST_P(FrameDecoderRoundTrip, DecodesEveryFrameAcrossFragments) {
+  const auto [mode, fragment_size] = GetParam();
+  for (const FrameCheck check : {FrameCheck::kNone, FrameCheck::kCrc16Ccitt}) {
+    auto options = Options(mode);
+    options.check = check;
+    Bytes stream;
+    for (const auto &payload : Payloads()) {
+      const auto frame = Encode(payload, options);
+      stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    const auto decoder = CreateFrameDecoder(options);
+    ASSERT_NE(decoder, nullptr);
+    EXPECT_EQ(Values(Decode(*decoder, stream, fragment_size)), Payloads());
+    const auto stats = decoder->stats();
+    EXPECT_EQ(stats.frames, Payloads().size());
+    EXPECT_EQ(stats.crc_failures, 0u);
+    EXPECT_EQ(stats.overflows, 0u);
+    EXPECT_EQ(stats.decode_errors, 0u);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Modes, FrameDecoderRoundTrip,
+    ::testing::Combine(::testing::Values(FramingMode::kLengthPrefix,
+                                         FramingMode::kSlip,
+                                         FramingMode::kCobs),
+                       ::testing::Values(1, 3, 20, 244, 4096)));
+
+TEST(FrameDecoder, StampsFramesWithTheirFirstFragment) {
+  const auto decoder = CreateFrameDecoder(Options(FramingMode::kSlip));
+  // Fragments 0..3: "ab" "c<END>d" "e" "<END>".
+  const Bytes stream{'a', 'b', 'c', 0xC0, 'd', 'e', 0xC0};
+  std::vector<NotificationEntry> frames;
+  decoder->Feed(std::span(stream).subspan(0, 2), 10, frames);
+  decoder->Feed(std::span(stream).subspan(2, 3), 11, frames);
+  decoder->Feed(std::span(stream).subspan(5, 1), 12, frames);
+  decoder->Feed(std::span(stream).subspan(6, 1), 13, frames);
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0].timestamp, 10);
+  EXPECT_EQ(frames[0].value, (Bytes{'a', 'b', 'c'}));
+  EXPECT_EQ(frames[1].timestamp, 11);
+  EXPECT_EQ(frames[1].value, (Bytes{'d', 'e'}));
+}
+
+TEST(FrameDecoder, LengthPrefixBigEndianIncludingPrefix) {
+  auto options = Options(FramingMode::kLengthPrefix);
+  options.prefix_size = 3;
+  options.prefix_big_endian = true;
+  options.length_includes_prefix = true;
+  const auto decoder = CreateFrameDecoder(options);
+  const Bytes stream{0x00, 0x00, 0x05, 'h', 'i'};
+  EXPECT_EQ(Values(Decode(*decoder, stream, 1)), (std::vector<Bytes>{
+                                                     {'h', 'i'}}));
+}
+
+TEST(FrameDecoder, LengthPrefixEmptyFrame) {
+  const auto decoder = CreateFrameDecoder(Options(FramingMode::kLengthPrefix));
+  const Bytes stream{0x00, 0x00, 0x01, 0x00, 0x07};
+  EXPECT_EQ(Values(Decode(*decoder, stream, 2)),
+            (std::vector<Bytes>{{}, {0x07}}));
+}
+
+TEST(FrameDecoder, LengthPrefixShorterThanPrefixResets) {
+  auto options = Options(FramingMode::kLengthPrefix);
+  options.length_includes_prefix = true;
+  const auto decoder = CreateFrameDecoder(options);
+  std::vector<NotificationEntry> frames;
+  const Bytes corrupt{0x01, 0x00, 0xAA};
+  decoder->Feed(corrupt, 0, frames);
+  const Bytes valid{0x03, 0x00, 0xBB};
+  decoder->Feed(valid, 1, frames);
+  EXPECT_EQ(Values(frames), (std::vector<Bytes>{{0xBB}}));
+  EXPECT_EQ(decoder->stats().decode_errors, 1u);
+}
+
+TEST(FrameDecoder, OverflowsAreDroppedAndCounted) {
+  for (const FramingMode mode :
+       {FramingMode::kLengthPrefix, FramingMode::kSlip, FramingMode::kCobs}) {
+    auto options = Options(mode);
+    options.max_frame_size = 8;
+    const auto decoder = CreateFrameDecoder(options);
+    Bytes stream = Encode(Bytes(9, 0x01), options);
+    const auto next = Encode(Bytes(8, 0x02), options);
+    stream.insert(stream.end(), next.begin(), next.end());
+    // A length prefix cannot resynchronise: the decoder drops the rest of
+    // the notification, so feed everything at once. The delimited framings
+    // resynchronise at the next delimiter.
+    const auto frames = Decode(*decoder, stream,
+                               mode == FramingMode::kLengthPrefix
+                                   ? stream.size()
+                                   : 4);
+    EXPECT_EQ(decoder->stats().overflows, 1u);
+    if (mode == FramingMode::kLengthPrefix) {
+      EXPECT_TRUE(frames.empty());
+    } else {
+      EXPECT_EQ(Values(frames), (std::vector<Bytes>{Bytes(8, 0x02)}));
+    }
+  }
+}
+
+TEST(FrameDecoder, SlipBadEscapeDropsOnlyThatFrame) {
+  const auto decoder = CreateFrameDecoder(Options(FramingMode::kSlip));
+  const Bytes stream{'a', 0xDB, 'x', 'b', 0xC0, 'c', 0xC0};
+  EXPECT_EQ(Values(Decode(*decoder, stream, 7)),
+            (std::vector<Bytes>{{'c'}}));
+  EXPECT_EQ(decoder->stats().decode_errors, 1u);
+}
+
+TEST(FrameDecoder, SlipIgnoresEmptyFrames) {
+  const auto decoder = CreateFrameDecoder(Options(FramingMode::kSlip));
+  const Bytes stream{0xC0, 0xC0, 'a', 0xC0};
+  EXPECT_EQ(Values(Decode(*decoder, stream, 1)), (std::vector<Bytes>{{'a'}}));
+}
+
+TEST(FrameDecoder, CobsTruncatedBlockIsADecodeError) {
+  const auto decoder = CreateFrameDecoder(Options(FramingMode::kCobs));
+  // Code 5 announces four bytes but only two follow.
+  const Bytes stream{0x05, 'a', 'b', 0x00, 0x02, 'c', 0x00};
+  EXPECT_EQ(Values(Decode(*decoder, stream, 3)), (std::vector<Bytes>{{'c'}}));
+  EXPECT_EQ(decoder->stats().decode_errors, 1u);
+}
+
+TEST(FrameDecoder, CrcMismatchIsDropped) {
+  auto options = Options(FramingMode::kCobs);
+  options.check = FrameCheck::kCrc16Ccitt;
+  const auto decoder = CreateFrameDecoder(options);
+  auto bad = AppendCrc({1, 2, 3});
+  bad[0] ^= 0xFF;
+  Bytes stream = CobsEncode(bad);
+  const auto good = CobsEncode(AppendCrc({4, 5}));
+  stream.insert(stream.end(), good.begin(), good.end());
+  // A single byte cannot hold a CRC either.
+  const auto too_short = CobsEncode({9});
+  stream.insert(stream.end(), too_short.begin(), too_short.end());
+  EXPECT_EQ(Values(Decode(*decoder, stream, 5)),
+            (std::vector<Bytes>{{4, 5}}));
+  EXPECT_EQ(decoder->stats().crc_failures, 2u);
+}
+
+} // namespace test
+} // namespace universal_ble
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "universal_ble_frame_decoder.h"
+
+namespace universal_ble {
+namespace test {
+
+// Reference encoders for the frame decoder tests, written from the specs
+// rather than from universal_ble_frame_decoder.cpp.
+
+inline std::vector<uint8_t> SlipEncode(const std::vector<uint8_t> &payload) {
+  std::vector<uint8_t> out;
+  for (const uint8_t byte : payload) {
+    if (byte == 0xC0) {
+      out.insert(out.end(), {0xDB, 0xDC});
+    } else if (byte == 0xDB) {
+      out.insert(out.end(), {0xDB, 0xDD});
+    } else {
+      out.push_back(byte);
+    }
+  }
+  out.push_back(0xC0);
+  return out;
+}
+
+inline std::vector<uint8_t> CobsEncode(const std::vector<uint8_t> &payload) {
+  std::vector<uint8_t> out{0};
+  size_t code_index = 0;
+  uint8_t code = 1;
+  for (const uint8_t byte : payload) {
+    if (byte != 0) {
+      out.push_back(byte);
+      ++code;
+    }
+    if (byte == 0 || code == 0xFF) {
+      out[code_index] = code;
+      code_index = out.size();
+      out.push_back(0);
+      code = 1;
+    }
+  }
+  out[code_index] = code;
+  out.push_back(0);
+  return out;
+}
+
+inline std::vector<uint8_t>
+LengthPrefixEncode(const std::vector<uint8_t> &payload,
+                   const FramingOptions &options) {
+  size_t length = payload.size();
+  if (options.length_includes_prefix) {
+    length += options.prefix_size;
+  }
+  std::vector<uint8_t> out(options.prefix_size);
+  for (size_t i = 0; i < options.prefix_size; ++i) {
+    const size_t shift =
+        8 * (options.prefix_big_endian ? options.prefix_size - 1 - i : i);
+    out[i] = static_cast<uint8_t>(shift < 64 ? length >> shift : 0);
+  }
+  out.insert(out.end(), payload.begin(), payload.end());
+  return out;
+}
+
+inline std::vector<uint8_t> AppendCrc(std::vector<uint8_t> payload) {
+  const uint16_t crc = Crc16Ccitt(payload.data(), payload.size());
+  payload.push_back(static_cast<uint8_t>(crc));
+  payload.push_back(static_cast<uint8_t>(crc >> 8));
+  return payload;
+}
+
+inline std::vector<uint8_t> Encode(const std::vector<uint8_t> &payload,
+                                   const FramingOptions &options) {
+  const auto frame = options.check == FrameCheck::kCrc16Ccitt
+                         ? AppendCrc(payload)
+                         : payload;
+  switch (options.mode) {
+  case FramingMode::kLengthPrefix:
+    return LengthPrefixEncode(frame, options);
+  case FramingMode::kSlip:
+    return SlipEncode(frame);
+  case FramingMode::kCobs:
+    return CobsEncode(frame);
+  case FramingMode::kNone:
+    break;
+  }
+  return frame;
+}
+
+} // namespace test
+} // namespace universal_ble
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "universal_ble_gatt_cache.h"
+
+namespace universal_ble {
+namespace test {
+
+namespace {
+
+constexpr uint64_t kAddress = 0xAABBCCDDEEFF;
+
+// A cache file of its own per test, removed afterwards.
+class GattLayoutCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path_ = std::filesystem::temp_directory_path() /
+            ("universal_ble_gatt_cache_test_" +
+             std::string(::testing::UnitTest::GetInstance()
+                             ->current_test_info()
+                             ->name()) +
+             ".txt");
+    std::filesystem::remove(path_);
+  }
+  void TearDown() override { std::filesystem::remove(path_); }
+
+  std::filesystem::path path_;
+};
+
+GattLayout HeartRateLayout() {
+  GattLayout layout;
+  layout.services["0000180d-0000-1000-8000-00805f9b34fb"] = {
+      0x0010,
+      {{"00002a37-0000-1000-8000-00805f9b34fb", 0x0012},
+       {"00002a38-0000-1000-8000-00805f9b34fb", 0x0015}}};
+  layout.services["0000180f-0000-1000-8000-00805f9b34fb"] = {
+      0x0020, {{"00002a19-0000-1000-8000-00805f9b34fb", 0x0022}}};
+  return layout;
+}
+
+} // namespace
+
+TEST_F(GattLayoutCacheTest, KeepsLayoutsWithoutADatabaseHash) {
+  GattLayoutCache(path_).Put(kAddress, HeartRateLayout());
+
+  const auto loaded = GattLayoutCache(path_).Get(kAddress);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_FALSE(loaded->database_hash.has_value());
+  EXPECT_EQ(loaded.value(), HeartRateLayout());
+}
+
+TEST_F(GattLayoutCacheTest, PersistsHashAndHandles) {
+  GattLayout layout = HeartRateLayout();
+  layout.database_hash = std::vector<uint8_t>{0x00, 0x1f, 0xa0, 0xff};
+  GattLayoutCache(path_).Put(kAddress, layout);
+
+  const auto loaded = GattLayoutCache(path_).Get(kAddress);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(loaded->database_hash, layout.database_hash);
+  EXPECT_EQ(loaded->services.at("0000180d-0000-1000-8000-00805f9b34fb")
+                .characteristics.at("00002a38-0000-1000-8000-00805f9b34fb"),
+            0x0015);
+}
+
+TEST_F(GattLayoutCacheTest, MovedHandlesDoNotMatch) {
+  GattLayout moved = HeartRateLayout();
+  moved.services["0000180f-0000-1000-8000-00805f9b34fb"]
+      .characteristics["00002a19-0000-1000-8000-00805f9b34fb"] = 0x0023;
+  EXPECT_NE(moved, HeartRateLayout());
+
+  GattLayout moved_service = HeartRateLayout();
+  moved_service.services["0000180f-0000-1000-8000-00805f9b34fb"].handle =
+      0x0021;
+  EXPECT_NE(moved_service, HeartRateLayout());
+}
+
+TEST_F(GattLayoutCacheTest, InvalidateRemovesTheLayoutFromDisk) {
+  GattLayoutCache(path_).Put(kAddress, HeartRateLayout());
+  GattLayoutCache(path_).Invalidate(kAddress);
+  EXPECT_FALSE(GattLayoutCache(path_).Get(kAddress).has_value());
+}
+
+TEST_F(GattLayoutCacheTest, DropsLinesWithoutHandles) {
+  {
+    std::ofstream file(path_);
+    // The format before handles were stored, and a corrupt hash.
+    file << "aabbccddeeff 001fa0ff "
+            "0000180d-0000-1000-8000-00805f9b34fb="
+            "00002a37-0000-1000-8000-00805f9b34fb\n";
+    file << "112233445566 0g1 0000180d-0000-1000-8000-00805f9b34fb@10=\n";
+    file << "665544332211 - 0000180d-0000-1000-8000-00805f9b34fb@10=\n";
+  }
+  GattLayoutCache cache(path_);
+  EXPECT_FALSE(cache.Get(kAddress).has_value());
+  EXPECT_FALSE(cache.Get(0x112233445566).has_value());
+  EXPECT_TRUE(cache.Get(0x665544332211).has_value());
+}
+
+TEST_F(GattLayoutCacheTest, EvictsTheLeastRecentlyUsedLayout) {
+  GattLayoutCache cache(path_, 2);
+  cache.Put(1, HeartRateLayout());
+  cache.Put(2, HeartRateLayout());
+  ASSERT_TRUE(cache.Get(1).has_value());
+  cache.Put(3, HeartRateLayout());
+
+  GattLayoutCache reloaded(path_, 2);
+  EXPECT_TRUE(reloaded.Get(1).has_value());
+  EXPECT_FALSE(reloaded.Get(2).has_value());
+  EXPECT_TRUE(reloaded.Get(3).has_value());
+}
+
+} // namespace test
+} // namespace universal_ble
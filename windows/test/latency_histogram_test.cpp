@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "helper/universal_ble_latency_histogram.h"
+
+namespace universal_ble {
+namespace test {
+
+namespace {
+
+// Upper bound reported for `value`, read back through Percentile: a sample
+// in the overflow bucket keeps max() from clamping it.
+int64_t ReportedBound(const int64_t value) {
+  LatencyHistogram histogram;
+  histogram.Record(value);
+  histogram.Record(int64_t{1} << 40);
+  return histogram.Percentile(50);
+}
+
+} // namespace
+
+TEST(LatencyHistogram, EmptyReportsZero) {
+  const LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.max(), 0);
+  EXPECT_EQ(histogram.Percentile(50), 0);
+  EXPECT_EQ(histogram.Summary(),
+            "n=0 p50=0us p90=0us p99=0us p999=0us max=0us");
+}
+
+TEST(LatencyHistogram, SmallValuesAreExact) {
+  for (int64_t value = 0; value < 32; ++value) {
+    EXPECT_EQ(ReportedBound(value), value);
+  }
+}
+
+TEST(LatencyHistogram, BucketBoundaries) {
+  // Each power of two from 32 up starts a bucket 2^(k-4) wide.
+  for (int bits = 5; bits < 32; ++bits) {
+    const int64_t start = int64_t{1} << bits;
+    const int64_t width = start >> 4;
+    EXPECT_EQ(ReportedBound(start - 1), start - 1) << start;
+    EXPECT_EQ(ReportedBound(start), start + width - 1) << start;
+    EXPECT_EQ(ReportedBound(start + width - 1), start + width - 1) << start;
+    EXPECT_EQ(ReportedBound(start + width), start + 2 * width - 1) << start;
+  }
+}
+
+TEST(LatencyHistogram, RelativeErrorIsBounded) {
+  for (int64_t value = 1; value < (int64_t{1} << 32); value = value * 3 + 1) {
+    const int64_t bound = ReportedBound(value);
+    EXPECT_GE(bound, value);
+    EXPECT_LE(bound - value, value / 16) << value;
+  }
+}
+
+TEST(LatencyHistogram, PercentilesUseTheSampleRank) {
+  LatencyHistogram histogram;
+  for (int64_t value = 1; value <= 1000; ++value) {
+    histogram.Record(value);
+  }
+  EXPECT_EQ(histogram.count(), 1000u);
+  // Rank ceil(p * n): samples 1, 500, 900, 990 and 1000, reported as the
+  // upper bounds of [496, 511], [896, 927] and [960, 991].
+  EXPECT_EQ(histogram.Percentile(0), 1);
+  EXPECT_EQ(histogram.Percentile(50), 511);
+  EXPECT_EQ(histogram.Percentile(90), 927);
+  EXPECT_EQ(histogram.Percentile(99), 991);
+  EXPECT_EQ(histogram.Percentile(100), 1000);
+  // Clamped to the largest sample even when its bucket reaches further.
+  EXPECT_EQ(histogram.Percentile(99.95), 1000);
+  EXPECT_EQ(histogram.Percentile(150), 1000);
+  EXPECT_EQ(histogram.Percentile(-5), 1);
+}
+
+TEST(LatencyHistogram, NegativeIsZeroAndHugeIsMax) {
+  LatencyHistogram histogram;
+  histogram.Record(-20);
+  EXPECT_EQ(histogram.Percentile(100), 0);
+  EXPECT_EQ(histogram.max(), 0);
+  const int64_t huge = int64_t{1} << 45;
+  histogram.Record(huge);
+  EXPECT_EQ(histogram.max(), huge);
+  EXPECT_EQ(histogram.Percentile(100), huge);
+}
+
+TEST(LatencyHistogram, ConcurrentRecordsAreAllCounted) {
+  LatencyHistogram histogram;
+  constexpr int kThreads = 4;
+  constexpr int kRecords = 20000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&histogram, t] {
+      for (int i = 0; i < kRecords; ++i) {
+        histogram.Record(t * kRecords + i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(histogram.count(), static_cast<uint64_t>(kThreads * kRecords));
+  EXPECT_EQ(histogram.max(), kThreads * kRecords - 1);
+}
+
+} // namespace test
+} // namespace universal_ble
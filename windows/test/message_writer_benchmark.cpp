@@ -0,0 +1,142 @@
+// Encodes the hot callback messages with StandardMessageWriter and with the
+// generic path it replaced: boxing into an EncodableValue tree and
+// serializing it with the pigeon codec (StandardCodecSerializer underneath).
+// Checks that both produce the same bytes, then reports ns and heap
+// allocations per message. Run without arguments; not part of ctest.
+#include <flutter/encodable_value.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "generated/universal_ble.g.h"
+#include "universal_ble_message_writer.h"
+
+namespace {
+
+using flutter::CustomEncodableValue;
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+using universal_ble::StandardMessageWriter;
+using universal_ble::UniversalBleCallbackChannel;
+using universal_ble::UniversalBleScanResult;
+using universal_ble::UniversalManufacturerData;
+using universal_ble::benchmark::AllocationCount;
+
+constexpr char kDeviceId[] = "AA:BB:CC:DD:EE:FF";
+constexpr char kCharacteristicId[] = "00002a37-0000-1000-8000-00805f9b34fb";
+constexpr int kMessages = 200000;
+
+UniversalBleScanResult FullScanResult() {
+  UniversalBleScanResult result(kDeviceId);
+  result.set_name("Sensor 7F2A19");
+  result.set_is_paired(false);
+  result.set_rssi(-60);
+  result.set_manufacturer_data_list(EncodableList{
+      CustomEncodableValue(
+          UniversalManufacturerData(0x004C, std::vector<uint8_t>(24, 0x5a))),
+      CustomEncodableValue(UniversalManufacturerData(0x0059, {0xAA})),
+  });
+  result.set_service_data(EncodableMap{
+      {EncodableValue("0000180f-0000-1000-8000-00805f9b34fb"),
+       EncodableValue(std::vector<uint8_t>{0x64})},
+  });
+  result.set_services(
+      EncodableList{EncodableValue("0000180d-0000-1000-8000-00805f9b34fb")});
+  result.set_timestamp(1700000000000);
+  return result;
+}
+
+struct Measurement {
+  double nanos;
+  double allocations;
+};
+
+template <typename Encode> Measurement Measure(Encode &&encode) {
+  encode();
+  const uint64_t allocations = AllocationCount();
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kMessages; ++i) {
+    encode();
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return {elapsed.count() / kMessages,
+          static_cast<double>(AllocationCount() - allocations) / kMessages};
+}
+
+// `generic` returns the codec's message; `direct` fills `buffer`, which it
+// reuses like UniversalBleCallbackChannels does.
+template <typename Generic, typename Direct>
+bool Run(const char *name, Generic &&generic, Direct &&direct) {
+  std::vector<uint8_t> buffer;
+  direct(buffer);
+  const auto expected = generic();
+  if (*expected != buffer) {
+    std::printf("%-22s MISMATCH: direct output differs from the codec\n",
+                name);
+    return false;
+  }
+  const Measurement before = Measure([&] { return generic()->size(); });
+  const Measurement after = Measure([&] { direct(buffer); });
+  std::printf("%-22s %5zu B  codec %7.1f ns %5.1f allocs  direct %6.1f ns "
+              "%4.1f allocs\n",
+              name, buffer.size(), before.nanos, before.allocations,
+              after.nanos, after.allocations);
+  return true;
+}
+
+} // namespace
+
+int main() {
+  const auto &codec = UniversalBleCallbackChannel::GetCodec();
+  bool identical = true;
+
+  for (const auto &[name, result] :
+       {std::pair{"scan result (id only)", UniversalBleScanResult(kDeviceId)},
+        std::pair{"scan result (full)", FullScanResult()}}) {
+    identical &= Run(
+        name,
+        [&] {
+          return codec.EncodeMessage(
+              EncodableValue(EncodableList{CustomEncodableValue(result)}));
+        },
+        [&](std::vector<uint8_t> &buffer) {
+          buffer.clear();
+          StandardMessageWriter writer(buffer);
+          writer.WriteListHeader(1);
+          writer.WriteScanResult(result);
+        });
+  }
+
+  for (const size_t size : {20, 244, 512}) {
+    const std::vector<uint8_t> value(size, 0xab);
+    const int64_t timestamp = 1700000000123;
+    const std::string name =
+        "value changed (" + std::to_string(size) + " B)";
+    identical &= Run(
+        name.c_str(),
+        [&] {
+          return codec.EncodeMessage(EncodableValue(EncodableList{
+              EncodableValue(kDeviceId),
+              EncodableValue(kCharacteristicId),
+              EncodableValue(value),
+              EncodableValue(timestamp),
+          }));
+        },
+        [&](std::vector<uint8_t> &buffer) {
+          buffer.clear();
+          StandardMessageWriter writer(buffer);
+          writer.WriteListHeader(4);
+          writer.WriteString(kDeviceId);
+          writer.WriteString(kCharacteristicId);
+          writer.WriteBytes(value.data(), value.size());
+          writer.WriteInt64(timestamp);
+        });
+  }
+  return identical ? 0 : 1;
+}
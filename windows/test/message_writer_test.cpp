@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "generated/universal_ble.g.h"
+#include "universal_ble_callback_channels.h"
+#include "universal_ble_message_writer.h"
+
+namespace universal_ble {
+namespace test {
+
+namespace {
+
+using flutter::CustomEncodableValue;
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+using Bytes = std::vector<uint8_t>;
+
+// The goldens of test/windows_message_codec_test.dart, which the Dart side
+// decodes. Update both together.
+
+const Bytes kFullScanResult = {
+    0x0c, 0x01, 0x90, 0x0c, 0x08, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42,
+    0x3a, 0x43, 0x43, 0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46,
+    0x07, 0x06, 0x53, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x02, 0x04, 0xc4, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0c, 0x02, 0x99, 0x0c, 0x02, 0x04,
+    0x4c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x03, 0x01, 0x02,
+    0x03, 0x99, 0x0c, 0x02, 0x04, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x08, 0x01, 0xaa, 0x0d, 0x01, 0x07, 0x24, 0x30, 0x30, 0x30, 0x30,
+    0x31, 0x38, 0x30, 0x66, 0x2d, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x31, 0x30,
+    0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30, 0x30, 0x38, 0x30,
+    0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x08, 0x01, 0x64, 0x0c,
+    0x01, 0x07, 0x24, 0x30, 0x30, 0x30, 0x30, 0x31, 0x38, 0x30, 0x64, 0x2d,
+    0x30, 0x30, 0x30, 0x30, 0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30,
+    0x30, 0x30, 0x2d, 0x30, 0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33,
+    0x34, 0x66, 0x62, 0x04, 0x00, 0x68, 0xe5, 0xcf, 0x8b, 0x01, 0x00, 0x00,
+};
+
+const Bytes kMinimalScanResult = {
+    0x0c, 0x01, 0x90, 0x0c, 0x08, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42,
+    0x3a, 0x43, 0x43, 0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+const Bytes kValueChanged20 = {
+    0x0c, 0x04, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, 0x3a, 0x43, 0x43,
+    0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46, 0x07, 0x24, 0x30,
+    0x30, 0x30, 0x30, 0x32, 0x61, 0x33, 0x37, 0x2d, 0x30, 0x30, 0x30, 0x30,
+    0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30,
+    0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x08,
+    0x14, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+    0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x04, 0x7b, 0x68,
+    0xe5, 0xcf, 0x8b, 0x01, 0x00, 0x00,
+};
+
+// Followed by the payload (i % 256) and a null timestamp.
+const Bytes kValueChanged512Head = {
+    0x0c, 0x04, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, 0x3a, 0x43, 0x43,
+    0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46, 0x07, 0x24, 0x30,
+    0x30, 0x30, 0x30, 0x32, 0x61, 0x33, 0x37, 0x2d, 0x30, 0x30, 0x30, 0x30,
+    0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30,
+    0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x08,
+    0xfe, 0x00, 0x02,
+};
+
+const Bytes kValueChangedBatch = {
+    0x0c, 0x03, 0x07, 0x11, 0x41, 0x41, 0x3a, 0x42, 0x42, 0x3a, 0x43, 0x43,
+    0x3a, 0x44, 0x44, 0x3a, 0x45, 0x45, 0x3a, 0x46, 0x46, 0x07, 0x24, 0x30,
+    0x30, 0x30, 0x30, 0x32, 0x61, 0x33, 0x37, 0x2d, 0x30, 0x30, 0x30, 0x30,
+    0x2d, 0x31, 0x30, 0x30, 0x30, 0x2d, 0x38, 0x30, 0x30, 0x30, 0x2d, 0x30,
+    0x30, 0x38, 0x30, 0x35, 0x66, 0x39, 0x62, 0x33, 0x34, 0x66, 0x62, 0x0c,
+    0x04, 0x04, 0x78, 0x20, 0x20, 0x18, 0x24, 0x0a, 0x06, 0x00, 0x08, 0x02,
+    0x01, 0x02, 0x04, 0x60, 0x24, 0x20, 0x18, 0x24, 0x0a, 0x06, 0x00, 0x08,
+    0x01, 0x03,
+};
+
+constexpr char kDeviceId[] = "AA:BB:CC:DD:EE:FF";
+constexpr char kCharacteristicId[] = "00002a37-0000-1000-8000-00805f9b34fb";
+
+// Keeps the last message sent on each channel.
+class CapturingMessenger : public flutter::BinaryMessenger {
+public:
+  void Send(const std::string &channel, const uint8_t *message,
+            const size_t message_size,
+            flutter::BinaryReply /* reply */) const override {
+    last_channel = channel;
+    last_message.assign(message, message + message_size);
+  }
+
+  void SetMessageHandler(const std::string & /* channel */,
+                         flutter::BinaryMessageHandler /* handler */) override {
+  }
+
+  mutable std::string last_channel;
+  mutable Bytes last_message;
+};
+
+UniversalBleScanResult FullScanResult() {
+  UniversalBleScanResult result(kDeviceId);
+  result.set_name("Sensor");
+  result.set_is_paired(false);
+  result.set_rssi(-60);
+  result.set_manufacturer_data_list(EncodableList{
+      CustomEncodableValue(UniversalManufacturerData(0x004C, {1, 2, 3})),
+      CustomEncodableValue(UniversalManufacturerData(0x0059, {0xAA})),
+  });
+  result.set_service_data(EncodableMap{
+      {EncodableValue("0000180f-0000-1000-8000-00805f9b34fb"),
+       EncodableValue(Bytes{0x64})},
+  });
+  result.set_services(
+      EncodableList{EncodableValue("0000180d-0000-1000-8000-00805f9b34fb")});
+  result.set_timestamp(1700000000000);
+  return result;
+}
+
+Bytes ValueChanged512() {
+  Bytes message = kValueChanged512Head;
+  for (int i = 0; i < 512; ++i) {
+    message.push_back(static_cast<uint8_t>(i % 256));
+  }
+  message.push_back(0x00);
+  return message;
+}
+
+// Sends through the generated pigeon channel, the reference encoder.
+template <typename Call> Bytes SendGenerated(Call &&call) {
+  CapturingMessenger messenger;
+  UniversalBleCallbackChannel channel(&messenger);
+  call(channel);
+  return messenger.last_message;
+}
+
+// Decodes `message` with the pigeon codec and writes it back directly.
+Bytes Rewrite(const Bytes &message) {
+  const auto decoded =
+      UniversalBleCallbackChannel::GetCodec().DecodeMessage(message.data(),
+                                                            message.size());
+  Bytes rewritten;
+  StandardMessageWriter writer(rewritten);
+  EXPECT_TRUE(writer.WriteValue(*decoded));
+  return rewritten;
+}
+
+void Ignore() {}
+void IgnoreError(const FlutterError &) {}
+
+} // namespace
+
+TEST(StandardMessageWriter, ScanResultMatchesGoldens) {
+  CapturingMessenger messenger;
+  UniversalBleCallbackChannels channels(&messenger);
+
+  channels.OnScanResult(FullScanResult());
+  EXPECT_EQ(messenger.last_message, kFullScanResult);
+  EXPECT_EQ(SendGenerated([](UniversalBleCallbackChannel &channel) {
+              channel.OnScanResult(FullScanResult(), Ignore, IgnoreError);
+            }),
+            kFullScanResult);
+
+  channels.OnScanResult(UniversalBleScanResult(kDeviceId));
+  EXPECT_EQ(messenger.last_message, kMinimalScanResult);
+  EXPECT_EQ(SendGenerated([](UniversalBleCallbackChannel &channel) {
+              channel.OnScanResult(UniversalBleScanResult(kDeviceId), Ignore,
+                                   IgnoreError);
+            }),
+            kMinimalScanResult);
+}
+
+TEST(StandardMessageWriter, ValueChangedMatchesGoldens) {
+  CapturingMessenger messenger;
+  UniversalBleCallbackChannels channels(&messenger);
+
+  Bytes value20;
+  for (uint8_t i = 0; i < 20; ++i) {
+    value20.push_back(i);
+  }
+  const int64_t timestamp = 1700000000123;
+  channels.OnValueChanged(kDeviceId, kCharacteristicId, value20, &timestamp);
+  EXPECT_EQ(messenger.last_message, kValueChanged20);
+
+  Bytes value512;
+  for (int i = 0; i < 512; ++i) {
+    value512.push_back(static_cast<uint8_t>(i % 256));
+  }
+  channels.OnValueChanged(kDeviceId, kCharacteristicId, value512, nullptr);
+  EXPECT_EQ(messenger.last_message, ValueChanged512());
+  EXPECT_EQ(SendGenerated([&value512](UniversalBleCallbackChannel &channel) {
+              channel.OnValueChanged(kDeviceId, kCharacteristicId, value512,
+                                     nullptr, Ignore, IgnoreError);
+            }),
+            ValueChanged512());
+}
+
+TEST(StandardMessageWriter, ValueChangedBatchMatchesGolden) {
+  CapturingMessenger messenger;
+  UniversalBleCallbackChannels channels(&messenger);
+  channels.OnValueChangedBatch(kDeviceId, kCharacteristicId,
+                               {{1700000000123000, {1, 2}},
+                                {1700000000124000, {3}}});
+  EXPECT_EQ(messenger.last_channel, kValueChangedBatchChannel);
+  EXPECT_EQ(messenger.last_message, kValueChangedBatch);
+}
+
+TEST(StandardMessageWriter, RewritesDecodedGoldensUnchanged) {
+  for (const Bytes &golden :
+       {kFullScanResult, kMinimalScanResult, kValueChanged20,
+        ValueChanged512()}) {
+    EXPECT_EQ(Rewrite(golden), golden);
+  }
+}
+
+} // namespace test
+} // namespace universal_ble
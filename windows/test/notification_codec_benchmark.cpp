@@ -0,0 +1,62 @@
+// Encodes drains of binary notification frames the way
+// UniversalBlePlugin::DeliverNotifications does, and reports the time per
+// frame. Run without arguments; not part of ctest.
+#include "universal_ble_notification_codec.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Entry {
+  int64_t timestamp;
+  std::vector<uint8_t> value;
+};
+
+size_t EncodeDrain(const std::vector<Entry> &entries) {
+  size_t frames_size = 0;
+  for (const auto &entry : entries) {
+    frames_size += universal_ble::kNotificationValueHeaderSize +
+                   entry.value.size();
+  }
+  std::vector<uint8_t> frames;
+  frames.reserve(frames_size);
+  for (const auto &entry : entries) {
+    universal_ble::AppendValueFrame(frames, 1, entry.timestamp, entry.value);
+  }
+  return frames.size();
+}
+
+void Run(const size_t drain_size, const size_t payload_size) {
+  std::vector<Entry> entries(drain_size);
+  for (size_t i = 0; i < drain_size; ++i) {
+    entries[i] = {static_cast<int64_t>(i),
+                  std::vector<uint8_t>(payload_size, static_cast<uint8_t>(i))};
+  }
+  constexpr size_t kFrames = 2'000'000;
+  const size_t drains = kFrames / drain_size;
+  size_t bytes = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < drains; ++i) {
+    bytes += EncodeDrain(entries);
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::printf("drain=%4zu payload=%4zu  %7.1f ns/frame  %7.1f MB/s\n",
+              drain_size, payload_size,
+              elapsed.count() / static_cast<double>(drains * drain_size),
+              static_cast<double>(bytes) / elapsed.count() * 1e3);
+}
+
+} // namespace
+
+int main() {
+  for (const size_t drain_size : {1, 32, 256}) {
+    for (const size_t payload_size : {20, 244, 512}) {
+      Run(drain_size, payload_size);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "universal_ble_notification_filter.h"
+
+namespace universal_ble {
+namespace test {
+
+namespace {
+
+NotificationFilterOptions Options(const NotificationFilterMode mode) {
+  NotificationFilterOptions options;
+  options.mode = mode;
+  return options;
+}
+
+NotificationEntry Entry(const int64_t timestamp, const uint8_t value) {
+  return {timestamp, {value}};
+}
+
+} // namespace
+
+TEST(NotificationFilter, AllCreatesNoFilter) {
+  EXPECT_EQ(CreateNotificationFilter(Options(NotificationFilterMode::kAll)),
+            nullptr);
+}
+
+TEST(NotificationFilter, OnChangeDropsRepeats) {
+  NotificationFilter filter(Options(NotificationFilterMode::kOnChange));
+  std::vector<bool> delivered;
+  for (const uint8_t value : {1, 1, 2, 2, 1}) {
+    auto entry = Entry(0, value);
+    delivered.push_back(filter.Offer(entry).deliver);
+  }
+  EXPECT_EQ(delivered, (std::vector<bool>{true, false, true, false, true}));
+  EXPECT_EQ(filter.filtered(), 2u);
+}
+
+TEST(NotificationFilter, EveryNth) {
+  auto options = Options(NotificationFilterMode::kEveryNth);
+  options.every_nth = 3;
+  NotificationFilter filter(options);
+  int delivered = 0;
+  for (int i = 0; i < 9; ++i) {
+    auto entry = Entry(i, 0);
+    delivered += filter.Offer(entry).deliver ? 1 : 0;
+  }
+  EXPECT_EQ(delivered, 3);
+  EXPECT_EQ(filter.filtered(), 6u);
+}
+
+TEST(NotificationFilter, RateLimitHoldsTheLatestValue) {
+  auto options = Options(NotificationFilterMode::kRateLimit);
+  options.max_rate_hz = 100; // 10 ms periods
+  NotificationFilter filter(options);
+
+  auto first = Entry(1'000, 1);
+  EXPECT_TRUE(filter.Offer(first).deliver);
+
+  // The first value within the period is held and asks for a release at
+  // the end of the period.
+  auto second = Entry(3'500, 2);
+  const auto held = filter.Offer(second);
+  EXPECT_FALSE(held.deliver);
+  EXPECT_TRUE(held.schedule_release);
+  EXPECT_EQ(held.release_in_micros, 7'500);
+
+  // A later one replaces it without another release.
+  auto third = Entry(6'000, 3);
+  const auto replaced = filter.Offer(third);
+  EXPECT_FALSE(replaced.deliver);
+  EXPECT_FALSE(replaced.schedule_release);
+
+  const auto released = filter.TakeHeld(11'000);
+  ASSERT_TRUE(released.has_value());
+  EXPECT_EQ(released->value, std::vector<uint8_t>{3});
+  EXPECT_FALSE(filter.TakeHeld(11'000).has_value());
+  EXPECT_EQ(filter.filtered(), 1u);
+
+  // The release starts the next period.
+  auto fourth = Entry(15'000, 4);
+  EXPECT_FALSE(filter.Offer(fourth).deliver);
+  auto fifth = Entry(21'000, 5);
+  EXPECT_TRUE(filter.Offer(fifth).deliver);
+  // fourth was superseded by fifth before its release.
+  EXPECT_FALSE(filter.TakeHeld(25'000).has_value());
+  EXPECT_EQ(filter.filtered(), 2u);
+}
+
+} // namespace test
+} // namespace universal_ble
@@ -0,0 +1,158 @@
+// Notifications per second per core on the native side of the notification
+// path, before and after the per-subscription NotificationContext. Before,
+// each notification formatted the device id and characteristic UUID,
+// copied the bytes and posted a closure holding copies of all three
+// through the std::mutex + std::list dispatcher. Now it copies the bytes
+// once into the subscription's ring buffer and posts one drain per burst
+// through the pooled queue. Producer and consumer share one thread, so the
+// rate is per core. The three cross-ABI WinRT calls the old path also made
+// (Service().Device().BluetoothAddress()) cannot run here and are left
+// out, as is the channel encoding both paths share; see
+// callback_channel_benchmark. Run without arguments; not part of ctest.
+#include "allocation_counter.h"
+#include "dispatch_benchmark_queues.h"
+#include "universal_ble_notification_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using universal_ble::NotificationBufferOptions;
+using universal_ble::NotificationEntry;
+using universal_ble::NotificationRingBuffer;
+using universal_ble::benchmark::AllocationCount;
+using universal_ble::benchmark::ListDispatcher;
+using universal_ble::benchmark::PooledDispatcher;
+
+constexpr int kEvents = 1'000'000;
+// Notifications arriving before the platform thread runs, like a burst.
+constexpr int kBurst = 32;
+constexpr uint64_t kBluetoothAddress = 0xAABBCCDDEEFF;
+
+// The winrt::guid fields to_uuidstr formats.
+struct Guid {
+  uint32_t data1;
+  uint16_t data2;
+  uint16_t data3;
+  uint8_t data4[8];
+};
+
+constexpr Guid kCharacteristic = {
+    0x00002a37, 0x0000, 0x1000, {0x80, 0x00, 0x00, 0x80, 0x5f, 0x9b, 0x34, 0xfb}};
+
+// Same output as mac_address_to_str in helper/utils.cpp.
+std::string MacAddressToString(const uint64_t mac_address) {
+  char mac[18];
+  std::snprintf(mac, sizeof(mac), "%02x:%02x:%02x:%02x:%02x:%02x",
+                static_cast<unsigned>((mac_address >> 40) & 0xff),
+                static_cast<unsigned>((mac_address >> 32) & 0xff),
+                static_cast<unsigned>((mac_address >> 24) & 0xff),
+                static_cast<unsigned>((mac_address >> 16) & 0xff),
+                static_cast<unsigned>((mac_address >> 8) & 0xff),
+                static_cast<unsigned>(mac_address & 0xff));
+  return mac;
+}
+
+// Same output as to_uuidstr in helper/utils.cpp.
+std::string GuidToString(const Guid &guid) {
+  char uuid[37];
+  std::snprintf(uuid, sizeof(uuid),
+                "%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx"
+                "%02hhx",
+                guid.data1, guid.data2, guid.data3, guid.data4[0],
+                guid.data4[1], guid.data4[2], guid.data4[3], guid.data4[4],
+                guid.data4[5], guid.data4[6], guid.data4[7]);
+  return uuid;
+}
+
+// The parts of NotificationContext the fast path touches.
+struct Context {
+  std::string device_id = MacAddressToString(kBluetoothAddress);
+  std::string characteristic_uuid = GuidToString(kCharacteristic);
+  std::shared_ptr<NotificationRingBuffer> buffer =
+      std::make_shared<NotificationRingBuffer>(NotificationBufferOptions{});
+};
+
+std::atomic<int64_t> g_sink{0};
+
+struct Result {
+  double events_per_second;
+  double allocations;
+};
+
+// `notify(i)` handles one notification; `drain()` runs what it posted.
+template <typename Notify, typename Drain>
+Result Run(Notify &&notify, Drain &&drain) {
+  for (int i = 0; i < kBurst; ++i) {
+    notify(i);
+  }
+  drain();
+  const uint64_t allocations = AllocationCount();
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kEvents; i += kBurst) {
+    for (int j = i; j < i + kBurst; ++j) {
+      notify(j);
+    }
+    drain();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return {kEvents / elapsed.count(),
+          static_cast<double>(AllocationCount() - allocations) / kEvents};
+}
+
+} // namespace
+
+int main() {
+  std::printf("%-12s %26s %26s\n", "payload", "before (per notification)",
+              "after (per subscription)");
+  for (const size_t size : {20, 244}) {
+    // The IBuffer the notification arrives in.
+    const std::vector<uint8_t> value(size, 0xab);
+
+    ListDispatcher list;
+    const Result before = Run(
+        [&](const int i) {
+          const auto uuid = GuidToString(kCharacteristic);
+          const auto bytes = std::vector<uint8_t>(value.begin(), value.end());
+          const auto device_id = MacAddressToString(kBluetoothAddress);
+          const int64_t timestamp = i;
+          list.Post([device_id, uuid, bytes, timestamp] {
+            g_sink += device_id.size() + uuid.size() + bytes.size() +
+                      timestamp;
+          });
+        },
+        [&] { list.Drain(); });
+
+    PooledDispatcher pooled;
+    const auto context = std::make_shared<const Context>();
+    const Result after = Run(
+        [&](const int i) {
+          context->buffer->Push(
+              {i, std::vector<uint8_t>(value.begin(), value.end())});
+          if (context->buffer->ClaimDrain()) {
+            pooled.Post([context] {
+              for (const auto &entry : context->buffer->Drain()) {
+                g_sink += context->device_id.size() +
+                          context->characteristic_uuid.size() +
+                          entry.value.size() + entry.timestamp;
+              }
+            });
+          }
+        },
+        [&] { pooled.Drain(); });
+
+    std::printf("%4zu B       %9.2f M/s %5.2f allocs %9.2f M/s %5.2f allocs\n",
+                size, before.events_per_second / 1e6, before.allocations,
+                after.events_per_second / 1e6, after.allocations);
+  }
+  std::printf("(notifications per second on one core, heap allocations per "
+              "notification)\n");
+  return 0;
+}
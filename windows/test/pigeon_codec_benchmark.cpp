@@ -0,0 +1,180 @@
+// Encode and decode cost of the pigeon codec (PigeonInternalCodecSerializer
+// over the Flutter StandardCodecSerializer) for the plugin's heavy
+// messages, in bytes/s and heap allocations per message. Encoding starts
+// from the native values, boxed the way the generated code boxes them, so
+// it includes building the EncodableValue tree. The bytes are checked
+// against the conformance goldens by universal_ble_plugin_test. Not part of
+// ctest; pass --benchmark_filter to pick a case.
+#include <benchmark/benchmark.h>
+
+#include <flutter/encodable_value.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "generated/universal_ble.g.h"
+
+namespace {
+
+using flutter::CustomEncodableValue;
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+using universal_ble::CharacteristicProperty;
+using universal_ble::UniversalBleCallbackChannel;
+using universal_ble::UniversalBleCharacteristic;
+using universal_ble::UniversalBleDescriptor;
+using universal_ble::UniversalBleScanResult;
+using universal_ble::UniversalBleService;
+using universal_ble::UniversalManufacturerData;
+using universal_ble::benchmark::AllocationCount;
+
+constexpr char kDeviceId[] = "AA:BB:CC:DD:EE:FF";
+
+std::string Uuid(const int short_uuid) {
+  char uuid[37];
+  std::snprintf(uuid, sizeof(uuid), "%08x-0000-1000-8000-00805f9b34fb",
+                short_uuid);
+  return uuid;
+}
+
+UniversalBleScanResult ScanResult(const int manufacturer_entries) {
+  UniversalBleScanResult result(kDeviceId);
+  if (manufacturer_entries == 0) {
+    return result;
+  }
+  result.set_name("Sensor 7F2A19");
+  result.set_is_paired(false);
+  result.set_rssi(-60);
+  EncodableList manufacturer_data;
+  for (int i = 0; i < manufacturer_entries; ++i) {
+    manufacturer_data.emplace_back(CustomEncodableValue(
+        UniversalManufacturerData(0x004C + i, std::vector<uint8_t>(24, 0x5a))));
+  }
+  result.set_manufacturer_data_list(manufacturer_data);
+  result.set_service_data(EncodableMap{
+      {EncodableValue(Uuid(0x180f)), EncodableValue(std::vector<uint8_t>{100})},
+  });
+  result.set_services(EncodableList{EncodableValue(Uuid(0x180d)),
+                                    EncodableValue(Uuid(0x180a))});
+  result.set_timestamp(1700000000000);
+  return result;
+}
+
+// The discoverServices reply: `services` services of `characteristics`
+// characteristics with two descriptors each.
+EncodableValue ServiceList(const int services, const int characteristics) {
+  EncodableList list;
+  for (int s = 0; s < services; ++s) {
+    EncodableList service_characteristics;
+    for (int c = 0; c < characteristics; ++c) {
+      service_characteristics.emplace_back(
+          CustomEncodableValue(UniversalBleCharacteristic(
+              Uuid(0x2a00 + s * 16 + c),
+              EncodableList{
+                  CustomEncodableValue(CharacteristicProperty::kRead),
+                  CustomEncodableValue(CharacteristicProperty::kNotify),
+              },
+              EncodableList{
+                  CustomEncodableValue(UniversalBleDescriptor(Uuid(0x2902))),
+                  CustomEncodableValue(UniversalBleDescriptor(Uuid(0x2901))),
+              })));
+    }
+    UniversalBleService service(Uuid(0x1800 + s));
+    service.set_characteristics(service_characteristics);
+    list.emplace_back(CustomEncodableValue(service));
+  }
+  return EncodableValue(EncodableList{EncodableValue(std::move(list))});
+}
+
+// The onValueChanged arguments.
+EncodableValue ValueChanged(const size_t size) {
+  return EncodableValue(EncodableList{
+      EncodableValue(kDeviceId),
+      EncodableValue(Uuid(0x2a37)),
+      EncodableValue(std::vector<uint8_t>(size, 0xab)),
+      EncodableValue(int64_t{1700000000123}),
+  });
+}
+
+void ReportCounters(benchmark::State &state, const size_t message_size,
+                    const uint64_t allocations) {
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(message_size));
+  state.counters["bytes"] = static_cast<double>(message_size);
+  state.counters["allocs/op"] =
+      static_cast<double>(allocations) / static_cast<double>(state.iterations());
+}
+
+template <typename MakeMessage>
+void Encode(benchmark::State &state, MakeMessage make_message) {
+  const auto &codec = UniversalBleCallbackChannel::GetCodec();
+  const size_t size = codec.EncodeMessage(make_message())->size();
+  const uint64_t before = AllocationCount();
+  for (auto _ : state) {
+    auto message = codec.EncodeMessage(make_message());
+    benchmark::DoNotOptimize(message->data());
+  }
+  ReportCounters(state, size, AllocationCount() - before);
+}
+
+void Decode(benchmark::State &state, const EncodableValue &value) {
+  const auto &codec = UniversalBleCallbackChannel::GetCodec();
+  const auto message = codec.EncodeMessage(value);
+  const uint64_t before = AllocationCount();
+  for (auto _ : state) {
+    auto decoded = codec.DecodeMessage(message->data(), message->size());
+    benchmark::DoNotOptimize(decoded.get());
+  }
+  ReportCounters(state, message->size(), AllocationCount() - before);
+}
+
+// state.range(0) manufacturer entries; 0 is a result with only its id.
+void BM_EncodeScanResult(benchmark::State &state) {
+  const UniversalBleScanResult result =
+      ScanResult(static_cast<int>(state.range(0)));
+  Encode(state, [&result] {
+    return EncodableValue(EncodableList{CustomEncodableValue(result)});
+  });
+}
+
+void BM_DecodeScanResult(benchmark::State &state) {
+  Decode(state, EncodableValue(EncodableList{CustomEncodableValue(
+                    ScanResult(static_cast<int>(state.range(0))))}));
+}
+
+// state.range(0) services of state.range(1) characteristics.
+void BM_EncodeServiceList(benchmark::State &state) {
+  const int services = static_cast<int>(state.range(0));
+  const int characteristics = static_cast<int>(state.range(1));
+  Encode(state, [&] { return ServiceList(services, characteristics); });
+}
+
+void BM_DecodeServiceList(benchmark::State &state) {
+  Decode(state, ServiceList(static_cast<int>(state.range(0)),
+                            static_cast<int>(state.range(1))));
+}
+
+// state.range(0) payload bytes.
+void BM_EncodeValueChanged(benchmark::State &state) {
+  const auto size = static_cast<size_t>(state.range(0));
+  Encode(state, [size] { return ValueChanged(size); });
+}
+
+void BM_DecodeValueChanged(benchmark::State &state) {
+  Decode(state, ValueChanged(static_cast<size_t>(state.range(0))));
+}
+
+BENCHMARK(BM_EncodeScanResult)->Arg(0)->Arg(1)->Arg(4);
+BENCHMARK(BM_DecodeScanResult)->Arg(0)->Arg(1)->Arg(4);
+BENCHMARK(BM_EncodeServiceList)->Args({1, 4})->Args({6, 8});
+BENCHMARK(BM_DecodeServiceList)->Args({1, 4})->Args({6, 8});
+BENCHMARK(BM_EncodeValueChanged)->Arg(20)->Arg(64)->Arg(244)->Arg(512);
+BENCHMARK(BM_DecodeValueChanged)->Arg(20)->Arg(64)->Arg(244)->Arg(512);
+
+} // namespace
+
+BENCHMARK_MAIN();
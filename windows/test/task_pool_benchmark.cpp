@@ -0,0 +1,76 @@
+// Allocation cost of UniversalBleTask captures that do not fit inline, with
+// producers on several threads and a single consumer, as in
+// UniversalBleUiThreadHandler. Compares TaskBlockPool blocks with captures
+// too large for the pool, which always use the heap. Run without arguments;
+// not part of ctest.
+#include "helper/universal_ble_mpsc_queue.h"
+#include "helper/universal_ble_task.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using universal_ble::MpscQueue;
+using universal_ble::UniversalBleTask;
+
+struct Node {
+  std::atomic<Node *> next{nullptr};
+  UniversalBleTask task;
+};
+
+constexpr int kTasksPerProducer = 200000;
+
+template <size_t CaptureSize> double Run(const int producers) {
+  MpscQueue<Node> queue;
+  std::atomic<int> ready{0};
+  std::atomic<bool> start{false};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&] {
+      ready.fetch_add(1);
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      for (int i = 0; i < kTasksPerProducer; ++i) {
+        Node *node = new Node;
+        node->task = [payload = std::array<char, CaptureSize>{}] {
+          (void)payload;
+        };
+        queue.Push(node);
+      }
+    });
+  }
+  while (ready.load() < producers) {
+  }
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  const int total = producers * kTasksPerProducer;
+  for (int done = 0; done < total;) {
+    if (Node *node = queue.Pop()) {
+      node->task();
+      delete node;
+      ++done;
+    }
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return elapsed.count() / total;
+}
+
+} // namespace
+
+int main() {
+  for (const int producers : {1, 2, 4, 8}) {
+    std::printf("producers=%d  pooled(256B) %6.1f ns/task  heap(1KB) %6.1f "
+                "ns/task\n",
+                producers, Run<256>(producers), Run<1024>(producers));
+  }
+  return 0;
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "helper/universal_ble_task.h"
+
+namespace universal_ble {
+namespace test {
+
+namespace {
+
+// Counts live copies, so tests can check that every capture is destroyed
+// exactly once.
+struct Tracked {
+  explicit Tracked(int *live) : live(live) { ++*live; }
+  Tracked(Tracked &&other) noexcept : live(other.live) { ++*live; }
+  Tracked(const Tracked &other) : live(other.live) { ++*live; }
+  ~Tracked() { --*live; }
+  int *live;
+};
+
+template <size_t Size> UniversalBleTask MakeTask(int *live, int *calls) {
+  return [tracked = Tracked(live), calls, padding = std::array<char, Size>{}] {
+    (void)padding;
+    ++*calls;
+  };
+}
+
+} // namespace
+
+TEST(UniversalBleTask, RunsAndDestroysEveryStorageKind) {
+  // Inline, pooled and heap captures.
+  for (int kind = 0; kind < 3; ++kind) {
+    int live = 0;
+    int calls = 0;
+    {
+      UniversalBleTask task = kind == 0   ? MakeTask<8>(&live, &calls)
+                              : kind == 1 ? MakeTask<256>(&live, &calls)
+                                          : MakeTask<2048>(&live, &calls);
+      EXPECT_EQ(live, 1) << kind;
+      task();
+      task();
+    }
+    EXPECT_EQ(calls, 2) << kind;
+    EXPECT_EQ(live, 0) << kind;
+  }
+}
+
+TEST(UniversalBleTask, MovesWithoutCopying) {
+  int live = 0;
+  int calls = 0;
+  UniversalBleTask first = MakeTask<256>(&live, &calls);
+  UniversalBleTask second(std::move(first));
+  EXPECT_FALSE(first);
+  EXPECT_TRUE(second);
+  UniversalBleTask third;
+  third = std::move(second);
+  EXPECT_EQ(live, 1);
+  third();
+  EXPECT_EQ(calls, 1);
+  third = MakeTask<8>(&live, &calls);
+  EXPECT_EQ(live, 1);
+}
+
+TEST(UniversalBleTask, MoveOnlyCaptures) {
+  auto value = std::make_unique<int>(7);
+  int seen = 0;
+  UniversalBleTask task = [value = std::move(value), &seen] { seen = *value; };
+  task();
+  EXPECT_EQ(seen, 7);
+}
+
+TEST(TaskBlockPool, ReusesReleasedBlocks) {
+  void *block = TaskBlockPool::Allocate();
+  TaskBlockPool::Release(block);
+  EXPECT_EQ(TaskBlockPool::Allocate(), block);
+  TaskBlockPool::Release(block);
+}
+
+TEST(TaskBlockPool, FallsBackToTheHeapWhenExhausted) {
+  std::vector<void *> blocks;
+  for (size_t i = 0; i < TaskBlockPool::kBlockCount + 8; ++i) {
+    blocks.push_back(TaskBlockPool::Allocate());
+  }
+  EXPECT_EQ(std::set<void *>(blocks.begin(), blocks.end()).size(),
+            blocks.size());
+  for (void *block : blocks) {
+    TaskBlockPool::Release(block);
+  }
+}
+
+TEST(TaskBlockPool, ConcurrentAllocateAndReleaseNeverShareABlock) {
+  constexpr int kThreads = 8;
+  constexpr int kRounds = 20000;
+  std::atomic<bool> shared{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&shared, t] {
+      for (int round = 0; round < kRounds; ++round) {
+        void *blocks[4];
+        for (void *&block : blocks) {
+          block = TaskBlockPool::Allocate();
+          *static_cast<int *>(block) = t;
+        }
+        for (void *block : blocks) {
+          if (*static_cast<int *>(block) != t) {
+            shared.store(true);
+          }
+          TaskBlockPool::Release(block);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(shared.load());
+}
+
+TEST(ObjectPool, RecyclesObjectsAndFallsBackToTheHeap) {
+  ObjectPool<std::array<int64_t, 3>, 2> pool;
+  auto *first = pool.New(std::array<int64_t, 3>{1, 2, 3});
+  EXPECT_EQ((*first)[2], 3);
+  pool.Delete(first);
+  auto *second = pool.New();
+  EXPECT_EQ(second, first);
+  auto *third = pool.New();
+  auto *overflow = pool.New();
+  EXPECT_NE(third, second);
+  EXPECT_NE(overflow, second);
+  EXPECT_NE(overflow, third);
+  pool.Delete(overflow);
+  pool.Delete(third);
+  pool.Delete(second);
+}
+
+TEST(ObjectPool, DestroysWhatItHandsBack) {
+  int live = 0;
+  ObjectPool<Tracked, 4> pool;
+  Tracked *tracked = pool.New(&live);
+  EXPECT_EQ(live, 1);
+  pool.Delete(tracked);
+  EXPECT_EQ(live, 0);
+}
+
+} // namespace test
+} // namespace universal_ble